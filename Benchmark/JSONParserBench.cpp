@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <iostream>
+#include <format>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <cmath>
+
+#include "JSONParser.h"
+#include "ThreadPool.h"
+#include "JSONSerializer.h"
+#include "JSONPointer.h"
+#include "JSONBinding.h"
+#include "JSONSchema.h"
+#include "JSONColumns.h"
+#include "JSONView.h"
+#include "BinaryCodec.h"
+#include "JSONSnapshot.h"
+
+//
+// usage: JSONParserBench [maxThreads]
+// prints throughput of JSONParser::parseMany from 1 to maxThreads threads
+// (hardware concurrency by default) for small and large documents,
+// and of JSONSerializer (objects and numeric matrices) against nlohmann::json::dump on the same data,
+// of a single pointerLookup against a full parse of a large payload,
+// of parsing with a field allow-list against a full parse,
+// of typed binding into a struct against building JSONObject,
+// of schema validation on the token tape (sequential and parallel) against building JSONObject,
+// of a columnar scan of one field of NDJSON against parsing every record,
+// of MessagePack and CBOR encoding/decoding against the text round trip of the same object,
+// and of opening a mapped snapshot and reading one field against parsing the text again;
+//
+
+namespace
+{
+	std::string makeSmallDocument(uint32_t pIndex)
+	{
+		return "{id: " + std::to_string(pIndex) + "\n name: user" + std::to_string(pIndex % 97) +
+			   "\n active: true\n tags: [1, 2, 3]}";
+	}
+
+	std::string makeLargeDocument(uint32_t pIndex, uint32_t pFields)
+	{
+		std::string document = "{";
+		for (uint32_t i = 0; i < pFields; ++i)
+		{
+			document += "field" + std::to_string(i) + ": " + std::to_string(pIndex * pFields + i);
+			document += i + 1 == pFields ? "}" : "\n ";
+		}
+		return document;
+	}
+
+	double measureSeconds(const std::function<void()>& pFunction)
+	{
+		auto start = std::chrono::steady_clock::now();
+		pFunction();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void benchParseMany(std::string_view pName, const std::vector<std::string>& pDocuments, uint32_t pMaxThreads)
+	{
+		std::vector<std::string_view> views(pDocuments.begin(), pDocuments.end());
+		size_t bytes{};
+		for (auto& document : pDocuments)
+			bytes += document.size();
+
+		tng::JSONParser parser;
+		double baseline{};
+		std::vector<uint32_t> threadCounts;
+		for (uint32_t threads = 1; threads < pMaxThreads; threads *= 2)
+			threadCounts.push_back(threads);
+		threadCounts.push_back(pMaxThreads);
+
+		for (uint32_t threads : threadCounts)
+		{
+			tng::ThreadPool pool(threads);
+			parser.parseMany(views, pool); // warms thread-local parse contexts
+			size_t failed{};
+			double seconds = measureSeconds([&]()
+				{
+					for (auto& result : parser.parseMany(views, pool))
+						failed += result.has_value() ? 0 : 1;
+				});
+			if (threads == 1)
+				baseline = seconds;
+			std::cout << std::format("{:<6} threads: {:>3}  docs/s: {:>12.0f}  MB/s: {:>8.1f}  speedup: {:>5.2f}  failed: {}\n",
+									 pName, threads, pDocuments.size() / seconds, bytes / seconds / (1024.0 * 1024.0),
+									 baseline / seconds, failed);
+		}
+	}
+
+	tng::JSONObject makeSerializedObject(uint32_t pFields)
+	{
+		tng::JSONObject object;
+		for (uint32_t i = 0; i < pFields; ++i)
+		{
+			std::string key = "field" + std::to_string(i);
+			switch (i % 4)
+			{
+			case 0:
+				object.addObject(key, tng::JSONValue(static_cast<int32_t>(i) * -7919));
+				break;
+			case 1:
+				object.addObject(key, tng::JSONValue(static_cast<float>(i) / 7.0f));
+				break;
+			case 2:
+				object.addObject(key, tng::JSONValue("some text of user " + std::to_string(i) + " with a \"quote\""));
+				break;
+			default:
+				object.addObject(key, tng::JSONValue({ tng::JSONValue(i), tng::JSONValue(true), tng::JSONValue(std::string("x")) }));
+				break;
+			}
+		}
+		return object;
+	}
+
+	void benchSerialize(uint32_t pFields, uint32_t pIterations)
+	{
+		tng::JSONObject object = makeSerializedObject(pFields);
+		nlohmann::json json = nlohmann::json::parse(tng::JSONSerializer::toString(object));
+		size_t bytes = tng::JSONSerializer::measure(object);
+
+		auto report = [&](std::string_view pName, double pSeconds)
+			{
+				std::cout << std::format("serialize {:<16} MB/s: {:>8.1f}\n", pName,
+										 bytes * static_cast<double>(pIterations) / pSeconds / (1024.0 * 1024.0));
+			};
+
+		std::string output;
+		size_t checksum{};
+		report("tng compact", measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+				{
+					output.clear();
+					tng::JSONSerializer::serialize(object, output);
+					checksum += output.size();
+				}
+			}));
+		report("nlohmann compact", measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					checksum += json.dump().size();
+			}));
+		report("tng pretty", measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+				{
+					output.clear();
+					tng::JSONSerializer::serialize(object, output, { .mPretty = true });
+					checksum += output.size();
+				}
+			}));
+		report("nlohmann pretty", measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					checksum += json.dump(4).size();
+			}));
+		std::cout << std::format("serialize checksum: {}\n", checksum);
+	}
+
+	void benchMatrix(size_t pRows, size_t pColumns)
+	{
+		std::vector<double> matrix(pRows * pColumns);
+		for (size_t i = 0; i < matrix.size(); ++i)
+			matrix[i] = i % 10 == 0 ? static_cast<double>(i) : std::sin(static_cast<double>(i)) * 1000.0;
+
+		nlohmann::json json = nlohmann::json::array();
+		for (size_t row = 0; row < pRows; ++row)
+			json.push_back(std::vector<double>(matrix.begin() + row * pColumns, matrix.begin() + (row + 1) * pColumns));
+
+		std::string output;
+		double tngSeconds = measureSeconds([&]()
+			{
+				tng::JSONSerializer::serializeMatrix(matrix, pColumns, output);
+			});
+		std::string dumped;
+		double nlohmannSeconds = measureSeconds([&]()
+			{
+				dumped = json.dump();
+			});
+		std::cout << std::format("matrix {}x{}  tng MB/s: {:>8.1f}  nlohmann MB/s: {:>8.1f}\n", pRows, pColumns,
+								 output.size() / tngSeconds / (1024.0 * 1024.0),
+								 dumped.size() / nlohmannSeconds / (1024.0 * 1024.0));
+	}
+
+	void benchPointerLookup(uint32_t pItems, uint32_t pIterations)
+	{
+		std::string payload = R"({"items": [)";
+		for (uint32_t i = 0; i < pItems; ++i)
+		{
+			payload += std::format(R"({{"id": {}, "name": "item{}", "tags": ["a", "b"], "size": {{"w": {}, "h": {}}}}})", i, i, i % 640, i % 480);
+			payload += i + 1 == pItems ? "]" : ", ";
+		}
+		payload += R"(, "meta": {"routing": [{"queue": "orders"}]}})";
+
+		size_t found{};
+		double lookupSeconds = measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					found += tng::pointerLookup(payload, "/meta/routing/0/queue").value_or("").size();
+			});
+		// a full parse of the payload is slow enough to be measured once;
+		double parseSeconds = measureSeconds([&]()
+			{
+				found += tng::parse(payload).has_value() ? 1 : 0;
+			});
+		std::cout << std::format("pointer lookup in {:.1f} MB  lookup ms: {:>8.2f}  full parse ms: {:>8.2f}  found: {}\n",
+								 payload.size() / (1024.0 * 1024.0), lookupSeconds * 1000.0 / pIterations,
+								 parseSeconds * 1000.0, found);
+	}
+
+	void benchAllowList(uint32_t pDocuments, uint32_t pFields)
+	{
+		std::vector<std::string> documents;
+		for (uint32_t i = 0; i < pDocuments; ++i)
+			documents.push_back(makeLargeDocument(i, pFields));
+
+		tng::ParseOptions options;
+		for (uint32_t i = 0; i < pFields; i += std::max<uint32_t>(1, pFields / 6))
+			options.mFields.push_back("field" + std::to_string(i));
+
+		size_t parsed{};
+		double fullSeconds = measureSeconds([&]()
+			{
+				for (auto& document : documents)
+					parsed += tng::parse(document).has_value() ? 1 : 0;
+			});
+		double allowSeconds = measureSeconds([&]()
+			{
+				for (auto& document : documents)
+					parsed += tng::parse(document, options).has_value() ? 1 : 0;
+			});
+		std::cout << std::format("allow-list {} of {} fields  full docs/s: {:>10.0f}  allow-list docs/s: {:>10.0f}  parsed: {}\n",
+								 options.mFields.size(), pFields, pDocuments / fullSeconds, pDocuments / allowSeconds, parsed);
+	}
+
+	struct SmallDocument
+	{
+		uint32_t mId{};
+		std::string mName;
+		bool mActive{};
+		std::vector<int32_t> mTags;
+	};
+}
+
+TNG_JSON_BINDING(SmallDocument, tng::field("id", &SmallDocument::mId), tng::field("name", &SmallDocument::mName),
+				 tng::field("active", &SmallDocument::mActive), tng::field("tags", &SmallDocument::mTags))
+
+namespace
+{
+	void benchBinding(const std::vector<std::string>& pDocuments)
+	{
+		size_t checksum{};
+		double domSeconds = measureSeconds([&]()
+			{
+				for (auto& document : pDocuments)
+					checksum += tng::parse(document).has_value() ? 1 : 0;
+			});
+		SmallDocument bound;
+		double bindSeconds = measureSeconds([&]()
+			{
+				for (auto& document : pDocuments)
+					checksum += tng::bind(document, bound).has_value() ? bound.mTags.size() : 0;
+			});
+		std::cout << std::format("typed binding  JSONObject docs/s: {:>12.0f}  bind docs/s: {:>12.0f}  checksum: {}\n",
+								 pDocuments.size() / domSeconds, pDocuments.size() / bindSeconds, checksum);
+	}
+}
+
+namespace
+{
+	void benchSchema(uint32_t pItems, uint32_t pIterations)
+	{
+		std::string payload = "{id: 1\n items: [";
+		for (uint32_t i = 0; i < pItems; ++i)
+			payload += (i == 0 ? "{sku: item" : ", {sku: item") + std::to_string(i) + ", price: " + std::to_string(i % 1000) +
+					   ".5, count: " + std::to_string(i % 7) + ", state: new}";
+		payload += "]}";
+
+		tng::JSONResult<tng::JSONSchema> schema = tng::JSONSchema::compile(R"({"type": "object", "required": ["id", "items"],
+			"properties": {"id": {"type": "integer"}, "items": {"type": "array", "items": {"type": "object",
+			"required": ["sku", "price"], "properties": {"sku": {"type": "string", "maxLength": 16},
+			"price": {"type": "number", "minimum": 0}, "count": {"type": "integer", "maximum": 100},
+			"state": {"enum": ["new", "done"]}}}}}})");
+
+		tng::ThreadPool sequential(1);
+		size_t valid{};
+		double parseSeconds = measureSeconds([&]()
+			{
+				valid += tng::JSONTape::create(payload).value().toObject().has_value() ? 1 : 0;
+			});
+		double sequentialSeconds = measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					valid += schema->validate(payload, sequential).has_value() ? 1 : 0;
+			});
+		double parallelSeconds = measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					valid += schema->validate(payload).has_value() ? 1 : 0;
+			});
+		std::cout << std::format("schema {:.1f} MB  build JSONObject ms: {:>8.2f}  validate ms: {:>8.2f}  parallel validate ms: {:>8.2f}  valid: {}\n",
+								 payload.size() / (1024.0 * 1024.0), parseSeconds * 1000.0,
+								 sequentialSeconds * 1000.0 / pIterations, parallelSeconds * 1000.0 / pIterations, valid);
+	}
+}
+
+namespace
+{
+	void benchColumns(const std::vector<std::string>& pDocuments)
+	{
+		// members of the documents are separated by newlines, on a line of NDJSON - by commas;
+		std::string ndjson;
+		for (auto& document : pDocuments)
+		{
+			for (char c : document)
+				ndjson += c == '\n' ? ',' : c;
+			ndjson += '\n';
+		}
+
+		int64_t parsedSum{};
+		double parseSeconds = measureSeconds([&]()
+			{
+				for (auto& document : pDocuments)
+				{
+					tng::JSONResult<tng::JSONObject> object = tng::parse(document);
+					if (object)
+						parsedSum += tng::JSONObjectView(*object)["id"].getInt().value_or(0);
+				}
+			});
+
+		int64_t columnSum{};
+		double columnSeconds = measureSeconds([&]()
+			{
+				tng::JSONResult<tng::ColumnarExtractor> extractor = tng::ColumnarExtractor::create({ { "id", tng::ColumnType::INT64 } });
+				if (!extractor->addNDJSON(ndjson))
+					return;
+				for (int64_t id : extractor->getColumn("id")->getInts())
+					columnSum += id;
+			});
+		std::cout << std::format("columnar scan  JSONObject records/s: {:>12.0f}  columns records/s: {:>12.0f}  sums equal: {}\n",
+								 pDocuments.size() / parseSeconds, pDocuments.size() / columnSeconds, parsedSum == columnSum);
+	}
+}
+
+namespace
+{
+	void benchBinary(uint32_t pFields, uint32_t pIterations)
+	{
+		tng::JSONObject object = makeSerializedObject(pFields);
+		size_t checksum{};
+
+		auto report = [&](std::string_view pName, std::string_view pPayload, double pEncodeSeconds, double pDecodeSeconds)
+			{
+				std::cout << std::format("binary {:<12} bytes: {:>9}  encode ms: {:>8.2f}  decode ms: {:>8.2f}\n", pName, pPayload.size(),
+										 pEncodeSeconds * 1000.0 / pIterations, pDecodeSeconds * 1000.0 / pIterations);
+			};
+
+		std::string text;
+		double encodeSeconds = measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+				{
+					text.clear();
+					tng::JSONSerializer::serialize(object, text);
+				}
+			});
+		double decodeSeconds = measureSeconds([&]()
+			{
+				for (uint32_t i = 0; i < pIterations; ++i)
+					checksum += tng::JSONTape::create(text).value().toObject()->getSize();
+			});
+		report("text", text, encodeSeconds, decodeSeconds);
+
+		for (auto [name, format] : { std::pair{ "MessagePack", tng::BinaryFormat::MESSAGE_PACK }, std::pair{ "CBOR", tng::BinaryFormat::CBOR } })
+		{
+			std::string payload;
+			encodeSeconds = measureSeconds([&]()
+				{
+					for (uint32_t i = 0; i < pIterations; ++i)
+					{
+						payload.clear();
+						tng::BinaryCodec::encode(object, payload, format);
+					}
+				});
+			decodeSeconds = measureSeconds([&]()
+				{
+					for (uint32_t i = 0; i < pIterations; ++i)
+						checksum += tng::BinaryCodec::decodeObject(payload, format)->getSize();
+				});
+			report(name, payload, encodeSeconds, decodeSeconds);
+		}
+		std::cout << std::format("binary checksum: {}\n", checksum);
+	}
+}
+
+namespace
+{
+	void benchSnapshot(uint32_t pItems)
+	{
+		std::string text = "{items: [";
+		for (uint32_t i = 0; i < pItems; ++i)
+			text += (i == 0 ? "{sku: \"item" : ", {sku: \"item") + std::to_string(i) + "\", price: " + std::to_string(i % 1000) +
+					".5, count: " + std::to_string(i % 7) + "}";
+		text += "]\n last: " + std::to_string(pItems) + "}";
+
+		tng::JSONParser parser;
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "tng_bench.snap";
+		double writeSeconds = measureSeconds([&]()
+			{
+				parser.writeSnapshot(path, text, { .mSync = false });
+			});
+
+		uint64_t parsedLast{};
+		double parseSeconds = measureSeconds([&]()
+			{
+				tng::JSONResult<tng::JSONObject> object = tng::JSONTape::create(text).value().toObject();
+				parsedLast = tng::JSONObjectView(*object)["last"].getUint().value_or(0);
+			});
+
+		uint64_t snapshotLast{};
+		double openSeconds = measureSeconds([&]()
+			{
+				tng::JSONSnapshot snapshot = parser.openSnapshot(path);
+				snapshotLast = snapshot["last"].getUint().value_or(0) + snapshot["items"][pItems / 2]["count"].getUint().value_or(0);
+			});
+		std::filesystem::remove(path);
+		std::cout << std::format("snapshot {:.1f} MB  write ms: {:>8.2f}  parse ms: {:>8.2f}  open and query ms: {:>8.3f}  checksum: {} {}\n",
+								 text.size() / (1024.0 * 1024.0), writeSeconds * 1000.0, parseSeconds * 1000.0,
+								 openSeconds * 1000.0, parsedLast, snapshotLast);
+	}
+}
+
+int32_t main(int32_t argc, char* argv[])
+{
+	uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	if (argc > 1)
+		maxThreads = std::max(1, std::atoi(argv[1]));
+
+	std::vector<std::string> smallDocuments;
+	for (uint32_t i = 0; i < 200000; ++i)
+		smallDocuments.push_back(makeSmallDocument(i));
+
+	std::vector<std::string> largeDocuments;
+	for (uint32_t i = 0; i < 200; ++i)
+		largeDocuments.push_back(makeLargeDocument(i, 2000));
+
+	benchParseMany("small", smallDocuments, maxThreads);
+	benchParseMany("large", largeDocuments, maxThreads);
+	benchSerialize(20000, 50);
+	benchMatrix(2000, 1000);
+	benchPointerLookup(60000, 20);
+	benchAllowList(2000, 300);
+	benchBinding(smallDocuments);
+	benchSchema(100000, 20);
+	benchColumns(smallDocuments);
+	benchBinary(20000, 50);
+	benchSnapshot(500000);
+}
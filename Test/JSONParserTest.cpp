@@ -1,9 +1,30 @@
 #include <iostream>
 #include <format>
 #include <vector>
+#include <thread>
+#include <sstream>
 
 #include "gtest/gtest.h"
 #include "JSONParser.h"
+#include "JSONView.h"
+#include "ThreadPool.h"
+#include "NDJSONReader.h"
+#include "FileBuffer.h"
+#include "JSONSerializer.h"
+#include "BulkLoader.h"
+#include "DocumentCache.h"
+#include "DirectoryWatcher.h"
+#include "JSONTape.h"
+#include "IncrementalDocument.h"
+#include "JSONPointer.h"
+#include "LazyDocument.h"
+#include "JSONProjection.h"
+#include "JSONBinding.h"
+#include "StaticJSON.h"
+#include "JSONSchema.h"
+#include "JSONColumns.h"
+#include "BinaryCodec.h"
+#include "JSONSnapshot.h"
 
 TEST(LexerJsonTest, BasicValues)
 {
@@ -547,6 +568,1050 @@ TEST(LexerJsonTest, EdgeCases_TrickyStrings)
 	}
 }
 
+TEST(JSONViewTest, ChainedLookup)
+{
+	tng::JSONObject inner;
+	inner.addObject("port", tng::JSONValue(8080));
+	inner.addObject("hosts", tng::JSONValue({ tng::JSONValue(std::string("a")), tng::JSONValue(std::string("b")) }));
+	tng::JSONObject root;
+	root.addObject("server", tng::JSONValue(inner));
+	root.addObject("debug", tng::JSONValue(true));
+
+	tng::JSONObjectView view(root);
+	EXPECT_EQ(view["server"]["port"].getInt(), 8080);
+	EXPECT_EQ(view["server"]["hosts"][1].getString(), "b");
+	EXPECT_EQ(view["server"]["hosts"][0].getString(), "a");
+	EXPECT_FALSE(view["server"]["hosts"][-1].exists());
+	EXPECT_EQ(view["debug"].getBool(), true);
+
+	EXPECT_FALSE(view["missing"]["port"].exists());
+	EXPECT_FALSE(view["server"]["hosts"][5].exists());
+	EXPECT_FALSE(view["debug"].getInt().has_value());
+	EXPECT_EQ(view["server"]["timeout"].getOr<int32_t>(30), 30);
+
+	std::vector<std::string_view> hosts;
+	for (tng::JSONValueView host : view["server"]["hosts"])
+		hosts.push_back(host.getString().value_or(""));
+	EXPECT_EQ(hosts, (std::vector<std::string_view>{ "a", "b" }));
+
+	size_t keys = 0;
+	for (auto [key, value] : view)
+	{
+		EXPECT_TRUE(value.exists());
+		keys++;
+	}
+	EXPECT_EQ(keys, root.getSize());
+}
+
+TEST(JSONErrorTest, ExceptionFreePipeline)
+{
+	tng::JSONLexer lexer;
+	tng::JSONStatus status = lexer.tryTokenize("not an object");
+	ASSERT_FALSE(status.has_value());
+	EXPECT_EQ(status.error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+	EXPECT_TRUE(lexer.tryTokenize("{key: value}").has_value());
+
+	// the text is only viewed, the quotes and spaces the lexer adds are kept aside;
+	size_t tokenCount = lexer.getTokens().size();
+	const std::string buffer = "{key: value}";
+	EXPECT_TRUE(lexer.tryTokenize(buffer).has_value());
+	EXPECT_EQ(lexer.getTokens().size(), tokenCount);
+	EXPECT_EQ(buffer, "{key: value}");
+
+	tng::JSONParser parser;
+	tng::JSONResult<nlohmann::json> data = parser.tryParseToJSON("[1, 2]");
+	ASSERT_FALSE(data.has_value());
+	EXPECT_EQ(data.error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+	EXPECT_FALSE(parser.validate(""));
+
+	std::string longMessage(1000, 'x');
+	tng::JSONException exception(longMessage.c_str());
+	EXPECT_EQ(std::string_view(exception.what()).size() + 1, 128u);
+
+	tng::JSONException coded(tng::JSONError{ tng::JSONErrorCode::INVALID_CHARACTER, 42 });
+	EXPECT_EQ(coded.getErrorCode(), tng::JSONErrorCode::INVALID_CHARACTER);
+	EXPECT_NE(std::string_view(coded.what()).find("42"), std::string_view::npos);
+}
+
+TEST(JSONObjectTest, NestedArrays)
+{
+	tng::JSONParser parser;
+	nlohmann::json expected = nlohmann::json::parse(R"([1, [2, [3, [4]]], "x", null, true])");
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		nlohmann::json data = parser.parseToJSON("{a: 1\n b: [1, [2, [3, [4]]], x, null, true]\n c: hello}");
+		EXPECT_EQ(data["b"], expected);
+	}
+
+	tng::JSONResult<nlohmann::json> unbalanced = parser.tryParseToJSON("{b: [1, [2]\n c: hello}");
+	EXPECT_FALSE(unbalanced.has_value());
+
+	// separators and brackets inside quoted elements belong to the string;
+	tng::JSONResult<nlohmann::json> quoted = parser.tryParseToJSON(R"({a: ["a,b", c, "x]y", ["[", 2], []]})");
+	ASSERT_TRUE(quoted.has_value());
+	EXPECT_EQ((*quoted)["a"], nlohmann::json::parse(R"(["a,b", "c", "x]y", ["[", 2], []])"));
+	EXPECT_FALSE(parser.tryParseToJSON("{a: [1,,2]}").has_value());
+	EXPECT_FALSE(parser.tryParseToJSON("{a: [1, 2, ]}").has_value());
+}
+
+TEST(ParseTest, StatelessAcrossThreads)
+{
+	const std::string text = "{id: 7\n values: [1, [2, 3]]\n name: worker}";
+	tng::JSONResult<tng::JSONObject> reference = tng::parse(text);
+	ASSERT_TRUE(reference.has_value());
+	ASSERT_TRUE(reference->contains("values"));
+
+	const tng::JSONParser sharedParser;
+	const nlohmann::json expected = sharedParser.parseToJSON(text);
+	std::vector<std::thread> threads;
+	std::vector<uint32_t> mismatches(8, 0);
+	for (size_t t = 0; t < mismatches.size(); ++t)
+	{
+		threads.emplace_back([&, t]()
+			{
+				for (uint32_t i = 0; i < 200; ++i)
+				{
+					tng::JSONResult<nlohmann::json> data = sharedParser.tryParseToJSON(text);
+					if (!data || *data != expected)
+						mismatches[t]++;
+				}
+			});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	for (uint32_t mismatch : mismatches)
+		EXPECT_EQ(mismatch, 0u);
+
+	EXPECT_FALSE(tng::parse("no braces").has_value());
+	EXPECT_TRUE(tng::parse(text, tng::ParseOptions{ .mMaxRetainedBytes = 0 }).has_value());
+}
+
+TEST(ParseTest, ParseManyKeepsOrder)
+{
+	std::vector<std::string> documents;
+	for (uint32_t i = 0; i < 500; ++i)
+		documents.push_back(i % 50 == 0 ? std::string("broken") : "{id: " + std::to_string(i) + "\n name: doc}");
+	std::vector<std::string_view> views(documents.begin(), documents.end());
+
+	tng::ThreadPool pool(4);
+	tng::JSONParser parser;
+	std::vector<tng::JSONResult<nlohmann::json>> results = parser.parseMany(views, pool);
+	ASSERT_EQ(results.size(), documents.size());
+	for (uint32_t i = 0; i < results.size(); ++i)
+	{
+		if (i % 50 == 0)
+			EXPECT_FALSE(results[i].has_value());
+		else
+		{
+			ASSERT_TRUE(results[i].has_value());
+			EXPECT_EQ((*results[i])["id"], i);
+		}
+	}
+}
+
+TEST(NDJSONReaderTest, OrderedAndUnordered)
+{
+	std::string input;
+	for (uint32_t i = 1; i <= 3000; ++i)
+		input += i % 100 == 0 ? "broken\r\n" : (i % 7 == 0 ? "\n" : "{id: " + std::to_string(i) + "}\n");
+
+	tng::ThreadPool pool(3);
+	for (bool ordered : { true, false })
+	{
+		tng::NDJSONOptions options;
+		options.mChunkSize = 512;
+		options.mMaxChunksInFlight = 2;
+		options.mRecordsPerTask = 8;
+		options.mOrdered = ordered;
+		options.mPool = &pool;
+
+		std::istringstream stream(input);
+		std::vector<uint64_t> lines;
+		uint32_t errors{};
+		tng::NDJSONReader reader(options);
+		tng::JSONStatus status = reader.read(stream, [&](uint64_t pLine, tng::JSONResult<tng::JSONObject>&& pRecord)
+			{
+				lines.push_back(pLine);
+				if (!pRecord)
+					errors++;
+				else
+					EXPECT_TRUE(pRecord->contains("id"));
+			});
+		ASSERT_TRUE(status.has_value());
+		EXPECT_EQ(errors, 30u);
+		EXPECT_EQ(lines.size(), 3000u - 3000u / 7 + 4u);
+		if (ordered)
+		{
+			EXPECT_TRUE(std::is_sorted(lines.begin(), lines.end()));
+		}
+		std::sort(lines.begin(), lines.end());
+		EXPECT_EQ(std::adjacent_find(lines.begin(), lines.end()), lines.end());
+	}
+}
+
+TEST(FileBufferTest, MappedAndBufferedReads)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "tng_file_buffer_test.json";
+	std::string content = "{id: 1\n name: ";
+	content += std::string(100000, 'x') + "}";
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream << content;
+	}
+
+	tng::JSONResult<tng::FileBuffer> mapped = tng::FileBuffer::open(path);
+	ASSERT_TRUE(mapped.has_value());
+	EXPECT_TRUE(mapped->isMapped());
+	EXPECT_EQ(mapped->getView(), content);
+
+	tng::JSONResult<tng::FileBuffer> buffered = tng::FileBuffer::open(path, tng::FileReadOptions{ .mMinMappedSize = content.size() + 1 });
+	ASSERT_TRUE(buffered.has_value());
+	EXPECT_FALSE(buffered->isMapped());
+	EXPECT_EQ(buffered->getView(), content);
+
+	tng::FileBuffer moved = std::move(*buffered);
+	EXPECT_EQ(moved.getView(), content);
+
+	tng::JSONParser parser;
+	tng::JSONResult<nlohmann::json> data = parser.tryParseFile(path);
+	ASSERT_TRUE(data.has_value());
+	EXPECT_EQ((*data)["id"], 1);
+
+	EXPECT_FALSE(tng::FileBuffer::open(path.string() + ".missing").has_value());
+	std::filesystem::remove(path);
+
+#if defined(__linux__)
+	tng::JSONResult<tng::FileBuffer> procfs = tng::FileBuffer::open("/proc/self/status");
+	ASSERT_TRUE(procfs.has_value());
+	EXPECT_FALSE(procfs->isMapped());
+	EXPECT_FALSE(procfs->getView().empty());
+#endif
+}
+
+TEST(JSONSerializerTest, AtomicWriteFile)
+{
+	tng::JSONObject nested;
+	nested.addObject("flag", tng::JSONValue(false));
+	tng::JSONObject object;
+	object.addObject("id", tng::JSONValue(-42));
+	object.addObject("ratio", tng::JSONValue(0.5f));
+	object.addObject("text", tng::JSONValue(std::string("quote \" slash \\ line\n\x01")));
+	object.addObject("list", tng::JSONValue({ tng::JSONValue(1u), tng::JSONValue(std::string("a")) }));
+	object.addObject("nested", tng::JSONValue(std::move(nested)));
+
+	nlohmann::json parsed = nlohmann::json::parse(tng::JSONSerializer::toString(object));
+	EXPECT_EQ(parsed["id"], -42);
+	EXPECT_EQ(parsed["ratio"], 0.5);
+	EXPECT_EQ(parsed["text"], "quote \" slash \\ line\n\x01");
+	EXPECT_EQ(parsed["list"][size_t{ 1 }], "a");
+	EXPECT_EQ(parsed["nested"]["flag"], false);
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "tng_write_file_test.json";
+	tng::JSONParser parser;
+	ASSERT_TRUE(parser.tryWriteFile(path, object, tng::FileWriteOptions{ .mSync = false }).has_value());
+	parser.writeFile(path, object);
+	tng::JSONResult<tng::FileBuffer> file = tng::FileBuffer::open(path);
+	ASSERT_TRUE(file.has_value());
+	EXPECT_EQ(nlohmann::json::parse(file->getView()), parsed);
+
+	// the replaced file keeps its permissions;
+	std::filesystem::permissions(path, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+	parser.writeFile(path, object, tng::FileWriteOptions{ .mSync = false });
+#if !defined(_WIN32)
+	EXPECT_EQ(std::filesystem::status(path).permissions(), std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+#endif
+	std::filesystem::remove(path);
+
+	EXPECT_FALSE(parser.tryWriteFile(path / "missing" / "file.json", object).has_value());
+}
+
+TEST(JSONSerializerTest, PrettyAndCompact)
+{
+	std::string longText = std::string(40, 'a') + "\t" + std::string(70, 'b') + "\"\x1f";
+	tng::JSONObject nested;
+	nested.addObject("list", tng::JSONValue({ tng::JSONValue(1), tng::JSONValue(true), tng::JSONValue(std::vector<tng::JSONValue>{}) }));
+	tng::JSONObject object;
+	object.addObject("nested", tng::JSONValue(std::move(nested)));
+
+	nlohmann::json expected = { { "nested", { { "list", { 1, true, nlohmann::json::array() } } } } };
+	EXPECT_EQ(tng::JSONSerializer::toString(object, { .mPretty = true }), expected.dump(4));
+	EXPECT_EQ(tng::JSONSerializer::toString(object, { .mPretty = true, .mIndent = 2 }), expected.dump(2));
+	EXPECT_EQ(tng::JSONSerializer::toString(object), expected.dump());
+
+	std::string output = "prefix ";
+	tng::JSONValue text(longText);
+	tng::JSONSerializer::serialize(text, output);
+	EXPECT_EQ(output, "prefix " + nlohmann::json(longText).dump());
+	EXPECT_EQ(tng::JSONSerializer::measure(text), output.size() - 7);
+	EXPECT_EQ(tng::JSONSerializer::toString(tng::JSONObject()), "{}");
+}
+
+TEST(JSONSerializerTest, ShortestRoundTripNumbers)
+{
+	std::vector<double> doubles = { 0.1, -2.5e-300, 1.7976931348623157e308, 3.0, -0.0, 123456789012.0, 1e300 };
+	for (uint32_t i = 1; i < 1000; ++i)
+		doubles.push_back(1.0 / i);
+
+	std::string output;
+	tng::JSONSerializer::serializeArray(doubles, output);
+	nlohmann::json parsed = nlohmann::json::parse(output);
+	ASSERT_EQ(parsed.size(), doubles.size());
+	for (size_t i = 0; i < doubles.size(); ++i)
+		EXPECT_EQ(parsed[i].get<double>(), doubles[i]);
+	EXPECT_TRUE(output.starts_with("[0.1,-2.5e-300,1.7976931348623157e+308,3,-0,123456789012,1e+300,1,0.5,"));
+
+	std::vector<float> floats = { 0.1f, 16777215.0f, std::numeric_limits<float>::quiet_NaN(), 1.0f / 3.0f };
+	output.clear();
+	tng::JSONSerializer::serializeMatrix(floats, 2, output);
+	EXPECT_EQ(output, "[[0.1,16777215],[null,0.33333334]]");
+
+	output.clear();
+	std::vector<float> row = { 1.5f, 2.0f };
+	tng::JSONSerializer::serializeMatrix(row, 2, output);
+	tng::JSONSerializer::serializeArray(std::span<const int64_t>(), output);
+	EXPECT_EQ(output, "[[1.5,2]][]");
+
+	EXPECT_EQ(tng::JSONSerializer::toString(tng::JSONObject("value", tng::JSONValue(0.1f))), "{\"value\":0.1}");
+}
+
+TEST(BulkLoaderTest, IoUringAndThreadPool)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "tng_bulk_loader_test";
+	std::filesystem::create_directories(directory);
+	std::vector<std::filesystem::path> paths;
+	for (uint32_t i = 0; i < 300; ++i)
+	{
+		paths.push_back(directory / ("fragment" + std::to_string(i) + ".json"));
+		std::ofstream stream(paths.back(), std::ios::binary);
+		stream << "{id: " << i << "\n name: " << (i == 7 ? std::string(100000, 'x') : "item") << "}";
+	}
+	paths.push_back(directory / "missing.json");
+
+	for (bool useIoUring : { true, false })
+	{
+		tng::BulkLoader loader(tng::BulkLoadOptions{ .mQueueDepth = 16, .mUseIoUring = useIoUring });
+		std::vector<tng::JSONResult<tng::JSONObject>> results = loader.load(paths);
+		ASSERT_EQ(results.size(), paths.size());
+		for (uint32_t i = 0; i < 300; ++i)
+		{
+			ASSERT_TRUE(results[i].has_value()) << i;
+			tng::JSONObjectView view(*results[i]);
+			EXPECT_EQ(view["id"].getOr<int64_t>(-1), i);
+		}
+		EXPECT_EQ(tng::JSONObjectView(*results[7])["name"].getString()->size(), 100000u);
+		ASSERT_FALSE(results.back().has_value());
+		EXPECT_EQ(results.back().error().mCode, tng::JSONErrorCode::FILE_ERROR);
+	}
+	std::filesystem::remove_all(directory);
+}
+
+TEST(DocumentCacheTest, SharedLoadsAndEviction)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "tng_document_cache_test";
+	std::filesystem::create_directories(directory);
+	auto writeFile = [&](const std::string& pName, const std::string& pText)
+		{
+			std::ofstream stream(directory / pName, std::ios::binary | std::ios::trunc);
+			stream << pText;
+		};
+	writeFile("a.json", "{id: 1}");
+	writeFile("b.json", "{id: 2}");
+
+	tng::DocumentCache cache(tng::DocumentCacheOptions{ .mMaxBytes = 10 });
+	std::vector<tng::DocumentCache::Document> documents(8);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < documents.size(); ++i)
+		threads.emplace_back([&, i]() { documents[i] = cache.get(directory / "a.json").value(); });
+	for (auto& thread : threads)
+		thread.join();
+	for (auto& document : documents)
+		EXPECT_EQ(document, documents.front());
+	EXPECT_EQ(cache.getStats().mMisses, 1u);
+	EXPECT_EQ(cache.getUsedBytes(), 7u);
+
+	// the budget holds only one document;
+	tng::DocumentCache::Document second = cache.get(directory / "b.json").value();
+	EXPECT_EQ(tng::JSONObjectView(*second)["id"].getOr<int32_t>(0), 2);
+	EXPECT_EQ(cache.size(), 1u);
+	EXPECT_EQ(cache.getStats().mEvictions, 1u);
+	EXPECT_EQ(tng::JSONObjectView(*documents.front())["id"].getOr<int32_t>(0), 1);
+
+	writeFile("b.json", "{id: 33}");
+	tng::DocumentCache::Document changed = cache.get(directory / "b.json").value();
+	EXPECT_NE(changed, second);
+	EXPECT_EQ(tng::JSONObjectView(*changed)["id"].getOr<int32_t>(0), 33);
+	EXPECT_EQ(cache.get(directory / "b.json").value(), changed);
+
+	EXPECT_FALSE(cache.get(directory / "missing.json").has_value());
+	cache.clear();
+	EXPECT_EQ(cache.getUsedBytes(), 0u);
+	std::filesystem::remove_all(directory);
+}
+
+#if defined(__linux__)
+TEST(DirectoryWatcherTest, HotReload)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "tng_directory_watcher_test";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	{
+		std::ofstream stream(directory / "config.json", std::ios::binary);
+		stream << "{version: 1}";
+	}
+
+	auto waitFor = [](const std::function<bool()>& pCondition)
+		{
+			for (uint32_t i = 0; i < 500 && !pCondition(); ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			return pCondition();
+		};
+	auto version = [](const tng::DirectoryWatcher::Document& pDocument)
+		{
+			return pDocument == nullptr ? -1 : tng::JSONObjectView(*pDocument)["version"].getOr<int32_t>(0);
+		};
+
+	tng::DirectoryWatcher watcher(directory);
+	ASSERT_TRUE(watcher.start().has_value());
+	tng::DirectoryWatcher::Document first = watcher.get("config.json");
+	EXPECT_EQ(version(first), 1);
+
+	std::string text = "{version: 2}";
+	ASSERT_TRUE(tng::writeFileAtomically(directory / "config.json", text, { .mSync = false }).has_value());
+	EXPECT_TRUE(waitFor([&]() { return version(watcher.get("config.json")) == 2; }));
+	EXPECT_EQ(version(first), 1);
+
+	{
+		std::ofstream stream(directory / "other.json", std::ios::binary);
+		stream << "{version: 3}";
+	}
+	EXPECT_TRUE(waitFor([&]() { return version(watcher.get("other.json")) == 3; }));
+
+	std::filesystem::remove(directory / "config.json");
+	EXPECT_TRUE(waitFor([&]() { return watcher.get("config.json") == nullptr; }));
+
+	watcher.stop();
+	EXPECT_EQ(version(watcher.get("other.json")), 3);
+	std::filesystem::remove_all(directory);
+}
+#endif
+
+TEST(JSONTapeTest, SkipAndMaterialize)
+{
+	std::string text = R"({"name": "tape", list: [1, -2, 0.5, [true, null]], nested: {"k\u00e9y": "a\"b"}, last: word})";
+	tng::JSONResult<tng::JSONTape> tape = tng::JSONTape::create(text);
+	ASSERT_TRUE(tape.has_value());
+	EXPECT_EQ(tape->skip(0), tape->size());
+	EXPECT_EQ(tape->getRaw(0), text);
+
+	// the value of list is the 5th entry, its subtree is skipped in one step;
+	EXPECT_EQ(tape->getRaw(4), "[1, -2, 0.5, [true, null]]");
+	EXPECT_EQ(tape->getRaw(tape->skip(4)), "nested");
+
+	tng::JSONResult<tng::JSONObject> object = tape->toObject();
+	ASSERT_TRUE(object.has_value());
+	tng::JSONObjectView view(*object);
+	EXPECT_EQ(view["name"].getOr<std::string>(""), "tape");
+	EXPECT_EQ(view["list"][size_t{ 1 }].getOr<int32_t>(0), -2);
+	EXPECT_EQ(view["list"][size_t{ 2 }].getOr<float>(0.0f), 0.5f);
+	EXPECT_EQ(view["nested"]["k\xC3\xA9y"].getOr<std::string>(""), "a\"b");
+	EXPECT_EQ(view["last"].getOr<std::string>(""), "word");
+
+	EXPECT_FALSE(tng::JSONTape::create("{a: [1, 2}").has_value());
+	EXPECT_FALSE(tng::JSONTape::create("{a: 1,}").has_value());
+	EXPECT_EQ(tng::JSONTape::create(R"({"a": "open)").error().mPosition, 6u);
+
+	// a surrogate pair becomes one code point, a lone half is rejected as StaticJSON rejects it;
+	EXPECT_EQ(tng::JSONTape::decodeString(R"("\ud83d\ude00")").value_or(""), "\xF0\x9F\x98\x80");
+	EXPECT_EQ(tng::JSONTape::decodeString(R"("a\ud83d")").error().mCode, tng::JSONErrorCode::INVALID_CHARACTER);
+	EXPECT_EQ(tng::JSONTape::decodeString(R"("\ud83dx")").error().mCode, tng::JSONErrorCode::INVALID_CHARACTER);
+	EXPECT_EQ(tng::JSONTape::decodeString(R"("\ude00")").error().mCode, tng::JSONErrorCode::INVALID_CHARACTER);
+}
+
+TEST(IncrementalDocumentTest, LocalEditsMatchFullParse)
+{
+	std::string text = R"({"config": {"title": "old", "sizes": [10, 20, 30]}, "flags": [true, false], "count": 7})";
+	tng::JSONResult<tng::IncrementalDocument> document = tng::IncrementalDocument::create(text);
+	ASSERT_TRUE(document.has_value());
+
+	auto matchesFullParse = [](const tng::IncrementalDocument& pDocument)
+		{
+			tng::JSONResult<tng::JSONTape> tape = tng::JSONTape::create(pDocument.getText());
+			if (!tape || tape->size() != pDocument.getTape().size())
+				return false;
+			for (size_t i = 0; i < tape->size(); ++i)
+			{
+				const tng::JSONTape::Entry& expected = (*tape)[i];
+				const tng::JSONTape::Entry& actual = pDocument.getTape()[i];
+				if (expected.mType != actual.mType || expected.mOffset != actual.mOffset ||
+					expected.mLength != actual.mLength || expected.mMatch != actual.mMatch)
+					return false;
+			}
+			tng::JSONResult<tng::JSONObject> object = tape->toObject();
+			return object && nlohmann::json::parse(tng::JSONSerializer::toString(*object)) ==
+							 nlohmann::json::parse(tng::JSONSerializer::toString(pDocument.getObject()));
+		};
+	auto edit = [&](std::string_view pOld, std::string_view pNew)
+		{
+			size_t offset = document->getText().find(pOld);
+			return document->applyEdit({ static_cast<uint32_t>(offset), static_cast<uint32_t>(pOld.size()), pNew });
+		};
+
+	// a scalar token is scanned alone;
+	ASSERT_TRUE(edit("old", "brand new").has_value());
+	EXPECT_EQ(document->getLastReparsedBytes(), std::string_view(R"("brand new")").size());
+	EXPECT_TRUE(matchesFullParse(*document));
+	EXPECT_EQ(tng::JSONObjectView(document->getObject())["config"]["title"].getOr<std::string>(""), "brand new");
+
+	// an element added to an array rescans only the array;
+	ASSERT_TRUE(edit("30", "30, 40, [50]").has_value());
+	EXPECT_EQ(document->getLastReparsedBytes(), std::string_view("[10, 20, 30, 40, [50]]").size());
+	EXPECT_TRUE(matchesFullParse(*document));
+	EXPECT_EQ(tng::JSONObjectView(document->getObject())["config"]["sizes"][size_t{ 4 }][size_t{ 0 }].getOr<uint32_t>(0), 50u);
+
+	// a number which changes its type and an edited key;
+	ASSERT_TRUE(edit("7", "-17").has_value());
+	ASSERT_TRUE(edit("\"flags\"", "\"options\"").has_value());
+	EXPECT_TRUE(matchesFullParse(*document));
+	EXPECT_EQ(tng::JSONObjectView(document->getObject())["count"].getOr<int32_t>(0), -17);
+	EXPECT_TRUE(document->getObject().contains("options"));
+
+	// an invalid edit is undone;
+	std::string before(document->getText());
+	EXPECT_FALSE(edit("[10", "[[10").has_value());
+	EXPECT_EQ(document->getText(), before);
+	EXPECT_TRUE(matchesFullParse(*document));
+}
+
+TEST(JSONPointerTest, LookupWithoutDom)
+{
+	std::string text = R"({"skip": {"deep": [[1, 2], {"}": "]"}]}, "a": {"b": [0, "x", {}, {"c": "found", "d/e": 1, "f~g": [true]}]},
+						   name: plain, "esc\u0061ped": 5})";
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/3/c").value_or(""), "\"found\"");
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/2").value_or(""), "{}");
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/3/d~1e").value_or(""), "1");
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/3/f~0g/0").value_or(""), "true");
+	EXPECT_EQ(tng::pointerLookup(text, "/name").value_or(""), "plain");
+	EXPECT_EQ(tng::pointerLookup(text, "/escaped").value_or(""), "5");
+	EXPECT_EQ(tng::pointerLookup(text, "/skip/deep/1").value_or(""), R"({"}": "]"})");
+	EXPECT_EQ(tng::pointerLookup(text, "").value_or(""), text);
+
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/4").error().mCode, tng::JSONErrorCode::MISSING_KEY);
+	EXPECT_EQ(tng::pointerLookup(text, "/a/b/01").error().mCode, tng::JSONErrorCode::MISSING_KEY);
+	EXPECT_EQ(tng::pointerLookup(text, "/a/missing").error().mCode, tng::JSONErrorCode::MISSING_KEY);
+	EXPECT_EQ(tng::pointerLookup(text, "/name/x").error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(tng::pointerLookup(text, "a").error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+
+	// the tape finds the same values;
+	tng::JSONResult<tng::JSONTape> tape = tng::JSONTape::create(text);
+	ASSERT_TRUE(tape.has_value());
+	for (std::string_view pointer : { "/a/b/3/c", "/a/b/3/f~0g/0", "/skip/deep/0/1", "/escaped" })
+	{
+		tng::JSONResult<size_t> index = tng::pointerLookup(*tape, pointer);
+		ASSERT_TRUE(index.has_value());
+		EXPECT_EQ(tape->getRaw(*index), tng::pointerLookup(text, pointer).value_or(""));
+	}
+	EXPECT_FALSE(tng::pointerLookup(*tape, "/a/b/3/missing").has_value());
+}
+
+TEST(LazyDocumentTest, DecodesOnlyTouchedValues)
+{
+	std::string text = "{";
+	for (uint32_t i = 0; i < 300; ++i)
+		text += "field" + std::to_string(i) + ": \"value" + std::to_string(i) + "\", ";
+	text += R"(user: {id: 42, name: "Ann", roles: ["admin", "dev"]}, big: 5000000000, dup: 1, dup: 2})";
+
+	tng::JSONResult<tng::LazyDocument> document = tng::LazyDocument::create(std::move(text));
+	ASSERT_TRUE(document.has_value());
+	EXPECT_EQ(document->getDecodedCount(), 0u);
+
+	EXPECT_EQ((*document)["user"]["id"].getOr<uint32_t>(0), 42u);
+	EXPECT_EQ((*document)["user"]["roles"][size_t{ 1 }].getOr<std::string>(""), "dev");
+	EXPECT_EQ((*document)["field150"].getOr<std::string>(""), "value150");
+	EXPECT_EQ((*document)["dup"].getOr<uint32_t>(0), 2u);
+	EXPECT_EQ(document->getDecodedCount(), 4u);
+
+	// a second access uses the decoded value;
+	EXPECT_EQ((*document)["field150"].getView().getString().value_or(""), "value150");
+	EXPECT_EQ(document->getDecodedCount(), 4u);
+
+	tng::LazyValue user = (*document)["user"];
+	EXPECT_TRUE(user.isObject());
+	EXPECT_EQ(user.size(), 3u);
+	EXPECT_EQ(user["roles"].getRaw(), R"(["admin", "dev"])");
+	EXPECT_EQ(user.getView().getObject()["name"].getOr<std::string>(""), "Ann");
+
+	EXPECT_FALSE((*document)["missing"]["deeper"].exists());
+	EXPECT_EQ((*document)["user"]["roles"][5].getOr<std::string>("none"), "none");
+	EXPECT_EQ((*document)["user"]["roles"][0].getOr<std::string>(""), "admin");
+	EXPECT_FALSE((*document)["user"]["roles"][-1].exists());
+	EXPECT_FALSE((*document)["big"].getView().exists());
+
+	EXPECT_FALSE(tng::LazyDocument::create("{a: [1, 2}").has_value());
+}
+
+TEST(JSONProjectionTest, AllSelectorsInOnePass)
+{
+	std::string text = R"({"user": {"id": 7, "name": "Ann"}, "items": [{"price": 10, "skip": {"a": [1]}}, {"price": 2.5}, {"other": 1}],
+						   noise: {"deep": [[["}"]]]}, "with.dot": true})";
+	tng::JSONResult<tng::JSONProjection> projection = tng::JSONProjection::compile(
+		{ "$.user.id", "$.items[*].price", "$.items[1]", "$['with.dot']", "$.user.*", "$.missing", "$" });
+	ASSERT_TRUE(projection.has_value());
+	EXPECT_EQ(projection->getSelectorCount(), 7u);
+
+	tng::JSONResult<tng::ProjectionMatches> matches = projection->run(text);
+	ASSERT_TRUE(matches.has_value());
+	EXPECT_EQ((*matches)[0], std::vector<std::string_view>{ "7" });
+	EXPECT_EQ((*matches)[1], (std::vector<std::string_view>{ "10", "2.5" }));
+	EXPECT_EQ((*matches)[2], std::vector<std::string_view>{ R"({"price": 2.5})" });
+	EXPECT_EQ((*matches)[3], std::vector<std::string_view>{ "true" });
+	EXPECT_EQ((*matches)[4], (std::vector<std::string_view>{ "7", "\"Ann\"" }));
+	EXPECT_TRUE((*matches)[5].empty());
+	EXPECT_EQ((*matches)[6], std::vector<std::string_view>{ text });
+
+	tng::JSONResult<tng::JSONValue> price = tng::JSONProjection::decode((*matches)[1][1]);
+	ASSERT_TRUE(price.has_value());
+	EXPECT_EQ(price->getFloat(), 2.5f);
+
+	EXPECT_FALSE(tng::JSONProjection::compile({ "user.id" }).has_value());
+	EXPECT_FALSE(tng::JSONProjection::compile({ "$.items[x]" }).has_value());
+	EXPECT_FALSE(projection->run("{\"user\": {\"id\": 7}").has_value());
+}
+
+TEST(ParseTest, FieldAllowList)
+{
+	std::string text = "{";
+	for (uint32_t i = 0; i < 300; ++i)
+		text += "field" + std::to_string(i) + ": [" + std::to_string(i) + ", {\"x\": \"}]\"}]\n ";
+	text += "id: 17\n status: ok\n ts: 1700000000\n user: {\"name\": \"Ann\", \"age\": 30}\n meta: {\"a\": 1}}";
+
+	tng::JSONParser parser;
+	nlohmann::json data = parser.parseToJSON(text, { "id", "ts", "status", "missing" });
+	EXPECT_EQ(data, nlohmann::json::parse(R"({"id": 17, "ts": 1700000000, "status": "ok"})"));
+
+	// a dotted name keeps one member of a nested object, an object without kept members is dropped;
+	tng::ParseOptions options;
+	options.mFields = { "user.name", "meta.none", "id" };
+	tng::JSONResult<tng::JSONObject> object = tng::parse(text, options);
+	ASSERT_TRUE(object.has_value());
+	EXPECT_EQ(nlohmann::json::parse(tng::JSONSerializer::toString(*object)),
+			  nlohmann::json::parse(R"({"id": 17, "user": {"name": "Ann"}})"));
+	EXPECT_FALSE(object->contains("meta"));
+	EXPECT_EQ(parser.parseToJSON(text, { "user", "id" }),
+			  nlohmann::json::parse(R"({"id": 17, "user": {"name": "Ann", "age": 30}})"));
+	EXPECT_EQ(tng::JSONObjectView(*object)["id"].getOr<uint32_t>(0), 17u);
+
+	EXPECT_FALSE(parser.tryParseToJSON("{id: 1\n skipped: [1, 2}", std::vector<std::string_view>{ "id" }).has_value());
+}
+
+namespace
+{
+	struct BoundPoint
+	{
+		float mX{};
+		float mY{};
+	};
+
+	struct BoundOrder
+	{
+		uint64_t mId{};
+		int16_t mDelta{};
+		double mPrice{};
+		bool mActive{};
+		std::string mName;
+		std::string_view mCode;
+		std::vector<int32_t> mTags;
+		std::optional<BoundPoint> mPoint;
+		std::vector<BoundPoint> mPath;
+		std::string mUntouched{ "default" };
+	};
+}
+
+TNG_JSON_BINDING(BoundPoint, tng::field("x", &BoundPoint::mX), tng::field("y", &BoundPoint::mY))
+TNG_JSON_BINDING(BoundOrder, tng::field("id", &BoundOrder::mId), tng::field("delta", &BoundOrder::mDelta),
+				 tng::field("price", &BoundOrder::mPrice), tng::field("active", &BoundOrder::mActive),
+				 tng::field("name", &BoundOrder::mName), tng::field("code", &BoundOrder::mCode),
+				 tng::field("tags", &BoundOrder::mTags), tng::field("point", &BoundOrder::mPoint),
+				 tng::field("path", &BoundOrder::mPath), tng::field("untouched", &BoundOrder::mUntouched))
+
+TEST(JSONBindingTest, DecodesStraightIntoStructs)
+{
+	std::string text = R"({"id": 9007199254740993, "delta": -12, "price": 19.99, "active": true, "name": "caf\u00e9 \"x\"",
+						   "code": "A-1", "tags": [1, -2, 3], "point": {"x": 1.5, "y": -2}, "ignored": {"deep": [1, {"}": 2}]},
+						   path: [{x: 0, y: 0} {x: 1, y: 1}]})";
+	tng::JSONResult<BoundOrder> order = tng::bind<BoundOrder>(text);
+	ASSERT_TRUE(order.has_value());
+	EXPECT_EQ(order->mId, 9007199254740993u);
+	EXPECT_EQ(order->mDelta, -12);
+	EXPECT_DOUBLE_EQ(order->mPrice, 19.99);
+	EXPECT_TRUE(order->mActive);
+	EXPECT_EQ(order->mName, "caf\xC3\xA9 \"x\"");
+	EXPECT_EQ(order->mCode, "A-1");
+	EXPECT_EQ(order->mTags, (std::vector<int32_t>{ 1, -2, 3 }));
+	ASSERT_TRUE(order->mPoint.has_value());
+	EXPECT_EQ(order->mPoint->mY, -2.0f);
+	ASSERT_EQ(order->mPath.size(), 2u);
+	EXPECT_EQ(order->mPath[1].mX, 1.0f);
+	EXPECT_EQ(order->mUntouched, "default");
+
+	// binding into an existing object changes only the members in the text;
+	ASSERT_TRUE(tng::bind(R"({"point": null})", *order).has_value());
+	EXPECT_FALSE(order->mPoint.has_value());
+	EXPECT_EQ(order->mTags.size(), 3u);
+	EXPECT_EQ(tng::bind<BoundOrder>(R"({"delta": 40000})").error().mCode, tng::JSONErrorCode::NUMBER_OUT_OF_RANGE);
+	EXPECT_EQ(tng::bind<BoundOrder>(R"({"id": -1})").error().mCode, tng::JSONErrorCode::INVALID_NUMBER);
+	EXPECT_EQ(tng::bind<BoundOrder>(R"({"active": 1})").error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(tng::bind<BoundOrder>(R"({"tags": [1, 2})").error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+}
+
+#define TNG_WIDE_FIELDS(F)																	\
+	F(1) F(2) F(3) F(4) F(5) F(6) F(7) F(8) F(9) F(10) F(11) F(12) F(13) F(14) F(15)					\
+	F(16) F(17) F(18) F(19) F(20) F(21) F(22) F(23) F(24) F(25) F(26) F(27) F(28) F(29) F(30) F(31)		\
+	F(32) F(33) F(34) F(35) F(36) F(37) F(38) F(39) F(40) F(41) F(42) F(43) F(44) F(45) F(46) F(47)		\
+	F(48) F(49) F(50) F(51) F(52) F(53) F(54) F(55) F(56) F(57) F(58) F(59) F(60) F(61) F(62) F(63)
+#define TNG_WIDE_MEMBER(N) int32_t m##N{};
+#define TNG_WIDE_FIELD(N) , tng::field("f" #N, &WideRecord::m##N)
+
+struct WideRecord
+{
+	int32_t m0{};
+	TNG_WIDE_FIELDS(TNG_WIDE_MEMBER)
+};
+
+TNG_JSON_BINDING(WideRecord, tng::field("f0", &WideRecord::m0) TNG_WIDE_FIELDS(TNG_WIDE_FIELD))
+
+TEST(JSONBindingTest, PerfectHashOfFieldNames)
+{
+	using Table = tng::JSONFieldTable<BoundOrder>;
+	static_assert(Table::COUNT == 10);
+	static_assert(Table::mSlots.size() >= 2 * Table::COUNT);
+	for (size_t i = 0; i < Table::COUNT; ++i)
+		EXPECT_EQ(Table::find(Table::mNames[i]), i);
+	for (std::string_view unknown : { "", "i", "idd", "nam", "Name", "untouched ", "ignored" })
+		EXPECT_EQ(Table::find(unknown), Table::EMPTY);
+
+
+	// 64 names which differ in one or two bytes;
+	using WideTable = tng::JSONFieldTable<WideRecord>;
+	static_assert(WideTable::COUNT == 64);
+	for (size_t i = 0; i < WideTable::COUNT; ++i)
+		EXPECT_EQ(WideTable::find(WideTable::mNames[i]), i);
+	EXPECT_EQ(WideTable::find("f64"), WideTable::EMPTY);
+	tng::JSONResult<WideRecord> wide = tng::bind<WideRecord>(R"({"f0": 1, "f37": 2, "f63": 3, "f99": 4})");
+	ASSERT_TRUE(wide.has_value());
+	EXPECT_EQ(wide->m0 + wide->m37 + wide->m63, 6);
+}
+
+TEST(StaticJSONTest, LiteralsAreParsedAtCompileTime)
+{
+	using namespace tng::literals;
+	constexpr auto& config = tng::static_json<"{host: \"local\\u0068ost\"\n port: 8080\n ratio: -2.5e-1\n"
+											  " offset: -3\n debug: false\n proxy: null\n"
+											  " tags: [a, \"b c\", 7]\n limits: {rps: 100, burst: 1e3}}">;
+
+	// everything below is folded by the compiler;
+	static_assert(config.size() == 8);
+	static_assert(config["host"].getString() == "localhost");
+	static_assert(config["port"].getUint() == 8080u);
+	static_assert(config["ratio"].getFloat() == -0.25f);
+	static_assert(config["offset"].getInt() == -3);
+	static_assert(config["debug"].getBool() == false);
+	static_assert(config["proxy"].isNull());
+	static_assert(config["tags"].size() == 3);
+	static_assert(config["tags"][1].getString() == "b c");
+	static_assert(config["tags"][0].getString() == "a");
+	static_assert(config["limits"]["burst"].getFloat() == 1000.0f);
+	static_assert(!config["missing"]["deeper"].exists());
+	static_assert(config["port"].getOr<int16_t>(0) == 8080);
+	static_assert(config["port"].getOr<int8_t>(5) == 5);
+
+	constexpr auto& list = "[1, [2, 3], {a: 4}, \"\\ud83d\\ude00\"]"_static_json;
+	static_assert(&list == &tng::static_json<"[1, [2, 3], {a: 4}, \"\\ud83d\\ude00\"]">);
+	static_assert(list.size() == 4);
+	static_assert(list[1][1].getUint() == 3u);
+	static_assert(list[0].getUint() == 1u);
+	static_assert(list[2]["a"].getInt() == 4);
+	static_assert(list[3].getString() == "\xF0\x9F\x98\x80");
+	static_assert(!list[-1].exists());
+
+	// the same literal through the runtime parser;
+	tng::JSONResult<tng::JSONObject> runtime = tng::parse("{host: localhost\n port: 8080\n offset: -3\n debug: false}");
+	ASSERT_TRUE(runtime.has_value());
+	tng::JSONObjectView view(*runtime);
+	EXPECT_EQ(view["port"].getUint(), config["port"].getUint());
+	EXPECT_EQ(view["offset"].getInt(), config["offset"].getInt());
+	EXPECT_EQ(view["host"].getString(), config["host"].getString());
+
+	std::vector<std::string> keys;
+	for (tng::StaticValue member : config["limits"])
+		keys.emplace_back(member.getKey());
+	EXPECT_EQ(keys, (std::vector<std::string>{ "rps", "burst" }));
+}
+
+TEST(JSONSchemaTest, ValidatesOnTheTokenTape)
+{
+	tng::JSONResult<tng::JSONSchema> schema = tng::JSONSchema::compile(R"({
+		"type": "object",
+		"required": ["id", "items"],
+		"properties": {
+			"id": {"type": "integer", "minimum": 1},
+			"name": {"type": ["string", "null"], "maxLength": 5},
+			"status": {"enum": ["new", "done", 3]},
+			"items": {"type": "array", "items": {"type": "object", "required": ["price"],
+												 "properties": {"price": {"type": "number", "maximum": 100}}}}
+		}})");
+	ASSERT_TRUE(schema.has_value());
+	EXPECT_EQ(schema->getRuleCount(), 7u);
+
+	auto makeDocument = [](size_t pItems, size_t pBadItem, std::string_view pHead)
+		{
+			std::string text = "{" + std::string(pHead) + " items: [";
+			for (size_t i = 0; i < pItems; ++i)
+			{
+				text += i == 0 ? "" : ", ";
+				text += i == pBadItem ? "{price: 101}" : "{price: " + std::to_string(i % 100) + ", sku: x}";
+			}
+			return text + "]}";
+		};
+
+	tng::ThreadPool pool(4);
+	EXPECT_TRUE(schema->validate(makeDocument(3, 99, "id: 1\n name: \"h\\u00e9llo\"\n status: done\n"), pool));
+	EXPECT_TRUE(schema->validate(makeDocument(0, 99, "id: 2\n name: null\n status: 3.0\n"), pool));
+
+	auto errorOf = [&](const std::string& pText)
+		{
+			tng::JSONStatus status = schema->validate(pText, pool);
+			return status ? tng::JSONErrorCode::NONE : status.error().mCode;
+		};
+	EXPECT_EQ(errorOf(makeDocument(3, 99, "id: 1.5\n")), tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(errorOf(makeDocument(3, 99, "id: 0\n")), tng::JSONErrorCode::SCHEMA_VIOLATION);
+	EXPECT_EQ(errorOf(makeDocument(3, 99, "id: 1\n name: \"hello!\"\n")), tng::JSONErrorCode::SCHEMA_VIOLATION);
+	EXPECT_EQ(errorOf(makeDocument(3, 99, "id: 1\n status: old\n")), tng::JSONErrorCode::SCHEMA_VIOLATION);
+	EXPECT_EQ(errorOf(makeDocument(3, 99, "name: abc\n")), tng::JSONErrorCode::MISSING_KEY);
+	EXPECT_EQ(errorOf("{id: 1\n items: [{sku: x}]}"), tng::JSONErrorCode::MISSING_KEY);
+	EXPECT_EQ(errorOf("{id: 1\n items: [1, 2"), tng::JSONErrorCode::INVALID_TEXT);
+
+	// a large array is checked in parallel, the reported failure is the first one;
+	std::string large = makeDocument(5000, 3000, "id: 1\n");
+	size_t expected = large.find("101");
+	large.replace(large.find("price: 99", expected), 9, "price: 1e3");
+	tng::JSONStatus status = schema->validate(large, pool);
+	ASSERT_FALSE(status.has_value());
+	EXPECT_EQ(status.error().mCode, tng::JSONErrorCode::SCHEMA_VIOLATION);
+	EXPECT_EQ(status.error().mPosition, expected);
+	EXPECT_TRUE(schema->validate(makeDocument(5000, 5000, "id: 1\n"), pool));
+
+	tng::JSONResult<tng::JSONObject> object = schema->parse("{id: 7\n items: [{price: 5}]}");
+	ASSERT_TRUE(object.has_value());
+	EXPECT_EQ(tng::JSONObjectView(*object)["id"].getUint(), 7u);
+	EXPECT_FALSE(schema->parse("{id: 7}").has_value());
+}
+
+TEST(JSONColumnsTest, ExtractsTypedColumns)
+{
+	tng::JSONResult<tng::ColumnarExtractor> extractor = tng::ColumnarExtractor::create({
+		{ "id", tng::ColumnType::INT64 }, { "price", tng::ColumnType::DOUBLE }, { "name", tng::ColumnType::STRING } });
+	ASSERT_TRUE(extractor.has_value());
+	EXPECT_FALSE(tng::ColumnarExtractor::create({ { "id", tng::ColumnType::INT64 }, { "id", tng::ColumnType::DOUBLE } }).has_value());
+
+	ASSERT_TRUE(extractor->addArray(R"([{"id": 1, "price": 2.5, "name": "a\"b", "skipped": {"x": [1, 2]}},
+									   {id: -7, price: 3, name: bare, tags: [1]},
+									   {"price": null, "name": {"nested": true}}])"));
+	ASSERT_TRUE(extractor->addNDJSON("{id: 9}\n\r\n{id: 10, name: \"\\u00e9\"}\r\n  \n{id: 11, id: 12}"));
+	EXPECT_EQ(extractor->getRowCount(), 6u);
+
+	const tng::JSONColumn* ids = extractor->getColumn("id");
+	const tng::JSONColumn* prices = extractor->getColumn("price");
+	const tng::JSONColumn* names = extractor->getColumn("name");
+	ASSERT_NE(ids, nullptr);
+	EXPECT_EQ(extractor->getColumn("tags"), nullptr);
+	EXPECT_EQ(std::vector<int64_t>(ids->getInts().begin(), ids->getInts().end()), (std::vector<int64_t>{ 1, -7, 0, 9, 10, 12 }));
+	EXPECT_EQ(prices->getDoubles()[0], 2.5);
+	EXPECT_EQ(prices->getDoubles()[1], 3.0);
+	EXPECT_TRUE(ids->isNull(2));
+	EXPECT_FALSE(ids->isNull(3));
+	EXPECT_EQ(prices->getNullCount(), 4u);
+	EXPECT_EQ(names->getString(0), "a\"b");
+	EXPECT_EQ(names->getString(1), "bare");
+	EXPECT_EQ(names->getString(2), "{\"nested\": true}");
+	EXPECT_EQ(names->getString(4), "\xC3\xA9");
+	EXPECT_TRUE(names->isNull(3));
+	EXPECT_EQ(names->getOffsets().size(), 7u);
+
+	// a failed call keeps no rows of its own;
+	tng::JSONStatus status = extractor->addNDJSON("{id: 20}\n{id: 21}\n{id: \"x\"}");
+	ASSERT_FALSE(status.has_value());
+	EXPECT_EQ(status.error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(status.error().mPosition, 23u);
+	EXPECT_EQ(extractor->addArray("[{id: 1.5}]").error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(extractor->addRecord("{id: 1, name: x").error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+	EXPECT_EQ(extractor->getRowCount(), 6u);
+	EXPECT_EQ(ids->size(), 6u);
+	EXPECT_EQ(names->getChars().size(), names->getOffsets().back());
+
+	// the null bitmap crosses words;
+	extractor->clear();
+	std::string records;
+	for (size_t i = 0; i < 200; ++i)
+		records += i % 3 == 0 ? "{name: n}\n" : "{id: " + std::to_string(i) + "}\n";
+	ASSERT_TRUE(extractor->addNDJSON(records));
+	EXPECT_EQ(ids->getNullBitmap().size(), 4u);
+	EXPECT_EQ(ids->getNullCount(), 67u);
+	EXPECT_TRUE(ids->isNull(198));
+	EXPECT_EQ(ids->getInts()[199], 199);
+	EXPECT_EQ(names->getNullCount(), 133u);
+}
+
+TEST(BinaryCodecTest, MessagePackAndCBORRoundTrip)
+{
+	tng::JSONObject nested;
+	nested.addObject("deep", tng::JSONValue(std::string(300, 'x')));
+	tng::JSONObject object;
+	object.addObject("flag", tng::JSONValue(true));
+	object.addObject("small", tng::JSONValue(7u));
+	object.addObject("large", tng::JSONValue(4000000000u));
+	object.addObject("negative", tng::JSONValue(-40000));
+	object.addObject("ratio", tng::JSONValue(2.5f));
+	object.addObject("empty", tng::JSONValue(nullptr));
+	object.addObject("list", tng::JSONValue(std::vector<tng::JSONValue>{ tng::JSONValue(1u), tng::JSONValue(std::string("a")) }));
+	object.addObject("rows", tng::JSONValue(std::vector<std::vector<tng::JSONValue>>{ { tng::JSONValue(1u) }, { tng::JSONValue(2u), tng::JSONValue(3u) } }));
+	object.addObject("child", tng::JSONValue(std::move(nested)));
+
+	for (tng::BinaryFormat format : { tng::BinaryFormat::MESSAGE_PACK, tng::BinaryFormat::CBOR })
+	{
+		std::string buffer;
+		tng::BinaryCodec::encode(object, buffer, format);
+		tng::JSONResult<tng::JSONObject> copy = tng::BinaryCodec::decodeObject(buffer, format);
+		ASSERT_TRUE(copy.has_value());
+		EXPECT_EQ(copy->getSize(), object.getSize());
+		EXPECT_TRUE(copy->findValue("flag")->getBool());
+		EXPECT_EQ(copy->findValue("small")->getUint(), 7u);
+		EXPECT_EQ(copy->findValue("large")->getUint(), 4000000000u);
+		EXPECT_EQ(copy->findValue("negative")->getInt(), -40000);
+		EXPECT_EQ(copy->findValue("ratio")->getFloat(), 2.5f);
+		EXPECT_TRUE(copy->findValue("empty")->valueIsNull());
+		EXPECT_EQ(copy->findValue("list")->getArray()[1].getString(), "a");
+		EXPECT_EQ(copy->findValue("rows")->getArray()[1].getArray()[1].getUint(), 3u);
+		EXPECT_EQ(copy->findValue("child")->getObject().findValue("deep")->getString().size(), 300u);
+		EXPECT_EQ(tng::BinaryCodec::decode(buffer, format)->valueIsObject(), true);
+
+		// a truncated buffer is an error at any length;
+		for (size_t size = 0; size < buffer.size(); size += 7)
+			EXPECT_FALSE(tng::BinaryCodec::decodeObject(std::string_view(buffer).substr(0, size), format).has_value());
+	}
+
+	// smallest forms;
+	tng::JSONObject single;
+	single.addObject("a", tng::JSONValue(1u));
+	std::string msgpack;
+	std::string cbor;
+	tng::BinaryCodec::encode(single, msgpack, tng::BinaryFormat::MESSAGE_PACK);
+	tng::BinaryCodec::encode(single, cbor, tng::BinaryFormat::CBOR);
+	EXPECT_EQ(msgpack, std::string("\x81\xA1\x61\x01"));
+	EXPECT_EQ(cbor, std::string("\xA1\x61\x61\x01"));
+
+	// forms which the encoder does not write: float64, indefinite lengths, tags, half floats;
+	EXPECT_EQ(tng::BinaryCodec::decode(std::string("\xCB\x3F\xF8\0\0\0\0\0\0", 9), tng::BinaryFormat::MESSAGE_PACK)->getFloat(), 1.5f);
+	tng::JSONResult<tng::JSONValue> indefinite = tng::BinaryCodec::decode("\x9F\x01\xC1\x02\xFF", tng::BinaryFormat::CBOR);
+	ASSERT_TRUE(indefinite.has_value());
+	EXPECT_EQ(indefinite->getArray().size(), 2u);
+	EXPECT_EQ(indefinite->getArray()[1].getUint(), 2u);
+	EXPECT_EQ(tng::BinaryCodec::decode("\x7F\x62\x61\x62\x61\x63\xFF", tng::BinaryFormat::CBOR)->getString(), "abc");
+	EXPECT_EQ(tng::BinaryCodec::decode(std::string("\xF9\x3E\x00", 3), tng::BinaryFormat::CBOR)->getFloat(), 1.5f);
+
+	// values which do not fit into JSONValue;
+	EXPECT_EQ(tng::BinaryCodec::decode("\xCF\x01\x02\x03\x04\x05\x06\x07\x08", tng::BinaryFormat::MESSAGE_PACK).error().mCode, tng::JSONErrorCode::NUMBER_OUT_OF_RANGE);
+	EXPECT_EQ(tng::BinaryCodec::decode("\x42\x01\x02", tng::BinaryFormat::CBOR).error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(tng::BinaryCodec::decode("\xA1\x01\x01", tng::BinaryFormat::CBOR).error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(tng::BinaryCodec::decodeObject("\x01", tng::BinaryFormat::CBOR).error().mCode, tng::JSONErrorCode::TYPE_MISMATCH);
+	EXPECT_EQ(tng::BinaryCodec::decode("\xDD\xFF\xFF\xFF\xFF", tng::BinaryFormat::MESSAGE_PACK).error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+	EXPECT_EQ(tng::BinaryCodec::decode(std::string(2000, '\x91'), tng::BinaryFormat::MESSAGE_PACK).error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+
+	// values one after another in one buffer;
+	std::string stream;
+	tng::BinaryCodec::encode(tng::JSONValue(-3), stream, tng::BinaryFormat::CBOR);
+	tng::BinaryCodec::encode(single, stream, tng::BinaryFormat::CBOR);
+	size_t offset{};
+	EXPECT_EQ(tng::BinaryCodec::decode(stream, offset, tng::BinaryFormat::CBOR)->getInt(), -3);
+	EXPECT_EQ(offset, 1u);
+	EXPECT_EQ(tng::BinaryCodec::decodeObject(stream, offset, tng::BinaryFormat::CBOR)->getSize(), 1u);
+	EXPECT_EQ(offset, stream.size());
+	EXPECT_EQ(tng::BinaryCodec::decode(stream, tng::BinaryFormat::CBOR).error().mPosition, 1u);
+}
+
+TEST(JSONSnapshotTest, QueriesTheMappedFile)
+{
+	std::string text = R"({"name": "svc\n1", port: 8080, ratio: -0.5, big: 18446744073709551615, neg: -9000000000,
+		"on": true, off: false, none: null, empty: {}, list: [1, [2, 3], {"k": "v"}],
+		items: [{"id": 1, "id": 2}, {"id": 3}]})";
+
+	tng::JSONParser parser;
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "tng_snapshot_test.snap";
+	parser.writeSnapshot(path, text, { .mSync = false });
+	tng::JSONSnapshot snapshot = parser.openSnapshot(path);
+	EXPECT_TRUE(snapshot.isMapped());
+
+	EXPECT_EQ(snapshot.getRoot().size(), 11u);
+	EXPECT_EQ(snapshot["name"].getString(), "svc\n1");
+	EXPECT_EQ(snapshot["port"].getInt(), 8080);
+	EXPECT_EQ(snapshot["ratio"].getDouble(), -0.5);
+	EXPECT_EQ(snapshot["big"].getUint(), 18446744073709551615ull);
+	EXPECT_FALSE(snapshot["big"].getInt().has_value());
+	EXPECT_EQ(snapshot["neg"].getInt(), -9000000000ll);
+	EXPECT_EQ(snapshot["on"].getBool(), true);
+	EXPECT_EQ(snapshot["off"].getBool(), false);
+	EXPECT_TRUE(snapshot["none"].isNull());
+	EXPECT_TRUE(snapshot["empty"].isObject());
+	EXPECT_EQ(snapshot["empty"].size(), 0u);
+	EXPECT_EQ(snapshot["list"][1][1].getUint(), 3u);
+	EXPECT_EQ(snapshot["list"][2]["k"].getString(), "v");
+	EXPECT_EQ(snapshot["items"][0]["id"].getInt(), 2);
+	EXPECT_EQ(snapshot["items"][1]["id"].getKey(), "id");
+	EXPECT_FALSE(snapshot["list"][3].exists());
+	EXPECT_FALSE(snapshot["missing"]["deeper"][0].getInt().has_value());
+	EXPECT_FALSE(snapshot["items"][-1].exists());
+	EXPECT_FALSE(snapshot["port"].getString().has_value());
+
+	std::string keys;
+	for (tng::SnapshotValue member : snapshot.getRoot())
+		keys += std::string(member.getKey()) + ",";
+	EXPECT_EQ(keys, "name,port,ratio,big,neg,on,off,none,empty,list,items,");
+	size_t elements{};
+	for (tng::SnapshotValue element : snapshot["list"])
+		elements += element.exists() ? 1 : 0;
+	EXPECT_EQ(elements, 3u);
+
+	// repeated keys are stored once;
+	std::string records = "[";
+	for (size_t i = 0; i < 100; ++i)
+		records += "{\"identifier\": " + std::to_string(i) + "},";
+	records.back() = ']';
+	std::string built;
+	ASSERT_TRUE(tng::JSONSnapshot::build(records, built));
+	tng::JSONResult<tng::JSONSnapshot> inMemory = tng::JSONSnapshot::view(built);
+	ASSERT_TRUE(inMemory.has_value());
+	EXPECT_EQ(inMemory->getNodeCount(), 301u);
+	EXPECT_EQ(built.size(), sizeof(tng::SnapshotHeader) + 301 * sizeof(tng::SnapshotNode) + 10);
+	EXPECT_EQ(inMemory->getRoot()[99]["identifier"].getUint(), 99u);
+
+	// errors of the text, damaged and foreign files;
+	std::string failed = "keep";
+	EXPECT_EQ(tng::JSONSnapshot::build("{a: 99999999999999999999}", failed).error().mCode, tng::JSONErrorCode::NUMBER_OUT_OF_RANGE);
+	EXPECT_EQ(failed, "keep");
+	EXPECT_FALSE(tng::JSONSnapshot::view(std::string_view(built).substr(0, built.size() - 1)).has_value());
+	EXPECT_FALSE(parser.tryOpenSnapshot(std::filesystem::temp_directory_path() / "tng_missing.snap").has_value());
+	std::string damaged = built;
+	tng::SnapshotNode root;
+	std::memcpy(&root, damaged.data() + sizeof(tng::SnapshotHeader), sizeof(root));
+	root.mPayload = 0;
+	std::memcpy(damaged.data() + sizeof(tng::SnapshotHeader), &root, sizeof(root));
+	tng::JSONResult<tng::JSONSnapshot> broken = tng::JSONSnapshot::view(damaged);
+	ASSERT_TRUE(broken.has_value());
+	EXPECT_TRUE(broken->getRoot()[99]["identifier"].getUint().has_value());
+	parser.writeFile(path, tng::JSONObject());
+	EXPECT_EQ(parser.tryOpenSnapshot(path).error().mCode, tng::JSONErrorCode::INVALID_TEXT);
+	std::filesystem::remove(path);
+}
+
 int32_t main(int32_t argc, char* argv[])
 {
 	::testing::InitGoogleTest(&argc, argv);
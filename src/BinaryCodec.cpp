@@ -0,0 +1,841 @@
+#include "BinaryCodec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		template<typename T>
+		void putBigEndian(std::string& pOutput, T pValue)
+		{
+			for (size_t i = sizeof(T); i-- > 0;)
+				pOutput.push_back(static_cast<char>(static_cast<uint64_t>(pValue) >> (i * 8)));
+		}
+
+		struct MessagePackWriter
+		{
+			std::string& mOutput;
+
+			void putNull()
+			{
+				mOutput.push_back(static_cast<char>(0xC0));
+			}
+
+			void putBool(bool pValue)
+			{
+				mOutput.push_back(static_cast<char>(pValue ? 0xC3 : 0xC2));
+			}
+
+			void putUint(uint64_t pValue)
+			{
+				if (pValue < 0x80)
+					mOutput.push_back(static_cast<char>(pValue));
+				else if (pValue <= 0xFF)
+				{
+					mOutput.push_back(static_cast<char>(0xCC));
+					putBigEndian(mOutput, static_cast<uint8_t>(pValue));
+				}
+				else if (pValue <= 0xFFFF)
+				{
+					mOutput.push_back(static_cast<char>(0xCD));
+					putBigEndian(mOutput, static_cast<uint16_t>(pValue));
+				}
+				else if (pValue <= 0xFFFFFFFF)
+				{
+					mOutput.push_back(static_cast<char>(0xCE));
+					putBigEndian(mOutput, static_cast<uint32_t>(pValue));
+				}
+				else
+				{
+					mOutput.push_back(static_cast<char>(0xCF));
+					putBigEndian(mOutput, pValue);
+				}
+			}
+
+			//
+			// pValue is negative;
+			//
+			void putNegative(int64_t pValue)
+			{
+				if (pValue >= -32)
+					mOutput.push_back(static_cast<char>(pValue));
+				else if (pValue >= std::numeric_limits<int8_t>::min())
+				{
+					mOutput.push_back(static_cast<char>(0xD0));
+					putBigEndian(mOutput, static_cast<uint8_t>(pValue));
+				}
+				else if (pValue >= std::numeric_limits<int16_t>::min())
+				{
+					mOutput.push_back(static_cast<char>(0xD1));
+					putBigEndian(mOutput, static_cast<uint16_t>(pValue));
+				}
+				else if (pValue >= std::numeric_limits<int32_t>::min())
+				{
+					mOutput.push_back(static_cast<char>(0xD2));
+					putBigEndian(mOutput, static_cast<uint32_t>(pValue));
+				}
+				else
+				{
+					mOutput.push_back(static_cast<char>(0xD3));
+					putBigEndian(mOutput, static_cast<uint64_t>(pValue));
+				}
+			}
+
+			void putFloat(float pValue)
+			{
+				mOutput.push_back(static_cast<char>(0xCA));
+				putBigEndian(mOutput, std::bit_cast<uint32_t>(pValue));
+			}
+
+			void putString(std::string_view pValue)
+			{
+				putHeader(pValue.size(), 0xA0, 32, 0xD9, 0xDA, 0xDB);
+				mOutput.append(pValue);
+			}
+
+			void putArrayHeader(size_t pSize)
+			{
+				putHeader(pSize, 0x90, 16, 0, 0xDC, 0xDD);
+			}
+
+			void putMapHeader(size_t pSize)
+			{
+				putHeader(pSize, 0x80, 16, 0, 0xDE, 0xDF);
+			}
+
+		private:
+			//
+			// fix form below pFixLimit, then 8-bit (if pCode8 is set), 16-bit and 32-bit lengths;
+			//
+			void putHeader(size_t pSize, uint8_t pFixBase, size_t pFixLimit, uint8_t pCode8, uint8_t pCode16, uint8_t pCode32)
+			{
+				if (pSize < pFixLimit)
+					mOutput.push_back(static_cast<char>(pFixBase | pSize));
+				else if (pCode8 != 0 && pSize <= 0xFF)
+				{
+					mOutput.push_back(static_cast<char>(pCode8));
+					putBigEndian(mOutput, static_cast<uint8_t>(pSize));
+				}
+				else if (pSize <= 0xFFFF)
+				{
+					mOutput.push_back(static_cast<char>(pCode16));
+					putBigEndian(mOutput, static_cast<uint16_t>(pSize));
+				}
+				else
+				{
+					mOutput.push_back(static_cast<char>(pCode32));
+					putBigEndian(mOutput, static_cast<uint32_t>(pSize));
+				}
+			}
+		};
+
+		struct CBORWriter
+		{
+			std::string& mOutput;
+
+			void putNull()
+			{
+				mOutput.push_back(static_cast<char>(0xF6));
+			}
+
+			void putBool(bool pValue)
+			{
+				mOutput.push_back(static_cast<char>(pValue ? 0xF5 : 0xF4));
+			}
+
+			void putUint(uint64_t pValue)
+			{
+				putHead(0, pValue);
+			}
+
+			void putNegative(int64_t pValue)
+			{
+				putHead(1, static_cast<uint64_t>(-1 - pValue));
+			}
+
+			void putFloat(float pValue)
+			{
+				mOutput.push_back(static_cast<char>(0xFA));
+				putBigEndian(mOutput, std::bit_cast<uint32_t>(pValue));
+			}
+
+			void putString(std::string_view pValue)
+			{
+				putHead(3, pValue.size());
+				mOutput.append(pValue);
+			}
+
+			void putArrayHeader(size_t pSize)
+			{
+				putHead(4, pSize);
+			}
+
+			void putMapHeader(size_t pSize)
+			{
+				putHead(5, pSize);
+			}
+
+		private:
+			void putHead(uint8_t pMajor, uint64_t pArgument)
+			{
+				uint8_t major = static_cast<uint8_t>(pMajor << 5);
+				if (pArgument < 24)
+					mOutput.push_back(static_cast<char>(major | pArgument));
+				else if (pArgument <= 0xFF)
+				{
+					mOutput.push_back(static_cast<char>(major | 24));
+					putBigEndian(mOutput, static_cast<uint8_t>(pArgument));
+				}
+				else if (pArgument <= 0xFFFF)
+				{
+					mOutput.push_back(static_cast<char>(major | 25));
+					putBigEndian(mOutput, static_cast<uint16_t>(pArgument));
+				}
+				else if (pArgument <= 0xFFFFFFFF)
+				{
+					mOutput.push_back(static_cast<char>(major | 26));
+					putBigEndian(mOutput, static_cast<uint32_t>(pArgument));
+				}
+				else
+				{
+					mOutput.push_back(static_cast<char>(major | 27));
+					putBigEndian(mOutput, pArgument);
+				}
+			}
+		};
+
+		//
+		// one decoded header; for strings mString is the whole string,
+		// for arrays and maps mLength is the number of elements (of pairs) unless mIndefinite;
+		//
+		struct Item
+		{
+			enum class Kind : uint8_t
+			{
+				NIL,
+				BOOL,
+				UINT,
+				INT,
+				FLOAT,
+				STRING,
+				ARRAY,
+				MAP,
+				BREAK
+			};
+
+			Kind mKind{ Kind::NIL };
+			bool mBool{ false };
+			bool mIndefinite{ false };
+			uint64_t mUint{};
+			int64_t mInt{};
+			float mFloat{};
+			uint64_t mLength{};
+			std::string_view mString;
+		};
+
+		//
+		// cursor over the input shared by both readers;
+		//
+		class ByteReader
+		{
+		public:
+			ByteReader(std::string_view pData, size_t pOffset) noexcept
+				: mData(pData), mOffset(pOffset)
+			{
+			}
+
+			size_t getOffset() const noexcept
+			{
+				return mOffset;
+			}
+
+			size_t getRemaining() const noexcept
+			{
+				return mData.size() - mOffset;
+			}
+
+			bool readByte(uint8_t& pByte) noexcept
+			{
+				if (mOffset >= mData.size())
+					return false;
+				pByte = static_cast<uint8_t>(mData[mOffset++]);
+				return true;
+			}
+
+			template<typename T>
+			bool readBigEndian(T& pValue) noexcept
+			{
+				if (getRemaining() < sizeof(T))
+					return false;
+				uint64_t value{};
+				for (size_t i = 0; i < sizeof(T); ++i)
+					value = (value << 8) | static_cast<uint8_t>(mData[mOffset + i]);
+				mOffset += sizeof(T);
+				pValue = static_cast<T>(value);
+				return true;
+			}
+
+			bool readBytes(uint64_t pSize, std::string_view& pBytes) noexcept
+			{
+				if (getRemaining() < pSize)
+					return false;
+				pBytes = mData.substr(mOffset, static_cast<size_t>(pSize));
+				mOffset += static_cast<size_t>(pSize);
+				return true;
+			}
+
+		protected:
+			std::string_view mData;
+			size_t mOffset{};
+		};
+
+		class MessagePackReader : public ByteReader
+		{
+		public:
+			using ByteReader::ByteReader;
+
+			bool consumeBreak() noexcept
+			{
+				return false;
+			}
+
+			JSONStatus next(Item& pItem)
+			{
+				size_t start = mOffset;
+				JSONError truncated = makeError(JSONErrorCode::INVALID_TEXT, start);
+				uint8_t byte{};
+				if (!readByte(byte))
+					return std::unexpected(truncated);
+
+				pItem = Item();
+				bool ok = true;
+				if (byte <= 0x7F)
+				{
+					pItem.mKind = Item::Kind::UINT;
+					pItem.mUint = byte;
+				}
+				else if (byte >= 0xE0)
+				{
+					pItem.mKind = Item::Kind::INT;
+					pItem.mInt = static_cast<int8_t>(byte);
+				}
+				else if (byte <= 0x8F)
+				{
+					pItem.mKind = Item::Kind::MAP;
+					pItem.mLength = byte & 0x0F;
+				}
+				else if (byte <= 0x9F)
+				{
+					pItem.mKind = Item::Kind::ARRAY;
+					pItem.mLength = byte & 0x0F;
+				}
+				else if (byte <= 0xBF)
+				{
+					pItem.mKind = Item::Kind::STRING;
+					ok = readBytes(byte & 0x1F, pItem.mString);
+				}
+				else
+				{
+					switch (byte)
+					{
+					case 0xC0: pItem.mKind = Item::Kind::NIL; break;
+					case 0xC2: case 0xC3:
+						pItem.mKind = Item::Kind::BOOL;
+						pItem.mBool = byte == 0xC3;
+						break;
+					case 0xCA:
+					{
+						uint32_t bits{};
+						ok = readBigEndian(bits);
+						pItem.mKind = Item::Kind::FLOAT;
+						pItem.mFloat = std::bit_cast<float>(bits);
+						break;
+					}
+					case 0xCB:
+					{
+						uint64_t bits{};
+						ok = readBigEndian(bits);
+						pItem.mKind = Item::Kind::FLOAT;
+						pItem.mFloat = static_cast<float>(std::bit_cast<double>(bits));
+						break;
+					}
+					case 0xCC: ok = readUint<uint8_t>(pItem);  break;
+					case 0xCD: ok = readUint<uint16_t>(pItem); break;
+					case 0xCE: ok = readUint<uint32_t>(pItem); break;
+					case 0xCF: ok = readUint<uint64_t>(pItem); break;
+					case 0xD0: ok = readInt<int8_t, uint8_t>(pItem);	break;
+					case 0xD1: ok = readInt<int16_t, uint16_t>(pItem); break;
+					case 0xD2: ok = readInt<int32_t, uint32_t>(pItem); break;
+					case 0xD3: ok = readInt<int64_t, uint64_t>(pItem); break;
+					case 0xD9: ok = readString<uint8_t>(pItem);  break;
+					case 0xDA: ok = readString<uint16_t>(pItem); break;
+					case 0xDB: ok = readString<uint32_t>(pItem); break;
+					case 0xDC: ok = readLength<uint16_t>(pItem, Item::Kind::ARRAY); break;
+					case 0xDD: ok = readLength<uint32_t>(pItem, Item::Kind::ARRAY); break;
+					case 0xDE: ok = readLength<uint16_t>(pItem, Item::Kind::MAP);   break;
+					case 0xDF: ok = readLength<uint32_t>(pItem, Item::Kind::MAP);   break;
+					case 0xC1:
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, start));
+					default:
+						// bin, ext and fixext;
+						return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, start));
+					}
+				}
+				if (!ok)
+					return std::unexpected(truncated);
+				return {};
+			}
+
+		private:
+			template<typename T>
+			bool readUint(Item& pItem) noexcept
+			{
+				T value{};
+				pItem.mKind = Item::Kind::UINT;
+				bool ok = readBigEndian(value);
+				pItem.mUint = value;
+				return ok;
+			}
+
+			template<typename Signed, typename Unsigned>
+			bool readInt(Item& pItem) noexcept
+			{
+				Unsigned value{};
+				pItem.mKind = Item::Kind::INT;
+				bool ok = readBigEndian(value);
+				pItem.mInt = static_cast<Signed>(value);
+				return ok;
+			}
+
+			template<typename T>
+			bool readString(Item& pItem) noexcept
+			{
+				T length{};
+				pItem.mKind = Item::Kind::STRING;
+				return readBigEndian(length) && readBytes(length, pItem.mString);
+			}
+
+			template<typename T>
+			bool readLength(Item& pItem, Item::Kind pKind) noexcept
+			{
+				T length{};
+				pItem.mKind = pKind;
+				bool ok = readBigEndian(length);
+				pItem.mLength = length;
+				return ok;
+			}
+		};
+
+		class CBORReader : public ByteReader
+		{
+		public:
+			using ByteReader::ByteReader;
+
+			//
+			// consumes the "break" byte which ends an indefinite array or map;
+			//
+			bool consumeBreak() noexcept
+			{
+				if (mOffset < mData.size() && static_cast<uint8_t>(mData[mOffset]) == 0xFF)
+				{
+					++mOffset;
+					return true;
+				}
+				return false;
+			}
+
+			JSONStatus next(Item& pItem)
+			{
+				while (true)
+				{
+					size_t start = mOffset;
+					JSONError truncated = makeError(JSONErrorCode::INVALID_TEXT, start);
+					uint8_t byte{};
+					if (!readByte(byte))
+						return std::unexpected(truncated);
+
+					pItem = Item();
+					uint8_t major = byte >> 5;
+					uint8_t info = byte & 0x1F;
+					uint64_t argument{};
+					if (info == 31)
+						pItem.mIndefinite = true;
+					else if (!readArgument(info, argument))
+						return std::unexpected(truncated);
+
+					switch (major)
+					{
+					case 0:
+						pItem.mKind = Item::Kind::UINT;
+						pItem.mUint = argument;
+						break;
+					case 1:
+						if (argument > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+							return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, start));
+						pItem.mKind = Item::Kind::INT;
+						pItem.mInt = -1 - static_cast<int64_t>(argument);
+						break;
+					case 2:
+						return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, start));
+					case 3:
+						pItem.mKind = Item::Kind::STRING;
+						if (pItem.mIndefinite)
+							return readChunks(pItem, start);
+						if (!readBytes(argument, pItem.mString))
+							return std::unexpected(truncated);
+						break;
+					case 4:
+					case 5:
+						pItem.mKind = major == 4 ? Item::Kind::ARRAY : Item::Kind::MAP;
+						pItem.mLength = argument;
+						break;
+					case 6:
+						// a tag only describes the next item;
+						if (pItem.mIndefinite)
+							return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, start));
+						continue;
+					default:
+						return readSimple(pItem, info, argument, start);
+					}
+					if (pItem.mIndefinite && major < 4)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, start));
+					return {};
+				}
+			}
+
+		private:
+			bool readArgument(uint8_t pInfo, uint64_t& pArgument) noexcept
+			{
+				if (pInfo < 24)
+				{
+					pArgument = pInfo;
+					return true;
+				}
+				switch (pInfo)
+				{
+				case 24: { uint8_t value{};  bool ok = readBigEndian(value); pArgument = value; return ok; }
+				case 25: { uint16_t value{}; bool ok = readBigEndian(value); pArgument = value; return ok; }
+				case 26: { uint32_t value{}; bool ok = readBigEndian(value); pArgument = value; return ok; }
+				case 27: return readBigEndian(pArgument);
+				default: return false;
+				}
+			}
+
+			//
+			// major type 7: false, true, null, undefined, floats and "break";
+			//
+			JSONStatus readSimple(Item& pItem, uint8_t pInfo, uint64_t pArgument, size_t pStart) noexcept
+			{
+				switch (pInfo)
+				{
+				case 20: case 21:
+					pItem.mKind = Item::Kind::BOOL;
+					pItem.mBool = pInfo == 21;
+					return {};
+				case 22: case 23:
+					pItem.mKind = Item::Kind::NIL;
+					return {};
+				case 25:
+					pItem.mKind = Item::Kind::FLOAT;
+					pItem.mFloat = halfToFloat(static_cast<uint16_t>(pArgument));
+					return {};
+				case 26:
+					pItem.mKind = Item::Kind::FLOAT;
+					pItem.mFloat = std::bit_cast<float>(static_cast<uint32_t>(pArgument));
+					return {};
+				case 27:
+					pItem.mKind = Item::Kind::FLOAT;
+					pItem.mFloat = static_cast<float>(std::bit_cast<double>(pArgument));
+					return {};
+				case 31:
+					pItem.mKind = Item::Kind::BREAK;
+					return {};
+				default:
+					return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pStart));
+				}
+			}
+
+			//
+			// an indefinite string is a sequence of definite strings ended by "break";
+			//
+			JSONStatus readChunks(Item& pItem, size_t pStart)
+			{
+				mChunks.clear();
+				while (!consumeBreak())
+				{
+					uint8_t byte{};
+					uint64_t length{};
+					std::string_view chunk;
+					if (!readByte(byte) || (byte >> 5) != 3 || (byte & 0x1F) == 31 ||
+						!readArgument(byte & 0x1F, length) || !readBytes(length, chunk))
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pStart));
+					mChunks.append(chunk);
+				}
+				pItem.mString = mChunks;
+				return {};
+			}
+
+			static float halfToFloat(uint16_t pHalf) noexcept
+			{
+				uint32_t sign = static_cast<uint32_t>(pHalf & 0x8000) << 16;
+				uint32_t exponent = (pHalf >> 10) & 0x1F;
+				uint32_t mantissa = pHalf & 0x3FF;
+				if (exponent == 0)
+				{
+					float value = std::ldexp(static_cast<float>(mantissa), -24);
+					return sign != 0 ? -value : value;
+				}
+				if (exponent == 31)
+					return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+				return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+			}
+
+		private:
+			std::string mChunks;
+		};
+	}
+
+	void BinaryCodec::encode(const JSONObject& pObject, std::string& pOutput, BinaryFormat pFormat)
+	{
+		if (pFormat == BinaryFormat::MESSAGE_PACK)
+		{
+			MessagePackWriter writer{ pOutput };
+			writeObject(pObject, writer);
+		}
+		else
+		{
+			CBORWriter writer{ pOutput };
+			writeObject(pObject, writer);
+		}
+	}
+
+	void BinaryCodec::encode(const JSONValue& pValue, std::string& pOutput, BinaryFormat pFormat)
+	{
+		if (pFormat == BinaryFormat::MESSAGE_PACK)
+		{
+			MessagePackWriter writer{ pOutput };
+			writeValue(pValue, writer);
+		}
+		else
+		{
+			CBORWriter writer{ pOutput };
+			writeValue(pValue, writer);
+		}
+	}
+
+	JSONResult<JSONValue> BinaryCodec::decode(std::string_view pData, size_t& pOffset, BinaryFormat pFormat)
+	{
+		if (pFormat == BinaryFormat::MESSAGE_PACK)
+			return decodeWith<MessagePackReader>(pData, pOffset);
+		return decodeWith<CBORReader>(pData, pOffset);
+	}
+
+	JSONResult<JSONObject> BinaryCodec::decodeObject(std::string_view pData, size_t& pOffset, BinaryFormat pFormat)
+	{
+		if (pFormat == BinaryFormat::MESSAGE_PACK)
+			return decodeObjectWith<MessagePackReader>(pData, pOffset);
+		return decodeObjectWith<CBORReader>(pData, pOffset);
+	}
+
+	JSONResult<JSONValue> BinaryCodec::decode(std::string_view pData, BinaryFormat pFormat)
+	{
+		size_t offset{};
+		JSONResult<JSONValue> value = decode(pData, offset, pFormat);
+		if (value && offset != pData.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, offset));
+		return value;
+	}
+
+	JSONResult<JSONObject> BinaryCodec::decodeObject(std::string_view pData, BinaryFormat pFormat)
+	{
+		size_t offset{};
+		JSONResult<JSONObject> object = decodeObject(pData, offset, pFormat);
+		if (object && offset != pData.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, offset));
+		return object;
+	}
+
+	template<typename Reader>
+	JSONResult<JSONValue> BinaryCodec::decodeWith(std::string_view pData, size_t& pOffset)
+	{
+		Reader reader(pData, pOffset);
+		JSONValue value;
+		if (JSONStatus status = readValue(reader, value, nullptr, 0); !status)
+			return std::unexpected(status.error());
+		pOffset = reader.getOffset();
+		return value;
+	}
+
+	template<typename Reader>
+	JSONResult<JSONObject> BinaryCodec::decodeObjectWith(std::string_view pData, size_t& pOffset)
+	{
+		Reader reader(pData, pOffset);
+		JSONValue value;
+		JSONObject object;
+		if (JSONStatus status = readValue(reader, value, &object, 0); !status)
+			return std::unexpected(status.error());
+		pOffset = reader.getOffset();
+		return object;
+	}
+
+	template<typename Writer>
+	void BinaryCodec::writeValue(const JSONValue& pValue, Writer& pWriter)
+	{
+		std::visit([&](const auto& pContained)
+			{
+				using T = std::decay_t<decltype(pContained)>;
+				if constexpr (std::is_same_v<T, bool>)
+					pWriter.putBool(pContained);
+				else if constexpr (std::is_same_v<T, uint32_t>)
+					pWriter.putUint(pContained);
+				else if constexpr (std::is_same_v<T, int32_t>)
+				{
+					if (pContained >= 0)
+						pWriter.putUint(static_cast<uint64_t>(pContained));
+					else
+						pWriter.putNegative(pContained);
+				}
+				else if constexpr (std::is_same_v<T, float>)
+					pWriter.putFloat(pContained);
+				else if constexpr (std::is_same_v<T, std::string>)
+					pWriter.putString(pContained);
+				else if constexpr (std::is_same_v<T, std::vector<JSONValue>>)
+					writeArray(pContained, pWriter);
+				else if constexpr (std::is_same_v<T, std::vector<std::vector<JSONValue>>>)
+				{
+					pWriter.putArrayHeader(pContained.size());
+					for (auto& row : pContained)
+						writeArray(row, pWriter);
+				}
+				else if constexpr (std::is_same_v<T, std::shared_ptr<const JSONObject>>)
+				{
+					if (pContained != nullptr)
+						writeObject(*pContained, pWriter);
+					else
+						pWriter.putNull();
+				}
+				else
+					pWriter.putNull();
+			}, pValue.mValue);
+	}
+
+	template<typename Writer>
+	void BinaryCodec::writeObject(const JSONObject& pObject, Writer& pWriter)
+	{
+		auto& storage = pObject.getStorage();
+		pWriter.putMapHeader(storage.size());
+		for (auto& [key, value] : storage)
+		{
+			pWriter.putString(key);
+			writeValue(value, pWriter);
+		}
+	}
+
+	template<typename Writer>
+	void BinaryCodec::writeArray(const std::vector<JSONValue>& pArray, Writer& pWriter)
+	{
+		pWriter.putArrayHeader(pArray.size());
+		for (auto& element : pArray)
+			writeValue(element, pWriter);
+	}
+
+	template<typename Reader>
+	JSONStatus BinaryCodec::readValue(Reader& pReader, JSONValue& pValue, JSONObject* pRootObject, uint32_t pDepth)
+	{
+		size_t start = pReader.getOffset();
+		Item item;
+		if (JSONStatus status = pReader.next(item); !status)
+			return status;
+		if (pRootObject != nullptr && item.mKind != Item::Kind::MAP)
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, start));
+
+		switch (item.mKind)
+		{
+		case Item::Kind::NIL:
+			pValue = JSONValue(nullptr);
+			return {};
+		case Item::Kind::BOOL:
+			pValue = JSONValue(item.mBool);
+			return {};
+		case Item::Kind::INT:
+			if (item.mInt < 0)
+			{
+				if (item.mInt < std::numeric_limits<int32_t>::min())
+					return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, start));
+				pValue = JSONValue(static_cast<int32_t>(item.mInt));
+				return {};
+			}
+			item.mUint = static_cast<uint64_t>(item.mInt);
+			[[fallthrough]];
+		case Item::Kind::UINT:
+			if (item.mUint > std::numeric_limits<uint32_t>::max())
+				return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, start));
+			pValue = JSONValue(static_cast<uint32_t>(item.mUint));
+			return {};
+		case Item::Kind::FLOAT:
+			pValue = JSONValue(item.mFloat);
+			return {};
+		case Item::Kind::STRING:
+			pValue = JSONValue(std::string(item.mString));
+			return {};
+		case Item::Kind::BREAK:
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, start));
+		default:
+			break;
+		}
+
+		if (pDepth >= MAX_DEPTH)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, start));
+		auto hasNext = [&](uint64_t pIndex)
+			{
+				return item.mIndefinite ? !pReader.consumeBreak() : pIndex < item.mLength;
+			};
+
+		if (item.mKind == Item::Kind::ARRAY)
+		{
+			std::vector<JSONValue> array;
+			// every element takes at least one byte, thus a forged length cannot reserve more than the input;
+			if (!item.mIndefinite)
+				array.reserve(static_cast<size_t>(std::min<uint64_t>(item.mLength, pReader.getRemaining())));
+			for (uint64_t i = 0; hasNext(i); ++i)
+			{
+				if (JSONStatus status = readValue(pReader, array.emplace_back(), nullptr, pDepth + 1); !status)
+					return status;
+			}
+			pValue = JSONValue(std::move(array));
+			return {};
+		}
+
+		JSONObject object;
+		std::string key;
+		for (uint64_t i = 0; hasNext(i); ++i)
+		{
+			size_t keyStart = pReader.getOffset();
+			Item keyItem;
+			if (JSONStatus status = pReader.next(keyItem); !status)
+				return status;
+			if (keyItem.mKind != Item::Kind::STRING)
+				return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, keyStart));
+			key.assign(keyItem.mString);
+
+			JSONValue value;
+			if (JSONStatus status = readValue(pReader, value, nullptr, pDepth + 1); !status)
+				return status;
+			object.addObject(key, std::move(value));
+		}
+		if (pRootObject != nullptr)
+			*pRootObject = std::move(object);
+		else
+			pValue = JSONValue(std::move(object));
+		return {};
+	}
+}
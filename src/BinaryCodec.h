@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	enum class BinaryFormat : uint8_t
+	{
+		MESSAGE_PACK,
+		CBOR
+	};
+
+	//
+	// MessagePack and CBOR encoder/decoder working directly on JSONValue/JSONObject;
+	// numbers are written as they are stored (no formatting) and strings without escaping;
+	// the output is appended to the passed buffer (bytes in std::string, like JSONSerializer),
+	// thus one buffer can be reused for many documents and many documents can go into one buffer;
+	//
+	// values are written in the smallest form: non-negative integers as unsigned, floats as float32,
+	// objects as maps, nested arrays as arrays of arrays;
+	// the decoder accepts every integer and float width, CBOR tags (skipped) and indefinite lengths;
+	// integers which dont fit into int32/uint32 give NUMBER_OUT_OF_RANGE, binary strings and
+	// extension types give TYPE_MISMATCH, truncated input gives INVALID_TEXT;
+	//
+	// std::string buffer;
+	// BinaryCodec::encode(object, buffer, BinaryFormat::CBOR);
+	// JSONResult<JSONObject> copy = BinaryCodec::decodeObject(buffer, BinaryFormat::CBOR);
+	//
+	class BinaryCodec
+	{
+	public:
+		//
+		// nesting deeper than this is rejected by the decoder (INVALID_TEXT);
+		//
+		static constexpr uint32_t MAX_DEPTH = 1024;
+
+	public:
+		static void encode(const JSONObject& pObject, std::string& pOutput, BinaryFormat pFormat);
+		static void encode(const JSONValue& pValue, std::string& pOutput, BinaryFormat pFormat);
+
+		//
+		// decodes one value starting at pOffset and moves pOffset after it,
+		// thus values which follow each other in one buffer are read one by one;
+		// error positions are offsets into pData;
+		//
+		static JSONResult<JSONValue> decode(std::string_view pData, size_t& pOffset, BinaryFormat pFormat);
+		static JSONResult<JSONObject> decodeObject(std::string_view pData, size_t& pOffset, BinaryFormat pFormat);
+
+		//
+		// decodes a buffer which holds exactly one value;
+		//
+		static JSONResult<JSONValue> decode(std::string_view pData, BinaryFormat pFormat);
+		static JSONResult<JSONObject> decodeObject(std::string_view pData, BinaryFormat pFormat);
+
+	private:
+		template<typename Writer>
+		static void writeValue(const JSONValue& pValue, Writer& pWriter);
+		template<typename Writer>
+		static void writeObject(const JSONObject& pObject, Writer& pWriter);
+		template<typename Writer>
+		static void writeArray(const std::vector<JSONValue>& pArray, Writer& pWriter);
+
+		//
+		// reads one value into pValue; if pRootObject is set, the value must be a map
+		// and it is read into pRootObject instead;
+		//
+		template<typename Reader>
+		static JSONStatus readValue(Reader& pReader, JSONValue& pValue, JSONObject* pRootObject, uint32_t pDepth);
+		template<typename Reader>
+		static JSONResult<JSONValue> decodeWith(std::string_view pData, size_t& pOffset);
+		template<typename Reader>
+		static JSONResult<JSONObject> decodeObjectWith(std::string_view pData, size_t& pOffset);
+	};
+}
@@ -0,0 +1,472 @@
+#include "BulkLoader.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#define TNG_HAS_IO_URING 1
+#endif
+
+namespace tng
+{
+	namespace
+	{
+		JSONResult<JSONObject> parseLoaded(std::string_view pText, const ParseOptions& pOptions)
+		{
+			try
+			{
+				return tng::parse(pText, pOptions);
+			}
+			catch (const std::exception&)
+			{
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+			}
+		}
+
+		//
+		// counts parse tasks in flight and lets the loader wait for them;
+		//
+		struct TaskCounter
+		{
+			std::mutex mMutex;
+			std::condition_variable mCondition;
+			size_t mRemaining{};
+
+			void add() noexcept
+			{
+				std::lock_guard lock(mMutex);
+				mRemaining++;
+			}
+
+			void finish() noexcept
+			{
+				std::lock_guard lock(mMutex);
+				if (--mRemaining == 0)
+					mCondition.notify_all();
+			}
+
+			void wait()
+			{
+				std::unique_lock lock(mMutex);
+				mCondition.wait(lock, [&]() { return mRemaining == 0; });
+			}
+		};
+
+#if defined(TNG_HAS_IO_URING)
+		//
+		// minimal io_uring: one submission and one completion ring mapped from the kernel;
+		// only the calling thread touches it;
+		//
+		class IoUring
+		{
+		public:
+			IoUring() = default;
+			IoUring(const IoUring&) = delete;
+			IoUring& operator=(const IoUring&) = delete;
+
+			~IoUring()
+			{
+				if (mSqes != nullptr)
+					::munmap(mSqes, mSqesSize);
+				if (mCqRing != nullptr && mCqRing != mSqRing)
+					::munmap(mCqRing, mCqRingSize);
+				if (mSqRing != nullptr)
+					::munmap(mSqRing, mSqRingSize);
+				if (mDescriptor >= 0)
+					::close(mDescriptor);
+			}
+
+			bool setup(uint32_t pEntries) noexcept
+			{
+				io_uring_params params{};
+				mDescriptor = static_cast<int>(::syscall(__NR_io_uring_setup, pEntries, &params));
+				if (mDescriptor < 0)
+					return false;
+
+				mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+				mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+				bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+				if (singleMapping)
+					mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+
+				mSqRing = map(mSqRingSize, IORING_OFF_SQ_RING);
+				if (mSqRing == nullptr)
+					return false;
+				mCqRing = singleMapping ? mSqRing : map(mCqRingSize, IORING_OFF_CQ_RING);
+				mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+				mSqes = static_cast<io_uring_sqe*>(map(mSqesSize, IORING_OFF_SQES));
+				if (mCqRing == nullptr || mSqes == nullptr)
+					return false;
+
+				char* sq = static_cast<char*>(mSqRing);
+				char* cq = static_cast<char*>(mCqRing);
+				mSqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+				mSqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+				mSqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+				mSqEntries = params.sq_entries;
+				mSqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+				mCqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+				mCqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+				mCqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+				mCqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+				return true;
+			}
+
+			//
+			// returns true if every passed operation is supported by the kernel;
+			//
+			bool supports(std::initializer_list<uint8_t> pOperations) const noexcept
+			{
+				constexpr size_t maxOperations = 256;
+				alignas(io_uring_probe) char storage[sizeof(io_uring_probe) + maxOperations * sizeof(io_uring_probe_op)]{};
+				io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage);
+				if (::syscall(__NR_io_uring_register, mDescriptor, IORING_REGISTER_PROBE, probe, maxOperations) < 0)
+					return false;
+				for (uint8_t operation : pOperations)
+				{
+					if (operation > probe->last_op || (probe->ops[operation].flags & IO_URING_OP_SUPPORTED) == 0)
+						return false;
+				}
+				return true;
+			}
+
+			//
+			// returns a cleared submission entry or nullptr if the ring is full;
+			//
+			io_uring_sqe* getSqe() noexcept
+			{
+				uint32_t head = std::atomic_ref(*mSqHead).load(std::memory_order_acquire);
+				if (mSqLocalTail - head >= mSqEntries)
+					return nullptr;
+				uint32_t index = mSqLocalTail & mSqMask;
+				mSqArray[index] = index;
+				mSqLocalTail++;
+				io_uring_sqe* sqe = &mSqes[index];
+				std::memset(sqe, 0, sizeof(io_uring_sqe));
+				return sqe;
+			}
+
+			//
+			// submits queued entries and waits for at least pMinComplete completions;
+			//
+			bool submitAndWait(uint32_t pMinComplete) noexcept
+			{
+				std::atomic_ref(*mSqTail).store(mSqLocalTail, std::memory_order_release);
+				uint32_t toSubmit = mSqLocalTail - mSqSubmitted;
+				while (true)
+				{
+					long result = ::syscall(__NR_io_uring_enter, mDescriptor, toSubmit, pMinComplete,
+											IORING_ENTER_GETEVENTS, nullptr, 0);
+					if (result >= 0)
+					{
+						mSqSubmitted += static_cast<uint32_t>(result);
+						return true;
+					}
+					if (errno != EINTR)
+						return errno == EAGAIN || errno == EBUSY;
+				}
+			}
+
+			//
+			// calls pFunction(userData, result) for every available completion;
+			//
+			template<typename Function>
+			void forEachCompletion(Function&& pFunction)
+			{
+				uint32_t head = *mCqHead;
+				uint32_t tail = std::atomic_ref(*mCqTail).load(std::memory_order_acquire);
+				while (head != tail)
+				{
+					// consumed before pFunction runs, thus a throwing pFunction doesnt see it twice;
+					const io_uring_cqe& cqe = mCqes[head & mCqMask];
+					uint64_t userData = cqe.user_data;
+					int32_t result = cqe.res;
+					std::atomic_ref(*mCqHead).store(++head, std::memory_order_release);
+					pFunction(userData, result);
+				}
+			}
+
+		private:
+			void* map(size_t pSize, uint64_t pOffset) noexcept
+			{
+				void* mapping = ::mmap(nullptr, pSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+									   mDescriptor, static_cast<off_t>(pOffset));
+				return mapping == MAP_FAILED ? nullptr : mapping;
+			}
+
+		private:
+			int mDescriptor{ -1 };
+			void* mSqRing{ nullptr };
+			void* mCqRing{ nullptr };
+			io_uring_sqe* mSqes{ nullptr };
+			size_t mSqRingSize{};
+			size_t mCqRingSize{};
+			size_t mSqesSize{};
+			uint32_t* mSqHead{ nullptr };
+			uint32_t* mSqTail{ nullptr };
+			uint32_t* mSqArray{ nullptr };
+			uint32_t mSqMask{};
+			uint32_t mSqEntries{};
+			uint32_t mSqLocalTail{};
+			uint32_t mSqSubmitted{};
+			uint32_t* mCqHead{ nullptr };
+			uint32_t* mCqTail{ nullptr };
+			io_uring_cqe* mCqes{ nullptr };
+			uint32_t mCqMask{};
+		};
+
+		//
+		// a file between its open and the end of its reads;
+		//
+		struct PendingFile
+		{
+			int mDescriptor{ -1 };
+			std::string mBuffer;
+			size_t mReadSize{};
+			// an operation of the file is in the ring, the kernel may write into mBuffer;
+			bool mQueued{ false };
+		};
+
+		//
+		// the lowest bit of user_data tells the operation, the rest is the index of the file;
+		//
+		constexpr uint64_t OPEN_OPERATION = 0;
+		constexpr uint64_t READ_OPERATION = 1;
+		// user_data of cancel requests, their own completions are ignored;
+		constexpr uint64_t CANCEL_OPERATION = ~uint64_t{};
+#endif
+	}
+
+	BulkLoader::BulkLoader(const BulkLoadOptions& pOptions)
+		: mOptions(pOptions)
+	{
+		mOptions.mQueueDepth = std::clamp<uint32_t>(mOptions.mQueueDepth, 1, 4096);
+		mOptions.mInitialReadSize = std::max<size_t>(mOptions.mInitialReadSize, 512);
+	}
+
+	std::vector<JSONResult<JSONObject>> BulkLoader::load(std::span<const std::filesystem::path> pPaths)
+	{
+		ThreadPool& pool = mOptions.mPool != nullptr ? *mOptions.mPool : ThreadPool::getDefault();
+		std::vector<JSONResult<JSONObject>> results(pPaths.size(), std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR }));
+		if (pPaths.empty())
+			return results;
+		if (!mOptions.mUseIoUring || !loadWithIoUring(pPaths, pool, results))
+			loadWithThreadPool(pPaths, pool, results);
+		return results;
+	}
+
+	bool BulkLoader::isIoUringAvailable() noexcept
+	{
+#if defined(TNG_HAS_IO_URING)
+		static const bool available = []()
+			{
+				IoUring ring;
+				return ring.setup(2) && ring.supports({ IORING_OP_OPENAT, IORING_OP_READ });
+			}();
+		return available;
+#else
+		return false;
+#endif
+	}
+
+	bool BulkLoader::loadWithIoUring(std::span<const std::filesystem::path> pPaths, ThreadPool& pPool,
+									 std::vector<JSONResult<JSONObject>>& pResults)
+	{
+#if defined(TNG_HAS_IO_URING)
+		if (!isIoUringAvailable())
+			return false;
+		IoUring ring;
+		if (!ring.setup(mOptions.mQueueDepth))
+			return false;
+
+		// every file in flight has at most one operation queued, thus the ring never overflows;
+		std::vector<PendingFile> files(pPaths.size());
+		TaskCounter parseTasks;
+		size_t nextFile{};
+		size_t inFlight{};
+		size_t finished{};
+
+		auto queueRead = [&](size_t pIndex)
+			{
+				PendingFile& file = files[pIndex];
+				io_uring_sqe* sqe = ring.getSqe();
+				sqe->opcode = IORING_OP_READ;
+				sqe->fd = file.mDescriptor;
+				sqe->addr = reinterpret_cast<uint64_t>(file.mBuffer.data() + file.mReadSize);
+				// the length field is 32-bit, a larger remainder is read in several steps;
+				sqe->len = static_cast<uint32_t>(std::min<size_t>(file.mBuffer.size() - file.mReadSize, size_t{ 1 } << 30));
+				sqe->off = file.mReadSize;
+				sqe->user_data = (pIndex << 1) | READ_OPERATION;
+				file.mQueued = true;
+			};
+
+		auto finishFile = [&](size_t pIndex, bool pSuccess)
+			{
+				PendingFile& file = files[pIndex];
+				if (file.mDescriptor >= 0)
+					::close(file.mDescriptor);
+				file.mDescriptor = -1;
+				inFlight--;
+				finished++;
+				if (!pSuccess)
+				{
+					std::string().swap(file.mBuffer);
+					return;
+				}
+
+				file.mBuffer.resize(file.mReadSize);
+				parseTasks.add();
+				pPool.submit([&pResults, &parseTasks, &options = mOptions.mParseOptions, pIndex, text = std::move(file.mBuffer)]()
+					{
+						pResults[pIndex] = parseLoaded(text, options);
+						parseTasks.finish();
+					});
+			};
+
+		auto onCompletion = [&](uint64_t pUserData, int32_t pResult)
+			{
+				size_t index = static_cast<size_t>(pUserData >> 1);
+				PendingFile& file = files[index];
+				file.mQueued = false;
+				if ((pUserData & 1) == OPEN_OPERATION)
+				{
+					if (pResult < 0)
+						return finishFile(index, false);
+					file.mDescriptor = pResult;
+					file.mBuffer.resize(mOptions.mInitialReadSize);
+					return queueRead(index);
+				}
+
+				if (pResult == -EINTR || pResult == -EAGAIN)
+					return queueRead(index);
+				if (pResult < 0)
+					return finishFile(index, false);
+				if (pResult == 0)
+					return finishFile(index, true);
+
+				// a short read is not the end for pipes and procfs, thus reading goes on until 0;
+				file.mReadSize += static_cast<size_t>(pResult);
+				if (file.mReadSize == file.mBuffer.size())
+					file.mBuffer.resize(file.mBuffer.size() * 2);
+				queueRead(index);
+			};
+
+		//
+		// cancels the operations in flight and waits until each of them completes, since until then
+		// the kernel may write into their buffers; if the ring cant even do that, the buffers are
+		// leaked rather than freed under the kernel; the descriptors are closed in both cases;
+		//
+		auto abandon = [&]()
+			{
+				size_t queued{};
+				for (size_t i = 0; i < nextFile; ++i)
+				{
+					if (!files[i].mQueued)
+						continue;
+					queued++;
+					io_uring_sqe* sqe = ring.getSqe();
+					// an operation which was not cancelled just completes on its own;
+					if (sqe == nullptr)
+						continue;
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->addr = (static_cast<uint64_t>(i) << 1) | (files[i].mDescriptor >= 0 ? READ_OPERATION : OPEN_OPERATION);
+					sqe->user_data = CANCEL_OPERATION;
+				}
+
+				bool drained = true;
+				while (drained && queued != 0)
+				{
+					drained = ring.submitAndWait(1);
+					ring.forEachCompletion([&](uint64_t pUserData, int32_t pResult)
+						{
+							if (pUserData == CANCEL_OPERATION)
+								return;
+							PendingFile& file = files[static_cast<size_t>(pUserData >> 1)];
+							if ((pUserData & 1) == OPEN_OPERATION && pResult >= 0)
+								file.mDescriptor = pResult;
+							file.mQueued = false;
+							queued--;
+						});
+				}
+
+				for (PendingFile& file : files)
+				{
+					if (file.mDescriptor >= 0)
+						::close(file.mDescriptor);
+					file.mDescriptor = -1;
+				}
+				if (queued != 0)
+					static_cast<void>(new std::vector<PendingFile>(std::move(files)));
+				parseTasks.wait();
+			};
+
+		try
+		{
+			while (finished < pPaths.size())
+			{
+				while (inFlight < mOptions.mQueueDepth && nextFile < pPaths.size())
+				{
+					io_uring_sqe* sqe = ring.getSqe();
+					if (sqe == nullptr)
+						break;
+					sqe->opcode = IORING_OP_OPENAT;
+					sqe->fd = AT_FDCWD;
+					sqe->addr = reinterpret_cast<uint64_t>(pPaths[nextFile].c_str());
+					sqe->open_flags = O_RDONLY | O_CLOEXEC;
+					sqe->user_data = (static_cast<uint64_t>(nextFile) << 1) | OPEN_OPERATION;
+					files[nextFile].mQueued = true;
+					nextFile++;
+					inFlight++;
+				}
+
+				if (!ring.submitAndWait(1))
+				{
+					// the ring broke down mid-way: every file is loaded again by the fallback;
+					abandon();
+					return false;
+				}
+				ring.forEachCompletion(onCompletion);
+			}
+		}
+		catch (...)
+		{
+			// a buffer failed to grow or a parse task failed to be queued;
+			abandon();
+			throw;
+		}
+
+		parseTasks.wait();
+		return true;
+#else
+		(void)pPaths;
+		(void)pPool;
+		(void)pResults;
+		return false;
+#endif
+	}
+
+	void BulkLoader::loadWithThreadPool(std::span<const std::filesystem::path> pPaths, ThreadPool& pPool,
+										std::vector<JSONResult<JSONObject>>& pResults)
+	{
+		pPool.parallelFor(pPaths.size(), [&](size_t pBegin, size_t pEnd)
+			{
+				for (size_t i = pBegin; i < pEnd; ++i)
+				{
+					JSONResult<FileBuffer> file = FileBuffer::open(pPaths[i]);
+					if (!file)
+						pResults[i] = std::unexpected(file.error());
+					else
+						pResults[i] = parseLoaded(file->getView(), mOptions.mParseOptions);
+				}
+			});
+	}
+}
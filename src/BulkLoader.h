@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// options of BulkLoader;
+	//
+	struct BulkLoadOptions
+	{
+		//
+		// maximum number of files, which are opened/read at once (io_uring queue depth);
+		//
+		uint32_t mQueueDepth{ 128 };
+
+		//
+		// size of the first read of every file; larger files are read further
+		// in steps of doubling size, thus no stat call is needed;
+		//
+		size_t mInitialReadSize{ 16 * 1024 };
+
+		//
+		// false - always use blocking reads on the thread pool;
+		//
+		bool mUseIoUring{ true };
+
+		//
+		// pool of parser workers (and of readers in the fallback); nullptr means ThreadPool::getDefault();
+		//
+		ThreadPool* mPool{ nullptr };
+
+		ParseOptions mParseOptions{};
+	};
+
+	//
+	// loads and parses many files at once;
+	// on Linux reads are submitted through io_uring (raw syscalls, no liburing) and every file
+	// is handed to a parse task as soon as its read completes;
+	// if io_uring is not available (old kernel, seccomp, disabled by sysctl), every file
+	// is read and parsed by a task of the thread pool;
+	//
+	class BulkLoader
+	{
+	public:
+		explicit BulkLoader(const BulkLoadOptions& pOptions = {});
+
+		//
+		// returns parsed files, result i belongs to pPaths[i];
+		// a file which couldnt be opened or read gets JSONErrorCode::FILE_ERROR;
+		// waits for parse tasks, thus it must not be called from a task of the same pool;
+		//
+		std::vector<JSONResult<JSONObject>> load(std::span<const std::filesystem::path> pPaths);
+
+		//
+		// returns true if the kernel supports io_uring with the operations used by the loader;
+		//
+		static bool isIoUringAvailable() noexcept;
+
+	private:
+		//
+		// returns false if the ring couldnt be created, nothing is loaded then;
+		//
+		bool loadWithIoUring(std::span<const std::filesystem::path> pPaths, ThreadPool& pPool,
+							 std::vector<JSONResult<JSONObject>>& pResults);
+
+		void loadWithThreadPool(std::span<const std::filesystem::path> pPaths, ThreadPool& pPool,
+								std::vector<JSONResult<JSONObject>>& pResults);
+
+	private:
+		BulkLoadOptions mOptions;
+	};
+}
@@ -0,0 +1,210 @@
+#include "DirectoryWatcher.h"
+
+#include <unordered_set>
+
+#if defined(__linux__)
+	#include <sys/eventfd.h>
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+namespace tng
+{
+	DirectoryWatcher::DirectoryWatcher(const std::filesystem::path& pDirectory, const WatchOptions& pOptions)
+		: mDirectory(pDirectory)
+		, mOptions(pOptions)
+	{
+	}
+
+	DirectoryWatcher::~DirectoryWatcher()
+	{
+		stop();
+	}
+
+	JSONStatus DirectoryWatcher::start()
+	{
+		stop();
+#if defined(__linux__)
+		// the watch is added before the initial scan, thus no change in between is lost;
+		mNotifyDescriptor = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+		mStopDescriptor = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		if (mNotifyDescriptor < 0 || mStopDescriptor < 0 ||
+			::inotify_add_watch(mNotifyDescriptor, mDirectory.c_str(),
+								IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF) < 0)
+		{
+			stop();
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		}
+#endif
+
+		std::error_code errorCode;
+		for (auto& entry : std::filesystem::directory_iterator(mDirectory, errorCode))
+		{
+			std::string fileName = entry.path().filename().string();
+			if (entry.is_regular_file(errorCode) && isWatched(fileName))
+				reload(fileName);
+		}
+		if (errorCode)
+		{
+			stop();
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		}
+
+#if defined(__linux__)
+		mThread = std::thread(&DirectoryWatcher::watchLoop, this);
+		return {};
+#else
+		return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+#endif
+	}
+
+	void DirectoryWatcher::stop()
+	{
+#if defined(__linux__)
+		if (mThread.joinable())
+		{
+			uint64_t value = 1;
+			[[maybe_unused]] ssize_t written = ::write(mStopDescriptor, &value, sizeof(value));
+			mThread.join();
+		}
+		if (mNotifyDescriptor >= 0)
+			::close(mNotifyDescriptor);
+		if (mStopDescriptor >= 0)
+			::close(mStopDescriptor);
+		mNotifyDescriptor = -1;
+		mStopDescriptor = -1;
+#endif
+	}
+
+	DirectoryWatcher::Document DirectoryWatcher::get(std::string_view pFileName) const
+	{
+		std::shared_ptr<const SlotMap> slots = mSlots.load(std::memory_order_acquire);
+		auto it = slots->find(pFileName);
+		if (it == slots->end())
+			return nullptr;
+		return it->second->mDocument.load(std::memory_order_acquire);
+	}
+
+	void DirectoryWatcher::reload(const std::string& pFileName)
+	{
+		JSONResult<Document> document = std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		std::error_code errorCode;
+		std::filesystem::path path = mDirectory / pFileName;
+		if (!std::filesystem::exists(path, errorCode))
+		{
+			// the file was removed;
+			document = nullptr;
+			getSlot(pFileName).mDocument.store(nullptr, std::memory_order_release);
+		}
+		else
+		{
+			JSONResult<FileBuffer> file = FileBuffer::open(path);
+			if (file)
+			{
+				try
+				{
+					JSONResult<JSONObject> object = tng::parse(file->getView(), mOptions.mParseOptions);
+					if (object)
+						document = std::make_shared<const JSONObject>(std::move(*object));
+					else
+						document = std::unexpected(object.error());
+				}
+				catch (const std::exception&)
+				{
+					document = std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+				}
+			}
+			// a broken file (often a half-written one) doesnt replace the last good document;
+			if (document)
+				getSlot(pFileName).mDocument.store(*document, std::memory_order_release);
+		}
+
+		if (mOptions.mOnChange)
+			mOptions.mOnChange(pFileName, document);
+	}
+
+	bool DirectoryWatcher::isWatched(std::string_view pFileName) const
+	{
+		return mOptions.mExtension.empty() || pFileName.ends_with(mOptions.mExtension);
+	}
+
+	DirectoryWatcher::Slot& DirectoryWatcher::getSlot(const std::string& pFileName)
+	{
+		std::shared_ptr<const SlotMap> slots = mSlots.load(std::memory_order_acquire);
+		auto it = slots->find(pFileName);
+		if (it != slots->end())
+			return *it->second;
+		// readers keep using the old map until the new one is published;
+		std::shared_ptr<SlotMap> updated = std::make_shared<SlotMap>(*slots);
+		std::shared_ptr<Slot>& slot = (*updated)[pFileName];
+		slot = std::make_shared<Slot>();
+		Slot& result = *slot;
+		mSlots.store(std::move(updated), std::memory_order_release);
+		return result;
+	}
+
+	void DirectoryWatcher::watchLoop()
+	{
+#if defined(__linux__)
+		alignas(inotify_event) char buffer[16 * 1024];
+		std::unordered_set<std::string> changed;
+		while (true)
+		{
+			pollfd descriptors[2] = { { mNotifyDescriptor, POLLIN, 0 }, { mStopDescriptor, POLLIN, 0 } };
+			if (::poll(descriptors, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return;
+			}
+			if (descriptors[1].revents != 0)
+				return;
+
+			// one save often produces several events, thus every file of the batch is parsed once;
+			changed.clear();
+			bool directoryRemoved = false;
+			bool overflow = false;
+			while (true)
+			{
+				ssize_t length = ::read(mNotifyDescriptor, buffer, sizeof(buffer));
+				if (length <= 0)
+					break;
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+					if ((event->mask & IN_Q_OVERFLOW) != 0)
+						overflow = true;
+					else if ((event->mask & (IN_DELETE_SELF | IN_IGNORED)) != 0)
+						directoryRemoved = true;
+					else if (event->len != 0 && isWatched(event->name))
+						changed.insert(event->name);
+				}
+			}
+
+			if (overflow)
+			{
+				// the kernel dropped events, thus which files changed is unknown: every file
+				// of the directory and every known one (it may have been removed) is reloaded;
+				std::error_code errorCode;
+				for (auto& entry : std::filesystem::directory_iterator(mDirectory, errorCode))
+				{
+					std::string fileName = entry.path().filename().string();
+					if (entry.is_regular_file(errorCode) && isWatched(fileName))
+						changed.insert(std::move(fileName));
+				}
+				std::shared_ptr<const SlotMap> slots = mSlots.load(std::memory_order_acquire);
+				for (const auto& [fileName, slot] : *slots)
+					changed.insert(fileName);
+			}
+
+			for (const std::string& fileName : changed)
+				reload(fileName);
+			if (directoryRemoved)
+				return;
+		}
+#endif
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// options of DirectoryWatcher;
+	//
+	struct WatchOptions
+	{
+		//
+		// only files with this extension are parsed; empty - every file;
+		//
+		std::string mExtension{ ".json" };
+
+		//
+		// called on the watcher thread after a file was parsed again (or failed to parse,
+		// then the previous document stays published) and after a file was removed (nullptr);
+		//
+		std::function<void(const std::string& pFileName, const JSONResult<std::shared_ptr<const JSONObject>>& pDocument)> mOnChange;
+
+		ParseOptions mParseOptions{};
+	};
+
+	//
+	// keeps parsed documents of a directory (RESOURCES_PATH, for example) up to date;
+	// a file is parsed again only when inotify reports that it was written or moved in,
+	// the new document is published by an atomic swap of the shared pointer, thus
+	// readers take no lock, never wait for parsing and never see a half-built JSONObject;
+	// if the event queue overflows, the directory is scanned again and every file is reloaded;
+	// hot reload works on Linux only, elsewhere start() loads documents once and reports FILE_ERROR;
+	//
+	class DirectoryWatcher
+	{
+	public:
+		using Document = std::shared_ptr<const JSONObject>;
+	public:
+		explicit DirectoryWatcher(const std::filesystem::path& pDirectory, const WatchOptions& pOptions = {});
+		~DirectoryWatcher();
+		DirectoryWatcher(const DirectoryWatcher&) = delete;
+		DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+		//
+		// parses every file of the directory and starts watching it;
+		//
+		JSONStatus start();
+
+		//
+		// stops watching; published documents stay available;
+		//
+		void stop();
+
+		//
+		// returns the current document of the file (name relative to the directory),
+		// or nullptr if there is no such file or it has never been parsed successfully;
+		//
+		Document get(std::string_view pFileName) const;
+
+	private:
+		//
+		// a published document; slots are never removed, thus their addresses are stable;
+		//
+		struct Slot
+		{
+			std::atomic<Document> mDocument;
+		};
+
+		//
+		// the map of slots is immutable once published: a new file publishes a copy with one more slot,
+		// thus get() takes no lock; only one thread at a time (start() or the watcher thread) writes;
+		//
+		using SlotMap = std::unordered_map<std::string, std::shared_ptr<Slot>, StringHash, std::equal_to<>>;
+
+	private:
+		//
+		// parses the file and publishes it; a removed file publishes nullptr;
+		//
+		void reload(const std::string& pFileName);
+
+		bool isWatched(std::string_view pFileName) const;
+		Slot& getSlot(const std::string& pFileName);
+
+		//
+		// main loop of the watcher thread;
+		//
+		void watchLoop();
+
+	private:
+		std::filesystem::path mDirectory;
+		WatchOptions mOptions;
+		std::atomic<std::shared_ptr<const SlotMap>> mSlots{ std::make_shared<const SlotMap>() };
+		std::thread mThread;
+		int mNotifyDescriptor{ -1 };
+		int mStopDescriptor{ -1 };
+	};
+}
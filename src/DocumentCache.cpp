@@ -0,0 +1,183 @@
+#include "DocumentCache.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace tng
+{
+	DocumentCache::DocumentCache(const DocumentCacheOptions& pOptions)
+		: mOptions(pOptions)
+	{
+	}
+
+	DocumentCache& DocumentCache::getDefault()
+	{
+		static DocumentCache cache;
+		return cache;
+	}
+
+	JSONResult<DocumentCache::Document> DocumentCache::get(const std::filesystem::path& pPath)
+	{
+		JSONResult<FileIdentity> identity = identify(pPath);
+		if (!identity)
+			return std::unexpected(identity.error());
+
+		std::string key = pPath.string();
+		std::promise<JSONResult<Document>> promise;
+		std::shared_future<JSONResult<Document>> document;
+		uint64_t generation{};
+		bool isLoader = false;
+		{
+			std::lock_guard lock(mMutex);
+			auto it = mEntries.find(key);
+			if (it != mEntries.end() && it->second.mIdentity == *identity)
+			{
+				mStats.mHits++;
+				mLru.splice(mLru.begin(), mLru, it->second.mLruPosition);
+				document = it->second.mDocument;
+			}
+			else
+			{
+				mStats.mMisses++;
+				if (it != mEntries.end())
+					erase(it);
+				mLru.push_front(key);
+				Entry& entry = mEntries[key];
+				entry.mIdentity = *identity;
+				entry.mDocument = promise.get_future().share();
+				entry.mLruPosition = mLru.begin();
+				entry.mGeneration = generation = ++mLastGeneration;
+				document = entry.mDocument;
+				isLoader = true;
+			}
+		}
+		// a hit waits here while another thread is still loading the document;
+		if (!isLoader)
+			return document.get();
+
+		JSONResult<Document> result = load(pPath);
+		promise.set_value(result);
+
+		std::lock_guard lock(mMutex);
+		auto it = mEntries.find(key);
+		// the entry could be invalidated or replaced by a newer version meanwhile;
+		if (it == mEntries.end() || it->second.mGeneration != generation)
+			return result;
+		if (!result)
+			erase(it);
+		else
+		{
+			it->second.mLoaded = true;
+			it->second.mBytes = static_cast<size_t>(identity->mSize);
+			mUsedBytes += it->second.mBytes;
+			evict();
+		}
+		return result;
+	}
+
+	void DocumentCache::invalidate(const std::filesystem::path& pPath)
+	{
+		std::lock_guard lock(mMutex);
+		auto it = mEntries.find(pPath.string());
+		if (it != mEntries.end())
+			erase(it);
+	}
+
+	void DocumentCache::clear()
+	{
+		std::lock_guard lock(mMutex);
+		mEntries.clear();
+		mLru.clear();
+		mUsedBytes = 0;
+	}
+
+	size_t DocumentCache::getUsedBytes() const
+	{
+		std::lock_guard lock(mMutex);
+		return mUsedBytes;
+	}
+
+	size_t DocumentCache::size() const
+	{
+		std::lock_guard lock(mMutex);
+		return mEntries.size();
+	}
+
+	DocumentCacheStats DocumentCache::getStats() const
+	{
+		std::lock_guard lock(mMutex);
+		return mStats;
+	}
+
+	JSONResult<DocumentCache::FileIdentity> DocumentCache::identify(const std::filesystem::path& pPath)
+	{
+		FileIdentity identity;
+#if defined(_WIN32)
+		struct _stat64 info{};
+		if (::_wstat64(pPath.c_str(), &info) != 0)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		identity.mModified = static_cast<int64_t>(info.st_mtime);
+#else
+		struct stat info{};
+		if (::stat(pPath.c_str(), &info) != 0)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+	#if defined(__APPLE__)
+		identity.mModified = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1'000'000'000 + info.st_mtimespec.tv_nsec;
+	#else
+		identity.mModified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec;
+	#endif
+#endif
+		identity.mDevice = static_cast<uint64_t>(info.st_dev);
+		identity.mInode = static_cast<uint64_t>(info.st_ino);
+		identity.mSize = static_cast<uint64_t>(info.st_size);
+		return identity;
+	}
+
+	JSONResult<DocumentCache::Document> DocumentCache::load(const std::filesystem::path& pPath) const noexcept
+	{
+		// every failure becomes an error value: waiters of the promise must never get broken_promise;
+		try
+		{
+			JSONResult<FileBuffer> file = FileBuffer::open(pPath);
+			if (!file)
+				return std::unexpected(file.error());
+			JSONResult<JSONObject> object = tng::parse(file->getView(), mOptions.mParseOptions);
+			if (!object)
+				return std::unexpected(object.error());
+			return std::make_shared<const JSONObject>(std::move(*object));
+		}
+		catch (const std::filesystem::filesystem_error&)
+		{
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		}
+		catch (...)
+		{
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+		}
+	}
+
+	void DocumentCache::evict()
+	{
+		// documents which are still loading have no size yet and are skipped;
+		auto position = mLru.end();
+		while (mUsedBytes > mOptions.mMaxBytes && position != mLru.begin())
+		{
+			auto candidate = std::prev(position);
+			auto it = mEntries.find(*candidate);
+			if (it->second.mLoaded)
+			{
+				erase(it);
+				mStats.mEvictions++;
+			}
+			else
+				position = candidate;
+		}
+	}
+
+	void DocumentCache::erase(Storage::iterator pEntry)
+	{
+		mUsedBytes -= pEntry->second.mBytes;
+		mLru.erase(pEntry->second.mLruPosition);
+		mEntries.erase(pEntry);
+	}
+}
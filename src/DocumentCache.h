@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// options of DocumentCache;
+	//
+	struct DocumentCacheOptions
+	{
+		//
+		// documents are evicted (least recently used first) when the total size
+		// of their files exceeds this budget;
+		//
+		size_t mMaxBytes{ 64 * 1024 * 1024 };
+
+		ParseOptions mParseOptions{};
+	};
+
+	//
+	// counters of DocumentCache, they only grow;
+	//
+	struct DocumentCacheStats
+	{
+		uint64_t mHits{};
+		uint64_t mMisses{};
+		uint64_t mEvictions{};
+	};
+
+	//
+	// cache of parsed files keyed by path and identified by (device, inode, size, mtime),
+	// thus a changed or replaced file is parsed again on the next request;
+	// documents are shared and immutable, a document stays valid for its holders after eviction;
+	// concurrent requests of one path wait for a single load instead of parsing it each;
+	//
+	class DocumentCache
+	{
+	public:
+		using Document = std::shared_ptr<const JSONObject>;
+	public:
+		explicit DocumentCache(const DocumentCacheOptions& pOptions = {});
+		DocumentCache(const DocumentCache&) = delete;
+		DocumentCache& operator=(const DocumentCache&) = delete;
+
+		//
+		// returns a process-wide cache with default options;
+		//
+		static DocumentCache& getDefault();
+
+		//
+		// returns the parsed file, loading it if it is not cached or has changed;
+		// errors (missing file, invalid text) are not cached;
+		//
+		JSONResult<Document> get(const std::filesystem::path& pPath);
+
+		//
+		// drops the cached document of the path / all documents;
+		//
+		void invalidate(const std::filesystem::path& pPath);
+		void clear();
+
+		//
+		// returns the total size of files of cached documents;
+		//
+		size_t getUsedBytes() const;
+		size_t size() const;
+		DocumentCacheStats getStats() const;
+
+	private:
+		struct FileIdentity
+		{
+			uint64_t mDevice{};
+			uint64_t mInode{};
+			uint64_t mSize{};
+			int64_t mModified{};
+
+			bool operator==(const FileIdentity&) const = default;
+		};
+
+		struct Entry
+		{
+			FileIdentity mIdentity;
+			std::shared_future<JSONResult<Document>> mDocument;
+			std::list<std::string>::iterator mLruPosition;
+			size_t mBytes{};
+			uint64_t mGeneration{};
+			bool mLoaded{ false };
+		};
+
+		using Storage = std::unordered_map<std::string, Entry, StringHash, std::equal_to<>>;
+
+	private:
+		//
+		// returns the identity of the file without opening it;
+		//
+		static JSONResult<FileIdentity> identify(const std::filesystem::path& pPath);
+
+		//
+		// reads and parses the file; never throws, a failure of any kind is returned as an error;
+		//
+		JSONResult<Document> load(const std::filesystem::path& pPath) const noexcept;
+
+		//
+		// evicts least recently used loaded documents until the budget is kept;
+		// must be called under mMutex;
+		//
+		void evict();
+
+		//
+		// removes the entry and its place in the LRU list; must be called under mMutex;
+		//
+		void erase(Storage::iterator pEntry);
+
+	private:
+		DocumentCacheOptions mOptions;
+		mutable std::mutex mMutex;
+		Storage mEntries;
+		std::list<std::string> mLru;
+		size_t mUsedBytes{};
+		uint64_t mLastGeneration{};
+		DocumentCacheStats mStats;
+	};
+}
@@ -0,0 +1,302 @@
+#include "FileBuffer.h"
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+#include <atomic>
+
+namespace tng
+{
+	namespace
+	{
+		//
+		// returns a unique name of a temporary file in the directory of pPath;
+		//
+		std::filesystem::path makeTemporaryPath(const std::filesystem::path& pPath)
+		{
+			static std::atomic<uint64_t> counter{};
+#if defined(_WIN32)
+			uint64_t process = GetCurrentProcessId();
+#else
+			uint64_t process = static_cast<uint64_t>(::getpid());
+#endif
+			std::filesystem::path temporary = pPath;
+			temporary += ".tmp." + std::to_string(process) + "." + std::to_string(counter.fetch_add(1));
+			return temporary;
+		}
+	}
+
+	FileBuffer::~FileBuffer()
+	{
+		release();
+	}
+
+	FileBuffer::FileBuffer(FileBuffer&& pOther) noexcept
+	{
+		*this = std::move(pOther);
+	}
+
+	FileBuffer& FileBuffer::operator=(FileBuffer&& pOther) noexcept
+	{
+		if (this == &pOther)
+			return *this;
+		release();
+		mMapped = pOther.mMapped;
+		mSize = pOther.mSize;
+		mBuffer = std::move(pOther.mBuffer);
+		mData = mMapped ? pOther.mData : mBuffer.data();
+		pOther.mData = nullptr;
+		pOther.mSize = 0;
+		pOther.mMapped = false;
+		return *this;
+	}
+
+	std::string_view FileBuffer::getView() const noexcept
+	{
+		return mData == nullptr ? std::string_view() : std::string_view(mData, mSize);
+	}
+
+	bool FileBuffer::isMapped() const noexcept
+	{
+		return mMapped;
+	}
+
+#if defined(_WIN32)
+
+	JSONResult<FileBuffer> FileBuffer::open(const std::filesystem::path& pPath, const FileReadOptions& pOptions)
+	{
+		FileBuffer file;
+		HANDLE handle = CreateFileW(pPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+									pOptions.mSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+
+		LARGE_INTEGER size{};
+		bool isDisk = GetFileType(handle) == FILE_TYPE_DISK && GetFileSizeEx(handle, &size);
+		if (isDisk && static_cast<size_t>(size.QuadPart) >= pOptions.mMinMappedSize)
+		{
+			HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+				if (view != nullptr)
+				{
+					file.mData = static_cast<const char*>(view);
+					file.mSize = static_cast<size_t>(size.QuadPart);
+					file.mMapped = true;
+					CloseHandle(handle);
+					return file;
+				}
+			}
+		}
+
+		JSONStatus status = file.readAll(reinterpret_cast<intptr_t>(handle));
+		CloseHandle(handle);
+		if (!status)
+			return std::unexpected(status.error());
+		return file;
+	}
+
+	JSONStatus writeFileAtomically(const std::filesystem::path& pPath, std::string_view pData,
+								   const FileWriteOptions& pOptions)
+	{
+		std::filesystem::path temporary = makeTemporaryPath(pPath);
+		HANDLE handle = CreateFileW(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+									FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+
+		bool success = true;
+		while (success && !pData.empty())
+		{
+			DWORD chunk = static_cast<DWORD>(std::min<size_t>(pData.size(), 1u << 30));
+			DWORD written{};
+			success = WriteFile(handle, pData.data(), chunk, &written, nullptr) != 0;
+			pData.remove_prefix(written);
+		}
+		if (success && pOptions.mSync)
+			success = FlushFileBuffers(handle) != 0;
+		CloseHandle(handle);
+
+		// ReplaceFileW keeps the attributes and the security descriptor of an existing file;
+		DWORD flags = MOVEFILE_REPLACE_EXISTING | (pOptions.mSync ? MOVEFILE_WRITE_THROUGH : 0);
+		if (success && GetFileAttributesW(pPath.c_str()) != INVALID_FILE_ATTRIBUTES)
+			success = ReplaceFileW(pPath.c_str(), temporary.c_str(), nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr) != 0;
+		else if (success)
+			success = MoveFileExW(temporary.c_str(), pPath.c_str(), flags) != 0;
+		if (!success)
+		{
+			DeleteFileW(temporary.c_str());
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		}
+		return {};
+	}
+
+	JSONStatus FileBuffer::readAll(intptr_t pHandle)
+	{
+		HANDLE handle = reinterpret_cast<HANDLE>(pHandle);
+		constexpr DWORD blockSize = 64 * 1024;
+		DWORD bytesRead{};
+		do
+		{
+			size_t oldSize = mBuffer.size();
+			mBuffer.resize(oldSize + blockSize);
+			if (!ReadFile(handle, mBuffer.data() + oldSize, blockSize, &bytesRead, nullptr))
+				return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+			mBuffer.resize(oldSize + bytesRead);
+		} while (bytesRead != 0);
+		mData = mBuffer.data();
+		mSize = mBuffer.size();
+		return {};
+	}
+
+	void FileBuffer::release() noexcept
+	{
+		if (mMapped && mData != nullptr)
+			UnmapViewOfFile(mData);
+		mData = nullptr;
+		mSize = 0;
+		mMapped = false;
+		mBuffer.clear();
+	}
+
+#else
+
+	JSONResult<FileBuffer> FileBuffer::open(const std::filesystem::path& pPath, const FileReadOptions& pOptions)
+	{
+		FileBuffer file;
+		int descriptor = ::open(pPath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (descriptor < 0)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+
+		// procfs and sysfs report size 0, pipes are not regular - both are read into the buffer;
+		struct stat info{};
+		if (::fstat(descriptor, &info) == 0 &&
+			S_ISREG(info.st_mode) &&
+			static_cast<size_t>(info.st_size) >= std::max<size_t>(pOptions.mMinMappedSize, 1))
+		{
+			int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+			if (pOptions.mPopulate)
+				flags |= MAP_POPULATE;
+#endif
+			size_t size = static_cast<size_t>(info.st_size);
+			void* mapping = ::mmap(nullptr, size, PROT_READ, flags, descriptor, 0);
+			if (mapping != MAP_FAILED)
+			{
+				::madvise(mapping, size, pOptions.mSequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+				::close(descriptor);
+				file.mData = static_cast<const char*>(mapping);
+				file.mSize = size;
+				file.mMapped = true;
+				return file;
+			}
+		}
+
+		JSONStatus status = file.readAll(descriptor);
+		::close(descriptor);
+		if (!status)
+			return std::unexpected(status.error());
+		return file;
+	}
+
+	JSONStatus writeFileAtomically(const std::filesystem::path& pPath, std::string_view pData,
+								   const FileWriteOptions& pOptions)
+	{
+		std::filesystem::path temporary = makeTemporaryPath(pPath);
+		int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (descriptor < 0)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+
+		bool success = true;
+		// a replaced file keeps its mode and, where we are allowed to set it, its owner;
+		// the owner goes first, since changing it clears the setuid and setgid bits;
+		struct stat target{};
+		if (::stat(pPath.c_str(), &target) == 0 && S_ISREG(target.st_mode))
+		{
+			if (target.st_uid != ::geteuid() || target.st_gid != ::getegid())
+			{
+				[[maybe_unused]] int ignored = ::fchown(descriptor, target.st_uid, target.st_gid);
+			}
+			success = ::fchmod(descriptor, target.st_mode & 07777) == 0;
+		}
+		while (success && !pData.empty())
+		{
+			ssize_t written = ::write(descriptor, pData.data(), pData.size());
+			if (written < 0 && errno == EINTR)
+				continue;
+			success = written > 0;
+			if (success)
+				pData.remove_prefix(static_cast<size_t>(written));
+		}
+		if (success && pOptions.mSync)
+			success = ::fsync(descriptor) == 0;
+		success = ::close(descriptor) == 0 && success;
+
+		if (!success || ::rename(temporary.c_str(), pPath.c_str()) != 0)
+		{
+			::unlink(temporary.c_str());
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		}
+
+		if (pOptions.mSync)
+		{
+			// makes the rename itself durable;
+			std::filesystem::path directory = pPath.has_parent_path() ? pPath.parent_path() : std::filesystem::path(".");
+			int directoryDescriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (directoryDescriptor >= 0)
+			{
+				::fsync(directoryDescriptor);
+				::close(directoryDescriptor);
+			}
+		}
+		return {};
+	}
+
+	JSONStatus FileBuffer::readAll(intptr_t pHandle)
+	{
+		int descriptor = static_cast<int>(pHandle);
+		constexpr size_t blockSize = 64 * 1024;
+		while (true)
+		{
+			size_t oldSize = mBuffer.size();
+			mBuffer.resize(oldSize + blockSize);
+			ssize_t bytesRead = ::read(descriptor, mBuffer.data() + oldSize, blockSize);
+			if (bytesRead < 0 && errno == EINTR)
+			{
+				mBuffer.resize(oldSize);
+				continue;
+			}
+			if (bytesRead < 0)
+				return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+			mBuffer.resize(oldSize + static_cast<size_t>(bytesRead));
+			if (bytesRead == 0)
+				break;
+		}
+		mData = mBuffer.data();
+		mSize = mBuffer.size();
+		return {};
+	}
+
+	void FileBuffer::release() noexcept
+	{
+		if (mMapped && mData != nullptr)
+			::munmap(const_cast<char*>(mData), mSize);
+		mData = nullptr;
+		mSize = 0;
+		mMapped = false;
+		mBuffer.clear();
+	}
+
+#endif
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "JSONError.h"
+
+namespace tng
+{
+	//
+	// options of FileBuffer::open();
+	//
+	struct FileReadOptions
+	{
+		//
+		// regular files smaller than this are read into a buffer,
+		// because for them a mapping costs more than a copy;
+		//
+		size_t mMinMappedSize{ 64 * 1024 };
+
+		//
+		// prefault pages of the mapping at once (MAP_POPULATE, Linux only);
+		// helps when the whole file is going to be parsed anyway;
+		//
+		bool mPopulate{ true };
+
+		//
+		// the file is going to be read from the start to the end (readahead is raised);
+		// turn it off for files which are accessed at random, like snapshots;
+		//
+		bool mSequential{ true };
+	};
+
+	//
+	// options of writeFileAtomically();
+	//
+	struct FileWriteOptions
+	{
+		//
+		// flush the data (and the rename) to the disk before returning;
+		// turning it off makes writing much cheaper, but after a power loss
+		// the file may be left in its previous state;
+		//
+		bool mSync{ true };
+	};
+
+	//
+	// writes pData into a temporary file next to pPath and renames it into place,
+	// thus readers see either the old or the new file, never a partial one;
+	// an existing file is replaced with its mode (and owner, if permitted) preserved;
+	// the data is written with as few syscalls as possible (usually one);
+	//
+	JSONStatus writeFileAtomically(const std::filesystem::path& pPath, std::string_view pData,
+								   const FileWriteOptions& pOptions = {});
+
+	//
+	// read-only contents of a file;
+	// regular files are memory-mapped (no copy into std::string), other files
+	// (pipes, procfs and so on) are read into an owned buffer;
+	// getView() is valid while the FileBuffer is alive;
+	//
+	class FileBuffer
+	{
+	public:
+		FileBuffer() = default;
+		~FileBuffer();
+		FileBuffer(const FileBuffer&) = delete;
+		FileBuffer& operator=(const FileBuffer&) = delete;
+		FileBuffer(FileBuffer&& pOther) noexcept;
+		FileBuffer& operator=(FileBuffer&& pOther) noexcept;
+
+		//
+		// opens and maps (or reads) the file;
+		// there is no separate existence check, failing open() is the check;
+		//
+		static JSONResult<FileBuffer> open(const std::filesystem::path& pPath, const FileReadOptions& pOptions = {});
+
+		//
+		// returns contents of the file;
+		//
+		std::string_view getView() const noexcept;
+
+		//
+		// returns true - if contents are mapped, false - if they are in a buffer;
+		//
+		bool isMapped() const noexcept;
+
+	private:
+		//
+		// unmaps the file and clears the buffer;
+		//
+		void release() noexcept;
+
+		//
+		// reads everything from an opened descriptor/handle into mBuffer;
+		//
+		JSONStatus readAll(intptr_t pHandle);
+
+	private:
+		const char* mData{ nullptr };
+		size_t mSize{};
+		bool mMapped{ false };
+		std::string mBuffer;
+	};
+}
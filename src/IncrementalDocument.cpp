@@ -0,0 +1,264 @@
+#include "IncrementalDocument.h"
+
+namespace tng
+{
+	namespace
+	{
+		using Entry = JSONTape::Entry;
+		using TokenType = JSONTape::TokenType;
+
+		constexpr size_t NONE = static_cast<size_t>(-1);
+
+		//
+		// the edit [pBegin, pEnd) is inside the brackets of the container;
+		//
+		bool containerHolds(const JSONTape& pTape, size_t pIndex, size_t pBegin, size_t pEnd) noexcept
+		{
+			return pTape[pIndex].mOffset < pBegin && pEnd <= pTape[pTape[pIndex].mMatch].mOffset;
+		}
+
+		//
+		// the edit [pBegin, pEnd) changes only the scalar token: the inside of a quoted string
+		// or any part of a bare word (its neighbours are delimiters, thus they stay apart);
+		//
+		bool scalarHolds(const JSONTape& pTape, size_t pIndex, size_t pBegin, size_t pEnd, std::string_view pText) noexcept
+		{
+			const Entry& entry = pTape[pIndex];
+			size_t tokenEnd = entry.mOffset + entry.mLength;
+			if (pText[entry.mOffset] == '"')
+				return entry.mOffset < pBegin && pEnd < tokenEnd;
+			return entry.mOffset <= pBegin && pEnd <= tokenEnd;
+		}
+
+		//
+		// an object keeps the last of duplicate keys, thus the value behind an earlier one isnt in the object;
+		// "key" and key are the same key;
+		//
+		bool hasLaterDuplicate(const JSONTape& pTape, size_t pKey, size_t pClose)
+		{
+			auto decode = [&](size_t pIndex)
+				{
+					return JSONTape::decodeString(pTape.getRaw(pIndex)).value_or(std::string());
+				};
+			std::string key = decode(pKey);
+			for (size_t i = pTape.skip(pKey + 1); i < pClose; i = pTape.skip(i + 1))
+			{
+				if (decode(i) == key)
+					return true;
+			}
+			return false;
+		}
+	}
+
+	IncrementalDocument::IncrementalDocument(IncrementalDocument&& pOther) noexcept
+		: mText(std::move(pOther.mText))
+		, mTape(std::move(pOther.mTape))
+		, mObject(std::move(pOther.mObject))
+		, mLastReparsedBytes(pOther.mLastReparsedBytes)
+	{
+		// a short string lives inside the object, thus the view of the tape must follow it;
+		mTape.mText = mText;
+	}
+
+	IncrementalDocument& IncrementalDocument::operator=(IncrementalDocument&& pOther) noexcept
+	{
+		mText = std::move(pOther.mText);
+		mTape = std::move(pOther.mTape);
+		mObject = std::move(pOther.mObject);
+		mLastReparsedBytes = pOther.mLastReparsedBytes;
+		mTape.mText = mText;
+		return *this;
+	}
+
+	JSONResult<IncrementalDocument> IncrementalDocument::create(std::string pText)
+	{
+		IncrementalDocument document;
+		document.mText = std::move(pText);
+		if (JSONStatus status = document.rebuild(); !status)
+			return std::unexpected(status.error());
+		return document;
+	}
+
+	JSONStatus IncrementalDocument::applyEdit(const TextEdit& pEdit)
+	{
+		size_t begin = pEdit.mOffset;
+		size_t end = begin + pEdit.mRemovedLength;
+		if (end > mText.size())
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(mText.size()) });
+
+		// descends from the root to the smallest value which holds the edit;
+		std::vector<size_t> containers;
+		std::vector<Step> path;
+		size_t scalar = NONE;
+		if (mTape.size() != 0 && containerHolds(mTape, 0, begin, end))
+		{
+			containers.push_back(0);
+			bool descended = true;
+			while (descended && scalar == NONE)
+			{
+				descended = false;
+				size_t current = containers.back();
+				size_t close = mTape[current].mMatch;
+				bool isObject = mTape[current].mType == TokenType::LBRACE;
+				size_t position{};
+				for (size_t child = current + 1; child < close; ++position)
+				{
+					size_t key = NONE;
+					if (isObject)
+						key = child++;
+					size_t childEnd = mTape.skip(child);
+					const Entry& last = mTape[childEnd - 1];
+					if (mTape[child].mOffset > end)
+						break;
+					if (last.mOffset + last.mLength < begin)
+					{
+						child = childEnd;
+						continue;
+					}
+
+					bool isContainer = mTape.isContainer(child);
+					if (isContainer ? !containerHolds(mTape, child, begin, end) : !scalarHolds(mTape, child, begin, end, mText))
+						break;
+					if (isObject && hasLaterDuplicate(mTape, key, close))
+						break;
+
+					Step step;
+					step.mIndex = position;
+					step.mIsKey = isObject;
+					if (isObject)
+						step.mKey = JSONTape::decodeString(mTape.getRaw(key)).value_or(std::string());
+					path.push_back(std::move(step));
+					if (isContainer)
+					{
+						containers.push_back(child);
+						descended = true;
+					}
+					else
+						scalar = child;
+					break;
+				}
+			}
+		}
+
+		std::string removed = mText.substr(begin, pEdit.mRemovedLength);
+		int64_t delta = static_cast<int64_t>(pEdit.mInsertedText.size()) - static_cast<int64_t>(removed.size());
+		mText.replace(begin, removed.size(), pEdit.mInsertedText);
+
+		if (scalar != NONE)
+		{
+			if (reparse(scalar, delta, path))
+				return {};
+			path.pop_back();
+		}
+		for (size_t depth = containers.size(); depth-- > 0;)
+		{
+			if (reparse(containers[depth], delta, std::span<const Step>(path).first(depth)))
+				return {};
+		}
+
+		if (JSONStatus status = rebuild(); !status)
+		{
+			mText.replace(begin, pEdit.mInsertedText.size(), removed);
+			mTape.mText = mText;
+			return status;
+		}
+		return {};
+	}
+
+	JSONStatus IncrementalDocument::rebuild()
+	{
+		JSONTape tape;
+		if (JSONStatus status = tape.build(mText); !status)
+			return status;
+		JSONResult<JSONObject> object = tape.toObject();
+		if (!object)
+			return std::unexpected(object.error());
+		mTape = std::move(tape);
+		mObject = std::move(*object);
+		mLastReparsedBytes = mText.size();
+		return {};
+	}
+
+	bool IncrementalDocument::reparse(size_t pIndex, int64_t pDelta, std::span<const Step> pPath)
+	{
+		size_t oldEnd = mTape.skip(pIndex);
+		size_t spanBegin = mTape[pIndex].mOffset;
+		size_t oldSpanEnd = mTape[oldEnd - 1].mOffset + mTape[oldEnd - 1].mLength;
+		size_t spanEnd = static_cast<size_t>(static_cast<int64_t>(oldSpanEnd) + pDelta);
+
+		JSONTape local;
+		if (!local.build(std::string_view(mText).substr(spanBegin, spanEnd - spanBegin)))
+			return false;
+
+		// everything is built before the document is touched, thus a failure leaves it as it was;
+		JSONObject root;
+		JSONValue value;
+		if (pIndex == 0)
+		{
+			JSONResult<JSONObject> object = local.toObject();
+			if (!object)
+				return false;
+			root = std::move(*object);
+		}
+		else
+		{
+			JSONResult<JSONValue> built = local.toValue();
+			if (!built)
+				return false;
+			value = std::move(*built);
+		}
+
+		std::vector<Entry>& entries = mTape.mEntries;
+		int64_t countDelta = static_cast<int64_t>(local.size()) - static_cast<int64_t>(oldEnd - pIndex);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (i >= pIndex && i < oldEnd)
+				continue;
+			if (entries[i].mMatch >= oldEnd)
+				entries[i].mMatch = static_cast<uint32_t>(entries[i].mMatch + countDelta);
+			if (i >= oldEnd)
+				entries[i].mOffset = static_cast<uint32_t>(entries[i].mOffset + pDelta);
+		}
+		for (Entry& entry : local.mEntries)
+		{
+			entry.mOffset += static_cast<uint32_t>(spanBegin);
+			entry.mMatch += static_cast<uint32_t>(pIndex);
+		}
+		entries.erase(entries.begin() + pIndex, entries.begin() + oldEnd);
+		entries.insert(entries.begin() + pIndex, local.mEntries.begin(), local.mEntries.end());
+		mTape.mText = mText;
+
+		if (pIndex == 0)
+			mObject = std::move(root);
+		else
+			assign(mObject, pPath, std::move(value));
+		mLastReparsedBytes = spanEnd - spanBegin;
+		return true;
+	}
+
+	void IncrementalDocument::assign(JSONObject& pObject, std::span<const Step> pPath, JSONValue&& pValue)
+	{
+		auto it = pObject.mKeyValueStrg.find(pPath.front().mKey);
+		assign(it->second, pPath.subspan(1), std::move(pValue));
+	}
+
+	void IncrementalDocument::assign(JSONValue& pSlot, std::span<const Step> pPath, JSONValue&& pValue)
+	{
+		if (pPath.empty())
+		{
+			pSlot = std::move(pValue);
+			return;
+		}
+		if (auto* array = std::get_if<std::vector<JSONValue>>(&pSlot.mValue))
+		{
+			assign((*array)[pPath.front().mIndex], pPath.subspan(1), std::move(pValue));
+			return;
+		}
+
+		// nested objects are shared with earlier copies of the document, thus the changed one is a new object;
+		auto& shared = std::get<std::shared_ptr<const JSONObject>>(pSlot.mValue);
+		JSONObject object = *shared;
+		assign(object, pPath, std::move(pValue));
+		shared = std::make_shared<const JSONObject>(std::move(object));
+	}
+}
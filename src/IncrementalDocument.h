@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONParser.h"
+#include "JSONTape.h"
+
+namespace tng
+{
+	//
+	// replaces mRemovedLength bytes at mOffset with mInsertedText;
+	// offsets are in bytes of the text before the edit;
+	//
+	struct TextEdit
+	{
+		uint32_t mOffset{};
+		uint32_t mRemovedLength{};
+		std::string_view mInsertedText;
+	};
+
+	//
+	// document for an editor or a config UI which changes its text a little at a time;
+	// after an edit only the smallest value around it is scanned again (a single scalar token
+	// or the innermost container), its entries are spliced into the tape and only the path
+	// from the root to it is rebuilt in the object; untouched subtrees are shared with the old one;
+	// if the local scan fails, enclosing containers are tried and then the whole text;
+	//
+	class IncrementalDocument
+	{
+	public:
+		IncrementalDocument() = default;
+		IncrementalDocument(IncrementalDocument&& pOther) noexcept;
+		IncrementalDocument& operator=(IncrementalDocument&& pOther) noexcept;
+		IncrementalDocument(const IncrementalDocument&) = delete;
+		IncrementalDocument& operator=(const IncrementalDocument&) = delete;
+
+		//
+		// parses the whole text; the root value must be an object;
+		//
+		static JSONResult<IncrementalDocument> create(std::string pText);
+
+		//
+		// applies the edit and updates the tape and the object;
+		// if the edited text is invalid, the edit is undone and the document stays as it was;
+		//
+		JSONStatus applyEdit(const TextEdit& pEdit);
+
+		std::string_view getText() const noexcept;
+		const JSONTape& getTape() const noexcept;
+		const JSONObject& getObject() const noexcept;
+
+		//
+		// returns the number of bytes scanned again by the last edit;
+		//
+		size_t getLastReparsedBytes() const noexcept;
+
+	private:
+		//
+		// one step from a container to its child: a key of an object or an index of an array;
+		//
+		struct Step
+		{
+			std::string mKey;
+			size_t mIndex{};
+			bool mIsKey{ false };
+		};
+
+	private:
+		//
+		// scans and builds everything from scratch;
+		//
+		JSONStatus rebuild();
+
+		//
+		// scans the value at pIndex again (its text is already edited and shifted by pDelta bytes);
+		// returns false if the new text isnt exactly one value;
+		//
+		bool reparse(size_t pIndex, int64_t pDelta, std::span<const Step> pPath);
+
+		static void assign(JSONObject& pObject, std::span<const Step> pPath, JSONValue&& pValue);
+		static void assign(JSONValue& pSlot, std::span<const Step> pPath, JSONValue&& pValue);
+
+	private:
+		std::string mText;
+		JSONTape mTape;
+		JSONObject mObject;
+		size_t mLastReparsedBytes{};
+	};
+
+	//
+	// IncrementalDocument implementation
+	//
+
+	inline std::string_view IncrementalDocument::getText() const noexcept
+	{
+		return mText;
+	}
+
+	inline const JSONTape& IncrementalDocument::getTape() const noexcept
+	{
+		return mTape;
+	}
+
+	inline const JSONObject& IncrementalDocument::getObject() const noexcept
+	{
+		return mObject;
+	}
+
+	inline size_t IncrementalDocument::getLastReparsedBytes() const noexcept
+	{
+		return mLastReparsedBytes;
+	}
+}
@@ -0,0 +1,612 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "JSONParser.h"
+#include "RawScan.h"
+
+namespace tng
+{
+	//
+	// describes how a struct is read from JSON; specialize it for your struct
+	// (or use TNG_JSON_BINDING) with a tuple of fields:
+	//
+	// struct Order { uint64_t mId{}; double mPrice{}; std::string mName; std::vector<int32_t> mTags; };
+	// TNG_JSON_BINDING(Order, tng::field("id", &Order::mId), tng::field("price", &Order::mPrice),
+	//					tng::field("name", &Order::mName), tng::field("tags", &Order::mTags))
+	// JSONResult<Order> order = tng::bind<Order>(text);
+	//
+	template<typename T>
+	struct JSONBinding;
+
+	//
+	// one field of a binding: a JSON key and the member it is decoded into;
+	//
+	template<typename Class, typename Member>
+	struct JSONField
+	{
+		using MemberType = Member;
+
+		std::string_view mName;
+		Member Class::* mMember;
+	};
+
+	template<typename Class, typename Member>
+	constexpr JSONField<Class, Member> field(std::string_view pName, Member Class::* pMember) noexcept
+	{
+		return { pName, pMember };
+	}
+
+	template<typename T>
+	concept isBound = requires { JSONBinding<T>::mFields; };
+
+	//
+	// reads values straight from the text; nothing is tokenized or allocated except
+	// the decoded strings; accepts the dialect of JSONLexer (unquoted words, optional commas);
+	//
+	class BindingReader
+	{
+	public:
+		explicit BindingReader(std::string_view pText) noexcept;
+
+		//
+		// consumes '{' / '[';
+		//
+		JSONStatus beginObject() noexcept;
+		JSONStatus beginArray() noexcept;
+
+		//
+		// moves to the next member and reads its key and ':';
+		// returns false at the closing '}' (which is consumed);
+		//
+		JSONResult<bool> nextKey(std::string_view& pKey);
+
+		//
+		// moves to the next element; returns false at the closing ']' (which is consumed);
+		//
+		JSONResult<bool> nextElement() noexcept;
+
+		//
+		// consumes null if it is the next value;
+		//
+		bool readNull() noexcept;
+
+		JSONStatus readBool(bool& pValue) noexcept;
+		JSONStatus readString(std::string& pValue);
+
+		//
+		// a view into the text, thus only strings without escapes can be read so;
+		//
+		JSONStatus readString(std::string_view& pValue) noexcept;
+
+		template<typename T>
+			requires isIntNumber<T> || isFloatNumber<T>
+		JSONStatus readNumber(T& pValue) noexcept;
+
+		//
+		// steps over a value of an unknown key;
+		//
+		JSONStatus skipValue() noexcept;
+
+		//
+		// checks that only spaces are left;
+		//
+		JSONStatus finish() noexcept;
+
+	private:
+		JSONError makeError(JSONErrorCode pCode) const noexcept;
+
+		//
+		// returns the bare word at the position and moves past it;
+		//
+		std::string_view readWord() noexcept;
+
+	private:
+		std::string_view mText;
+		size_t mPosition{};
+		std::string mKeyStorage;
+	};
+
+	template<typename T>
+	JSONStatus readValue(BindingReader& pReader, T& pValue);
+
+	//
+	// decodes the text into pObject; keys which are not in the binding are skipped,
+	// members which are not in the text keep their values;
+	//
+	template<typename T>
+		requires isBound<T>
+	JSONStatus bind(std::string_view pText, T& pObject);
+
+	template<typename T>
+		requires isBound<T>
+	JSONResult<T> bind(std::string_view pText);
+
+	//
+	// BindingReader implementation
+	//
+
+	inline BindingReader::BindingReader(std::string_view pText) noexcept
+		: mText(pText)
+	{
+	}
+
+	inline JSONError BindingReader::makeError(JSONErrorCode pCode) const noexcept
+	{
+		return JSONError{ pCode, static_cast<uint32_t>(mPosition) };
+	}
+
+	inline JSONStatus BindingReader::beginObject() noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		if (mPosition >= mText.size() || mText[mPosition] != '{')
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH));
+		++mPosition;
+		return {};
+	}
+
+	inline JSONStatus BindingReader::beginArray() noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		if (mPosition >= mText.size() || mText[mPosition] != '[')
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH));
+		++mPosition;
+		return {};
+	}
+
+	inline JSONResult<bool> BindingReader::nextKey(std::string_view& pKey)
+	{
+		mPosition = raw::skipSeparators(mText, mPosition);
+		if (mPosition >= mText.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		if (mText[mPosition] == '}')
+		{
+			++mPosition;
+			return false;
+		}
+		size_t keyEnd = raw::skipValue(mText, mPosition);
+		if (keyEnd == std::string_view::npos || mText[mPosition] == '{' || mText[mPosition] == '[')
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		pKey = raw::getKey(mText.substr(mPosition, keyEnd - mPosition), mKeyStorage);
+		mPosition = raw::skipSpaces(mText, keyEnd);
+		if (mPosition >= mText.size() || mText[mPosition] != ':')
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		mPosition = raw::skipSpaces(mText, mPosition + 1);
+		return true;
+	}
+
+	inline JSONResult<bool> BindingReader::nextElement() noexcept
+	{
+		mPosition = raw::skipSeparators(mText, mPosition);
+		if (mPosition >= mText.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		if (mText[mPosition] == ']')
+		{
+			++mPosition;
+			return false;
+		}
+		if (mText[mPosition] == '}' || mText[mPosition] == ':')
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		return true;
+	}
+
+	inline std::string_view BindingReader::readWord() noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		size_t begin = mPosition;
+		while (mPosition < mText.size() && !raw::isDelimiter(mText[mPosition]))
+			++mPosition;
+		return mText.substr(begin, mPosition - begin);
+	}
+
+	inline bool BindingReader::readNull() noexcept
+	{
+		size_t position = mPosition;
+		if (readWord() == "null")
+			return true;
+		mPosition = position;
+		return false;
+	}
+
+	inline JSONStatus BindingReader::readBool(bool& pValue) noexcept
+	{
+		size_t position = mPosition;
+		std::string_view word = readWord();
+		if (word != "true" && word != "false")
+		{
+			mPosition = position;
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH));
+		}
+		pValue = word == "true";
+		return {};
+	}
+
+	inline JSONStatus BindingReader::readString(std::string& pValue)
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		if (mPosition < mText.size() && mText[mPosition] == '"')
+		{
+			size_t end = simd::skipString(mText, mPosition);
+			if (end == std::string_view::npos)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+			JSONResult<std::string> decoded = JSONTape::decodeString(mText.substr(mPosition, end - mPosition));
+			if (!decoded)
+				return std::unexpected(makeError(decoded.error().mCode));
+			pValue = std::move(*decoded);
+			mPosition = end;
+			return {};
+		}
+		std::string_view word = readWord();
+		if (word.empty())
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH));
+		pValue.assign(word);
+		return {};
+	}
+
+	inline JSONStatus BindingReader::readString(std::string_view& pValue) noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		if (mPosition < mText.size() && mText[mPosition] == '"')
+		{
+			size_t end = simd::skipString(mText, mPosition);
+			if (end == std::string_view::npos)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+			std::string_view inner = mText.substr(mPosition + 1, end - mPosition - 2);
+			if (inner.find('\\') != std::string_view::npos)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER));
+			pValue = inner;
+			mPosition = end;
+			return {};
+		}
+		pValue = readWord();
+		if (pValue.empty())
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH));
+		return {};
+	}
+
+	template<typename T>
+		requires isIntNumber<T> || isFloatNumber<T>
+	inline JSONStatus BindingReader::readNumber(T& pValue) noexcept
+	{
+		size_t position = raw::skipSpaces(mText, mPosition);
+		std::string_view word = readWord();
+		if (!word.empty() && word.front() == '+')
+			word.remove_prefix(1);
+		const char* end = word.data() + word.size();
+		auto [ptr, errorCode] = std::from_chars(word.data(), end, pValue);
+		if (errorCode == std::errc::result_out_of_range)
+		{
+			mPosition = position;
+			return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE));
+		}
+		if (errorCode != std::errc() || ptr != end)
+		{
+			mPosition = position;
+			return std::unexpected(makeError(word.empty() ? JSONErrorCode::TYPE_MISMATCH : JSONErrorCode::INVALID_NUMBER));
+		}
+		return {};
+	}
+
+	inline JSONStatus BindingReader::skipValue() noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		size_t end = raw::skipValue(mText, mPosition);
+		if (end == std::string_view::npos)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		mPosition = end;
+		return {};
+	}
+
+	inline JSONStatus BindingReader::finish() noexcept
+	{
+		mPosition = raw::skipSpaces(mText, mPosition);
+		if (mPosition != mText.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT));
+		return {};
+	}
+
+	//
+	// typed decoding implementation
+	//
+
+	template<typename T>
+	struct isVectorType : std::false_type {};
+
+	template<typename T>
+	struct isVectorType<std::vector<T>> : std::true_type {};
+
+	template<typename T>
+	struct isOptionalType : std::false_type {};
+
+	template<typename T>
+	struct isOptionalType<std::optional<T>> : std::true_type {};
+
+	//
+	// seeded FNV-1a of a field name; the seed of a binding is chosen at compile time;
+	//
+	constexpr uint32_t hashFieldName(std::string_view pName, uint32_t pSeed) noexcept
+	{
+		uint32_t hash = 2166136261u ^ (pSeed * 0x9E3779B9u);
+		for (char c : pName)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 16777619u;
+		}
+		return hash ^ (hash >> 16);
+	}
+
+	//
+	// moves the hash of a name to another slot without reading the name again;
+	//
+	constexpr uint32_t displaceFieldHash(uint32_t pHash, uint32_t pDisplacement) noexcept
+	{
+		uint32_t hash = pHash + pDisplacement * 0x9E3779B9u;
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6Bu;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35u;
+		return hash ^ (hash >> 16);
+	}
+
+	//
+	// perfect hash of the field names of a binding, built at compile time (hash and displace):
+	// the hash of a name picks a bucket, the displacement of the bucket picks the slot, thus
+	// a key goes to its field with one pass over the key and one compare;
+	// buckets are placed from the largest one, each needs a few tries, thus building stays
+	// linear in the number of fields; duplicate names fail to compile;
+	//
+	template<typename T>
+	struct JSONFieldTable
+	{
+		static constexpr size_t COUNT = std::tuple_size_v<std::remove_cvref_t<decltype(JSONBinding<T>::mFields)>>;
+		static constexpr uint16_t EMPTY = static_cast<uint16_t>(-1);
+		static_assert(COUNT < EMPTY, "too many fields in one binding");
+
+		static constexpr std::array<std::string_view, COUNT> mNames = []<size_t... Index>(std::index_sequence<Index...>)
+			{
+				return std::array<std::string_view, COUNT>{ std::get<Index>(JSONBinding<T>::mFields).mName... };
+			}(std::make_index_sequence<COUNT>());
+
+		static constexpr bool UNIQUE = []()
+			{
+				std::array<std::string_view, COUNT> names = mNames;
+				std::sort(names.begin(), names.end());
+				return std::adjacent_find(names.begin(), names.end()) == names.end();
+			}();
+		static_assert(UNIQUE, "field names of the binding are not unique");
+
+		// at least twice as many slots as names, two names per bucket on average;
+		static constexpr size_t SIZE = std::bit_ceil(std::max<size_t>(COUNT * 2, 1));
+		static constexpr size_t BUCKETS = std::bit_ceil(std::max<size_t>(COUNT / 2, 1));
+
+		struct Shape
+		{
+			uint32_t mSeed{};
+			std::array<uint16_t, BUCKETS> mDisplacements{};
+			std::array<uint16_t, SIZE> mSlots{};
+			bool mFound{ false };
+		};
+
+		static constexpr Shape findShape()
+		{
+			// duplicates are reported above, searching for them would only take time;
+			if (!UNIQUE)
+				return { .mFound = true };
+			// only names whose 32-bit hashes are equal need another seed;
+			for (uint32_t seed = 0; seed < 64; ++seed)
+			{
+				Shape shape{ .mSeed = seed };
+				shape.mSlots.fill(EMPTY);
+
+				// the names of every bucket, stored contiguously from begins[bucket];
+				std::array<uint32_t, COUNT> hashes{};
+				std::array<uint16_t, BUCKETS + 1> begins{};
+				for (size_t i = 0; i < COUNT; ++i)
+				{
+					hashes[i] = hashFieldName(mNames[i], seed);
+					begins[(hashes[i] & (BUCKETS - 1)) + 1]++;
+				}
+				for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+					begins[bucket + 1] += begins[bucket];
+				std::array<uint16_t, COUNT> members{};
+				std::array<uint16_t, BUCKETS> filled{};
+				for (size_t i = 0; i < COUNT; ++i)
+				{
+					size_t bucket = hashes[i] & (BUCKETS - 1);
+					members[begins[bucket] + filled[bucket]++] = static_cast<uint16_t>(i);
+				}
+
+				std::array<uint16_t, BUCKETS> order{};
+				for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+					order[bucket] = static_cast<uint16_t>(bucket);
+				std::sort(order.begin(), order.end(), [&](uint16_t pLeft, uint16_t pRight)
+					{
+						return filled[pLeft] > filled[pRight];
+					});
+
+				bool placed = true;
+				std::array<uint16_t, COUNT> slots{};
+				for (size_t o = 0; o < BUCKETS && placed; ++o)
+				{
+					size_t bucket = order[o];
+					size_t size = filled[bucket];
+					if (size == 0)
+						break;
+					placed = false;
+					for (uint32_t displacement = 0; displacement < EMPTY && !placed; ++displacement)
+					{
+						placed = true;
+						for (size_t j = 0; j < size && placed; ++j)
+						{
+							slots[j] = static_cast<uint16_t>(displaceFieldHash(hashes[members[begins[bucket] + j]], displacement) & (SIZE - 1));
+							placed = shape.mSlots[slots[j]] == EMPTY;
+							for (size_t k = 0; k < j && placed; ++k)
+								placed = slots[k] != slots[j];
+						}
+						if (placed)
+						{
+							shape.mDisplacements[bucket] = static_cast<uint16_t>(displacement);
+							for (size_t j = 0; j < size; ++j)
+								shape.mSlots[slots[j]] = members[begins[bucket] + j];
+						}
+					}
+				}
+				if (placed)
+				{
+					shape.mFound = true;
+					return shape;
+				}
+			}
+			return {};
+		}
+
+		static constexpr Shape SHAPE = findShape();
+		static_assert(SHAPE.mFound, "no perfect hash for the field names of the binding");
+
+		static constexpr const std::array<uint16_t, SIZE>& mSlots = SHAPE.mSlots;
+
+		//
+		// returns the index of the field named pKey, or EMPTY;
+		//
+		static uint16_t find(std::string_view pKey) noexcept
+		{
+			uint32_t hash = hashFieldName(pKey, SHAPE.mSeed);
+			uint16_t slot = mSlots[displaceFieldHash(hash, SHAPE.mDisplacements[hash & (BUCKETS - 1)]) & (SIZE - 1)];
+			return slot != EMPTY && mNames[slot] == pKey ? slot : EMPTY;
+		}
+	};
+
+	//
+	// decodes the value into the field pField; unrolled at compile time into a switch-like chain;
+	//
+	template<size_t Index, typename T>
+	inline JSONStatus readFieldAt(BindingReader& pReader, size_t pField, T& pObject)
+	{
+		if constexpr (Index == JSONFieldTable<T>::COUNT)
+			return {};
+		else
+		{
+			if (pField == Index)
+				return readValue(pReader, pObject.*(std::get<Index>(JSONBinding<T>::mFields).mMember));
+			return readFieldAt<Index + 1>(pReader, pField, pObject);
+		}
+	}
+
+	//
+	// decodes the value into the field named pKey; pFound is false if there is no such field;
+	//
+	template<typename T>
+	inline JSONStatus readField(BindingReader& pReader, std::string_view pKey, T& pObject, bool& pFound)
+	{
+		uint16_t field = JSONFieldTable<T>::find(pKey);
+		pFound = field != JSONFieldTable<T>::EMPTY;
+		if (!pFound)
+			return {};
+		return readFieldAt<0>(pReader, field, pObject);
+	}
+
+	template<typename T>
+	inline JSONStatus readValue(BindingReader& pReader, T& pValue)
+	{
+		if constexpr (isBound<T>)
+		{
+			if (JSONStatus status = pReader.beginObject(); !status)
+				return status;
+			std::string_view key;
+			while (true)
+			{
+				JSONResult<bool> next = pReader.nextKey(key);
+				if (!next)
+					return std::unexpected(next.error());
+				if (!*next)
+					return {};
+				bool found{};
+				if (JSONStatus status = readField(pReader, key, pValue, found); !status)
+					return status;
+				if (!found)
+				{
+					if (JSONStatus status = pReader.skipValue(); !status)
+						return status;
+				}
+			}
+		}
+		else if constexpr (isKeyword<T>)
+			return pReader.readBool(pValue);
+		else if constexpr (isIntNumber<T> || isFloatNumber<T>)
+			return pReader.readNumber(pValue);
+		else if constexpr (isString<T>)
+		{
+			static_assert(std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>,
+						  "string fields must be std::string or std::string_view");
+			return pReader.readString(pValue);
+		}
+		else if constexpr (isOptionalType<T>::value)
+		{
+			if (pReader.readNull())
+			{
+				pValue.reset();
+				return {};
+			}
+			return readValue(pReader, pValue.emplace());
+		}
+		else if constexpr (isVectorType<T>::value)
+		{
+			if (JSONStatus status = pReader.beginArray(); !status)
+				return status;
+			pValue.clear();
+			while (true)
+			{
+				JSONResult<bool> next = pReader.nextElement();
+				if (!next)
+					return std::unexpected(next.error());
+				if (!*next)
+					return {};
+				if (JSONStatus status = readValue(pReader, pValue.emplace_back()); !status)
+					return status;
+			}
+		}
+		else
+			static_assert(isBound<T>, "the type has no JSON decoder, add a JSONBinding for it");
+	}
+
+	template<typename T>
+		requires isBound<T>
+	inline JSONStatus bind(std::string_view pText, T& pObject)
+	{
+		BindingReader reader(pText);
+		if (JSONStatus status = readValue(reader, pObject); !status)
+			return status;
+		return reader.finish();
+	}
+
+	template<typename T>
+		requires isBound<T>
+	inline JSONResult<T> bind(std::string_view pText)
+	{
+		T object{};
+		if (JSONStatus status = bind(pText, object); !status)
+			return std::unexpected(status.error());
+		return object;
+	}
+}
+
+//
+// specializes tng::JSONBinding for Type with the listed tng::field() descriptors;
+// must be used at global scope;
+//
+#define TNG_JSON_BINDING(Type, ...)												\
+	template<>																	\
+	struct tng::JSONBinding<Type>												\
+	{																			\
+		static constexpr auto mFields = std::make_tuple(__VA_ARGS__);			\
+	};
@@ -0,0 +1,304 @@
+#include "JSONColumns.h"
+#include "JSONTape.h"
+#include "RawScan.h"
+#include "SIMDScan.h"
+
+#include <bit>
+#include <charconv>
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		bool isNumberText(std::string_view pRaw) noexcept
+		{
+			char c = pRaw.front();
+			return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+		}
+
+		template<typename T>
+		std::errc parseNumber(std::string_view pRaw, T& pNumber) noexcept
+		{
+			if (pRaw.front() == '+')
+				pRaw.remove_prefix(1);
+			const char* end = pRaw.data() + pRaw.size();
+			auto [ptr, errorCode] = std::from_chars(pRaw.data(), end, pNumber);
+			return errorCode == std::errc() && ptr != end ? std::errc::invalid_argument : errorCode;
+		}
+	}
+
+	//
+	// JSONColumn
+	//
+
+	JSONColumn::JSONColumn(std::string pName, ColumnType pType)
+		: mName(std::move(pName)), mType(pType)
+	{
+	}
+
+	size_t JSONColumn::getNullCount() const noexcept
+	{
+		size_t count{};
+		for (uint64_t word : mNulls)
+			count += static_cast<size_t>(std::popcount(word));
+		return count;
+	}
+
+	void JSONColumn::appendNull()
+	{
+		if (mSize % 64 == 0)
+			mNulls.push_back(0);
+		mNulls.back() |= uint64_t{ 1 } << (mSize % 64);
+		++mSize;
+		switch (mType)
+		{
+		case ColumnType::INT64:  mInts.push_back(0);				  break;
+		case ColumnType::DOUBLE: mDoubles.push_back(0.0);			  break;
+		case ColumnType::STRING: mOffsets.push_back(mChars.size()); break;
+		}
+	}
+
+	JSONStatus JSONColumn::append(std::string_view pRaw, size_t pPosition)
+	{
+		if (pRaw.data() == nullptr || pRaw == "null")
+		{
+			appendNull();
+			return {};
+		}
+
+		switch (mType)
+		{
+		case ColumnType::INT64:
+		{
+			int64_t number{};
+			if (!isNumberText(pRaw))
+				return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pPosition));
+			std::errc errorCode = parseNumber(pRaw, number);
+			if (errorCode == std::errc::result_out_of_range)
+				return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, pPosition));
+			if (errorCode != std::errc())
+			{
+				// a float in an integer column;
+				bool isFloat = pRaw.find_first_of(".eE") != std::string_view::npos;
+				return std::unexpected(makeError(isFloat ? JSONErrorCode::TYPE_MISMATCH : JSONErrorCode::INVALID_NUMBER, pPosition));
+			}
+			mInts.push_back(number);
+			break;
+		}
+		case ColumnType::DOUBLE:
+		{
+			double number{};
+			if (!isNumberText(pRaw))
+				return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pPosition));
+			std::errc errorCode = parseNumber(pRaw, number);
+			if (errorCode == std::errc::result_out_of_range)
+				return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, pPosition));
+			if (errorCode != std::errc())
+				return std::unexpected(makeError(JSONErrorCode::INVALID_NUMBER, pPosition));
+			mDoubles.push_back(number);
+			break;
+		}
+		case ColumnType::STRING:
+		{
+			if (pRaw.front() != '"')
+				mChars.append(pRaw);
+			else if (pRaw.find('\\') == std::string_view::npos)
+				mChars.append(pRaw.substr(1, pRaw.size() - 2));
+			else
+			{
+				JSONResult<std::string> text = JSONTape::decodeString(pRaw);
+				if (!text)
+					return std::unexpected(makeError(text.error().mCode, pPosition + text.error().mPosition));
+				mChars.append(*text);
+			}
+			mOffsets.push_back(mChars.size());
+			break;
+		}
+		}
+
+		if (mSize % 64 == 0)
+			mNulls.push_back(0);
+		++mSize;
+		return {};
+	}
+
+	void JSONColumn::truncate(size_t pRows)
+	{
+		if (pRows >= mSize)
+			return;
+		mSize = pRows;
+		mNulls.resize((pRows + 63) / 64);
+		if (pRows % 64 != 0)
+			mNulls.back() &= (uint64_t{ 1 } << (pRows % 64)) - 1;
+		switch (mType)
+		{
+		case ColumnType::INT64:  mInts.resize(pRows);	 break;
+		case ColumnType::DOUBLE: mDoubles.resize(pRows); break;
+		case ColumnType::STRING:
+			mChars.resize(mOffsets[pRows]);
+			mOffsets.resize(pRows + 1);
+			break;
+		}
+	}
+
+	//
+	// ColumnarExtractor
+	//
+
+	JSONResult<ColumnarExtractor> ColumnarExtractor::create(std::span<const ColumnSpec> pColumns)
+	{
+		ColumnarExtractor extractor;
+		for (const ColumnSpec& spec : pColumns)
+		{
+			if (!extractor.mIndices.emplace(spec.mName, static_cast<uint32_t>(extractor.mColumns.size())).second)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+			extractor.mColumns.push_back(JSONColumn(spec.mName, spec.mType));
+		}
+		extractor.mValues.resize(pColumns.size());
+		extractor.mPositions.resize(pColumns.size());
+		return extractor;
+	}
+
+	JSONResult<ColumnarExtractor> ColumnarExtractor::create(std::initializer_list<ColumnSpec> pColumns)
+	{
+		return create(std::span<const ColumnSpec>(pColumns.begin(), pColumns.size()));
+	}
+
+	const JSONColumn* ColumnarExtractor::getColumn(std::string_view pName) const noexcept
+	{
+		auto it = mIndices.find(pName);
+		return it != mIndices.end() ? &mColumns[it->second] : nullptr;
+	}
+
+	void ColumnarExtractor::clear()
+	{
+		for (JSONColumn& column : mColumns)
+			column = JSONColumn(column.mName, column.mType);
+		mRows = 0;
+	}
+
+	JSONStatus ColumnarExtractor::rollback(size_t pRows, JSONError pError)
+	{
+		for (JSONColumn& column : mColumns)
+			column.truncate(pRows);
+		mRows = pRows;
+		return std::unexpected(pError);
+	}
+
+	JSONStatus ColumnarExtractor::addRecord(std::string_view pText)
+	{
+		size_t rows = mRows;
+		size_t position = raw::skipSpaces(pText, 0);
+		if (JSONStatus status = readRecord(pText, position); !status)
+			return rollback(rows, status.error());
+		if (raw::skipSpaces(pText, position) != pText.size())
+			return rollback(rows, makeError(JSONErrorCode::INVALID_TEXT, position));
+		return {};
+	}
+
+	JSONStatus ColumnarExtractor::addArray(std::string_view pText)
+	{
+		size_t rows = mRows;
+		size_t position = raw::skipSpaces(pText, 0);
+		if (position >= pText.size() || pText[position] != '[')
+			return std::unexpected(makeError(JSONErrorCode::INVALID_ARRAY, position));
+
+		position = raw::skipSeparators(pText, position + 1);
+		while (true)
+		{
+			if (position >= pText.size())
+				return rollback(rows, makeError(JSONErrorCode::INVALID_ARRAY, position));
+			if (pText[position] == ']')
+				break;
+			if (JSONStatus status = readRecord(pText, position); !status)
+				return rollback(rows, status.error());
+			position = raw::skipSeparators(pText, position);
+		}
+		if (raw::skipSpaces(pText, position + 1) != pText.size())
+			return rollback(rows, makeError(JSONErrorCode::INVALID_TEXT, position + 1));
+		return {};
+	}
+
+	JSONStatus ColumnarExtractor::addNDJSON(std::string_view pText)
+	{
+		size_t rows = mRows;
+		JSONStatus result;
+		size_t begin{};
+		auto addLine = [&](size_t pEnd)
+			{
+				size_t lineBegin = begin;
+				begin = pEnd + 1;
+				if (!result)
+					return;
+				if (pEnd > lineBegin && pText[pEnd - 1] == '\r')
+					--pEnd;
+				std::string_view line = pText.substr(0, pEnd);
+				size_t position = raw::skipSpaces(line, lineBegin);
+				if (position == line.size())
+					return;
+				if (JSONStatus status = readRecord(line, position); !status)
+					result = status;
+				else if (raw::skipSpaces(line, position) != line.size())
+					result = std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			};
+		simd::forEachChar(pText, '\n', addLine);
+		if (begin < pText.size())
+			addLine(pText.size());
+
+		if (!result)
+			return rollback(rows, result.error());
+		return {};
+	}
+
+	JSONStatus ColumnarExtractor::readRecord(std::string_view pText, size_t& pPosition)
+	{
+		if (pPosition >= pText.size() || pText[pPosition] != '{')
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pPosition));
+		for (std::string_view& value : mValues)
+			value = std::string_view();
+
+		size_t position = raw::skipSeparators(pText, pPosition + 1);
+		while (true)
+		{
+			if (position >= pText.size())
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			if (pText[position] == '}')
+				break;
+
+			size_t keyEnd = raw::skipValue(pText, position);
+			if (keyEnd == std::string_view::npos || pText[position] == '{' || pText[position] == '[')
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			auto it = mIndices.find(raw::getKey(pText.substr(position, keyEnd - position), mKeyStorage));
+
+			position = raw::skipSpaces(pText, keyEnd);
+			if (position >= pText.size() || pText[position] != ':')
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			position = raw::skipSpaces(pText, position + 1);
+
+			size_t valueEnd = raw::skipValue(pText, position);
+			if (valueEnd == std::string_view::npos)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			// the last of repeated members wins;
+			if (it != mIndices.end())
+			{
+				mValues[it->second] = pText.substr(position, valueEnd - position);
+				mPositions[it->second] = position;
+			}
+			position = raw::skipSeparators(pText, valueEnd);
+		}
+		pPosition = position + 1;
+
+		for (size_t i = 0; i < mColumns.size(); ++i)
+		{
+			if (JSONStatus status = mColumns[i].append(mValues[i], mPositions[i]); !status)
+				return status;
+		}
+		++mRows;
+		return {};
+	}
+}
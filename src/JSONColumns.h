@@ -0,0 +1,212 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	enum class ColumnType : uint8_t
+	{
+		INT64,
+		DOUBLE,
+		STRING
+	};
+
+	//
+	// a column to extract: the key of a top-level member of every record and the type of the column;
+	//
+	struct ColumnSpec
+	{
+		std::string mName;
+		ColumnType mType{ ColumnType::INT64 };
+	};
+
+	//
+	// one column of records (struct of arrays):
+	// INT64  - getInts(), one value per row;
+	// DOUBLE - getDoubles(), one value per row, integers are converted;
+	// STRING - all strings one after another in getChars(), the row i is [offsets[i], offsets[i + 1]);
+	//			values of other types are kept as their JSON text;
+	// a missing member or null sets the bit of the row in the null bitmap, its value is 0 or an empty string;
+	//
+	class JSONColumn
+	{
+	public:
+		const std::string& getName() const noexcept;
+		ColumnType getType() const noexcept;
+		size_t size() const noexcept;
+
+		std::span<const int64_t> getInts() const noexcept;
+		std::span<const double> getDoubles() const noexcept;
+		std::string_view getChars() const noexcept;
+		std::span<const uint64_t> getOffsets() const noexcept;
+		std::string_view getString(size_t pRow) const noexcept;
+
+		//
+		// bit (pRow % 64) of word (pRow / 64) is set if the row is null;
+		//
+		std::span<const uint64_t> getNullBitmap() const noexcept;
+		bool isNull(size_t pRow) const noexcept;
+		size_t getNullCount() const noexcept;
+
+	private:
+		friend class ColumnarExtractor;
+
+		JSONColumn(std::string pName, ColumnType pType);
+
+		//
+		// appends the value of one row; pRaw.data() == nullptr means the member is missing;
+		// pPosition is the offset of the value for errors;
+		//
+		JSONStatus append(std::string_view pRaw, size_t pPosition);
+		void appendNull();
+
+		//
+		// drops rows after the first pRows;
+		//
+		void truncate(size_t pRows);
+
+	private:
+		std::string mName;
+		ColumnType mType;
+		size_t mSize{};
+		std::vector<int64_t> mInts;
+		std::vector<double> mDoubles;
+		std::string mChars;
+		std::vector<uint64_t> mOffsets{ 0 };
+		std::vector<uint64_t> mNulls;
+	};
+
+	//
+	// extracts typed columns from arrays of objects and NDJSON straight from the text,
+	// without building JSONObject or JSONValue for a record; members without a column are stepped over;
+	// rows of every call are appended to the rows of previous calls;
+	//
+	// JSONResult<ColumnarExtractor> extractor = ColumnarExtractor::create({ { "id", ColumnType::INT64 },
+	//																		 { "price", ColumnType::DOUBLE } });
+	// extractor->addNDJSON(text);
+	// std::span<const double> prices = extractor->getColumn("price")->getDoubles();
+	//
+	class ColumnarExtractor
+	{
+	public:
+		//
+		// returns INVALID_TEXT if a name is repeated;
+		//
+		static JSONResult<ColumnarExtractor> create(std::span<const ColumnSpec> pColumns);
+		static JSONResult<ColumnarExtractor> create(std::initializer_list<ColumnSpec> pColumns);
+
+		//
+		// appends records of a top-level array of objects, of NDJSON (empty lines are skipped,
+		// a trailing '\r' is removed) or one record;
+		// on error no row of the call is kept and the position is an offset into pText;
+		//
+		JSONStatus addArray(std::string_view pText);
+		JSONStatus addNDJSON(std::string_view pText);
+		JSONStatus addRecord(std::string_view pText);
+
+		size_t getRowCount() const noexcept;
+		std::span<const JSONColumn> getColumns() const noexcept;
+
+		//
+		// returns nullptr if there is no such column;
+		//
+		const JSONColumn* getColumn(std::string_view pName) const noexcept;
+
+		void clear();
+
+	private:
+		ColumnarExtractor() = default;
+
+		//
+		// reads the object at pPosition into one row; pPosition is moved after it;
+		//
+		JSONStatus readRecord(std::string_view pText, size_t& pPosition);
+		JSONStatus rollback(size_t pRows, JSONError pError);
+
+	private:
+		std::vector<JSONColumn> mColumns;
+		std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> mIndices;
+		size_t mRows{};
+		// values of the current record, one per column;
+		std::vector<std::string_view> mValues;
+		std::vector<size_t> mPositions;
+		std::string mKeyStorage;
+	};
+
+	//
+	// JSONColumn implementation
+	//
+
+	inline const std::string& JSONColumn::getName() const noexcept
+	{
+		return mName;
+	}
+
+	inline ColumnType JSONColumn::getType() const noexcept
+	{
+		return mType;
+	}
+
+	inline size_t JSONColumn::size() const noexcept
+	{
+		return mSize;
+	}
+
+	inline std::span<const int64_t> JSONColumn::getInts() const noexcept
+	{
+		return mInts;
+	}
+
+	inline std::span<const double> JSONColumn::getDoubles() const noexcept
+	{
+		return mDoubles;
+	}
+
+	inline std::string_view JSONColumn::getChars() const noexcept
+	{
+		return mChars;
+	}
+
+	inline std::span<const uint64_t> JSONColumn::getOffsets() const noexcept
+	{
+		return mOffsets;
+	}
+
+	inline std::string_view JSONColumn::getString(size_t pRow) const noexcept
+	{
+		if (pRow + 1 >= mOffsets.size())
+			return {};
+		return std::string_view(mChars).substr(mOffsets[pRow], mOffsets[pRow + 1] - mOffsets[pRow]);
+	}
+
+	inline std::span<const uint64_t> JSONColumn::getNullBitmap() const noexcept
+	{
+		return mNulls;
+	}
+
+	inline bool JSONColumn::isNull(size_t pRow) const noexcept
+	{
+		return pRow < mSize && ((mNulls[pRow / 64] >> (pRow % 64)) & 1) != 0;
+	}
+
+	//
+	// ColumnarExtractor implementation
+	//
+
+	inline size_t ColumnarExtractor::getRowCount() const noexcept
+	{
+		return mRows;
+	}
+
+	inline std::span<const JSONColumn> ColumnarExtractor::getColumns() const noexcept
+	{
+		return mColumns;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+
+namespace tng
+{
+	//
+	// error codes of the exception-free pipeline;
+	//
+	enum class JSONErrorCode : uint8_t
+	{
+		NONE = 0,
+		INVALID_TEXT = 1,
+		INVALID_CHARACTER = 2,
+		UNKNOWN_TOKEN = 3,
+		INVALID_NUMBER = 4,
+		NUMBER_OUT_OF_RANGE = 5,
+		INVALID_ARRAY = 6,
+		MISSING_KEY = 7,
+		TYPE_MISMATCH = 8,
+		FILE_ERROR = 9,
+		SCHEMA_VIOLATION = 10
+	};
+
+	//
+	// returns a static description of the error code; never allocates;
+	//
+	const char* toString(JSONErrorCode pCode) noexcept;
+
+	//
+	// error which is returned instead of being thrown;
+	// mPosition is an offset into the lexer's input (0 if unknown);
+	//
+	struct JSONError
+	{
+		JSONErrorCode mCode{ JSONErrorCode::NONE };
+		uint32_t mPosition{};
+	};
+
+	//
+	// result type of the exception-free functions (the ones with the "try" prefix);
+	// JSONResult<JSONObject> object = jsonObject.tryCreateObjFromTokens(lexer);
+	// if (!object)
+	//		std::cout << toString(object.error().mCode);
+	//
+	template<typename T>
+	using JSONResult = std::expected<T, JSONError>;
+	using JSONStatus = std::expected<void, JSONError>;
+}
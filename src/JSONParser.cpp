@@ -1,42 +1,80 @@
 #include "JSONParser.h"
+#include "ThreadPool.h"
+#include "JSONSerializer.h"
+#include "JSONSnapshot.h"
+#include "JSONTape.h"
+#include "RawScan.h"
 
 namespace tng
 {
-	tng::JSONException::JSONException(const char* pMessage)
+	const char* toString(JSONErrorCode pCode) noexcept
+	{
+		switch (pCode)
+		{
+		case JSONErrorCode::NONE:				 return "No error";
+		case JSONErrorCode::INVALID_TEXT:		 return "The text is not valid";
+		case JSONErrorCode::INVALID_CHARACTER:	 return "Invalid character";
+		case JSONErrorCode::UNKNOWN_TOKEN:		 return "The type of this token doesnt exist";
+		case JSONErrorCode::INVALID_NUMBER:		 return "Invalid number";
+		case JSONErrorCode::NUMBER_OUT_OF_RANGE: return "Number is out of range";
+		case JSONErrorCode::INVALID_ARRAY:		 return "The passed string is not an array";
+		case JSONErrorCode::MISSING_KEY:		 return "Storage does not contain the key";
+		case JSONErrorCode::TYPE_MISMATCH:		 return "Value has another type";
+		case JSONErrorCode::FILE_ERROR:			 return "Couldnt open the file";
+		case JSONErrorCode::SCHEMA_VIOLATION:	 return "Value does not match the schema";
+		}
+		return "Unknown error";
+	}
+
+	tng::JSONException::JSONException(const char* pMessage) noexcept
 	{
 		assignMessage(pMessage);
 	}
 
-	tng::JSONException::JSONException(const std::exception& pException)
+	tng::JSONException::JSONException(const std::exception& pException) noexcept
 	{
 		assignMessage(pException.what());
 	}
 
-	tng::JSONException::~JSONException()
+	tng::JSONException::JSONException(const JSONError& pError) noexcept
+		: mErrorCode(pError.mCode)
 	{
-		delete[] mMessage;
+		assignMessage(toString(pError.mCode));
+		
+		// appends " [CURRENT_POS_STRING] N" without std::format;
+		constexpr std::string_view positionTag = " [CURRENT_POS_STRING] ";
+		size_t length = std::strlen(mMessage);
+		if (length + positionTag.size() + 11 > mMaxMessageSize)
+			return;
+		std::memcpy(mMessage + length, positionTag.data(), positionTag.size());
+		length += positionTag.size();
+		auto [end, errorCode] = std::to_chars(mMessage + length, mMessage + mMaxMessageSize - 1, pError.mPosition);
+		*end = '\0';
 	}
 
 	const char* tng::JSONException::what() const noexcept
 	{
-		return mMessage == nullptr ? "Nothing" : mMessage;
+		return mMessage[0] == '\0' ? "Nothing" : mMessage;
 	}
 
-	void tng::JSONException::eraseMessage()
+	JSONErrorCode JSONException::getErrorCode() const noexcept
 	{
-		if (mMessage != nullptr)
-		{
-			delete[] mMessage;
-			mMessage = nullptr;
-		}
+		return mErrorCode;
+	}
+
+	void tng::JSONException::eraseMessage() noexcept
+	{
+		mMessage[0] = '\0';
 	}
 
-	void tng::JSONException::assignMessage(const char* pMessage)
+	void tng::JSONException::assignMessage(const char* pMessage) noexcept
 	{
 		eraseMessage();
-		auto length = sizeof(pMessage);
-		mMessage = new char[length];
-		std::strcpy(mMessage, pMessage);
+		if (pMessage == nullptr)
+			return;
+		size_t length = std::min(std::strlen(pMessage), mMaxMessageSize - 1);
+		std::memcpy(mMessage, pMessage, length);
+		mMessage[length] = '\0';
 	}
 
 	tng::JSONValue::JSONValue(const std::initializer_list<JSONValue>& pArray)
@@ -56,12 +94,38 @@ namespace tng
 		mTypeVariant = typeVariant::VECTOR;
 	}
 
+	JSONValue::JSONValue(std::vector<JSONValue>&& pArray)
+	{
+		mValue = std::move(pArray);
+		mTypeVariant = typeVariant::VECTOR;
+	}
+
 	JSONValue::JSONValue(const std::vector<std::vector<JSONValue>>& pArrray)
 	{
 		mValue = pArrray;
 		mTypeVariant = typeVariant::NESTED_ARRAY;
 	}
 
+	JSONValue::JSONValue(const JSONObject& pObject)
+	{
+		mValue = std::make_shared<const JSONObject>(pObject);
+		mTypeVariant = typeVariant::OBJECT;
+	}
+
+	JSONValue::JSONValue(JSONObject&& pObject)
+	{
+		mValue = std::make_shared<const JSONObject>(std::move(pObject));
+		mTypeVariant = typeVariant::OBJECT;
+	}
+
+	JSONValue::JSONValue(std::shared_ptr<const JSONObject> pObject)
+	{
+		if (pObject == nullptr)
+			throw JSONException("Passed object is null!\n");
+		mValue = std::move(pObject);
+		mTypeVariant = typeVariant::OBJECT;
+	}
+
 	void tng::JSONValue::setArray(const std::initializer_list<JSONValue>& pArray)
 	{
 		mValue = pArray;
@@ -122,6 +186,13 @@ namespace tng
 		return std::get<std::vector<std::vector<JSONValue>>>(mValue);
 	}
 
+	const JSONObject& JSONValue::getObject() const
+	{
+		if (mTypeVariant != typeVariant::OBJECT)
+			throw JSONException("Variant doesnt hold object!\n");
+		return *std::get<std::shared_ptr<const JSONObject>>(mValue);
+	}
+
 	bool tng::JSONValue::valueIsString() const noexcept
 	{
 		return mValue.index() == std::underlying_type_t<typeVariant>(typeVariant::STRING);
@@ -157,6 +228,16 @@ namespace tng
 		return mValue.index() == std::underlying_type_t<typeVariant>(typeVariant::NESTED_ARRAY);
 	}
 
+	bool JSONValue::valueIsNull() const noexcept
+	{
+		return mValue.index() == std::underlying_type_t<typeVariant>(typeVariant::NULLTYPE);
+	}
+
+	bool JSONValue::valueIsObject() const noexcept
+	{
+		return mValue.index() == std::underlying_type_t<typeVariant>(typeVariant::OBJECT);
+	}
+
 	//
 	// JSONObject implementation
 	//
@@ -186,6 +267,11 @@ namespace tng
 		mKeyValueStrg.insert_or_assign(std::string(pKey), pValue);
 	}
 
+	void tng::JSONObject::addObject(std::string_view pKey, JSONValue&& pValue)
+	{
+		mKeyValueStrg.insert_or_assign(std::string(pKey), std::move(pValue));
+	}
+
 	bool tng::JSONObject::tryMove(std::string_view pKey, const JSONValue& pValue)
 	{
 		if (!mKeyValueStrg.contains(std::string(pKey)))
@@ -242,7 +328,15 @@ namespace tng
 		}
 	}
 
-	tng::JSONObject JSONObject::createObjFromTokens(JSONLexer pTokens)
+	tng::JSONObject JSONObject::createObjFromTokens(JSONLexer& pTokens)
+	{
+		JSONResult<tng::JSONObject> object = tryCreateObjFromTokens(pTokens);
+		if (!object)
+			throw JSONException(object.error());
+		return std::move(*object);
+	}
+
+	JSONResult<tng::JSONObject> JSONObject::tryCreateObjFromTokens(JSONLexer& pTokens)
 	{
 		bool isKey = false;
 
@@ -252,6 +346,39 @@ namespace tng
 
 		tng::JSONObject tmpObject;
 
+		// inside an array every text element is written quoted (with '"' and '\\' escaped),
+		// thus parseArray() steps over a ',', '[' or ']' which belongs to a string;
+		uint32_t arrayDepth{};
+		bool inArrayString = false;
+		auto appendText = [&](std::string_view pText)
+			{
+				if (arrayDepth == 0)
+				{
+					tmpValue += pText;
+					return;
+				}
+				if (!inArrayString)
+				{
+					tmpValue.push_back('"');
+					inArrayString = true;
+				}
+				for (char c : pText)
+				{
+					if (c == '"' || c == '\\')
+						tmpValue.push_back('\\');
+					tmpValue.push_back(c);
+				}
+			};
+		auto closeArrayString = [&]()
+			{
+				if (!inArrayString)
+					return;
+				while (tmpValue.back() == ' ')
+					tmpValue.pop_back();
+				tmpValue.push_back('"');
+				inArrayString = false;
+			};
+
 		for ( ; pTokens.getIndexOfCurrentToken() < pTokens.getNumberTokens() - 1; )
 		{
 			if (pTokens.currentToken().mTokenType == tng::JSONLexer::TokenType::COLON)
@@ -283,19 +410,24 @@ namespace tng
 				}
 				break;
 			case tng::JSONLexer::TokenType::LBRACKET:
+				closeArrayString();
+				arrayDepth++;
 				tmpValue.push_back('[');
 				break;
 			case tng::JSONLexer::TokenType::RBRACKET:
+				closeArrayString();
+				arrayDepth -= arrayDepth != 0 ? 1 : 0;
 				tmpValue.push_back(']');
 				break;
 			case tng::JSONLexer::TokenType::COMMA:
+				closeArrayString();
 				tmpValue.push_back(',');
 				break;
 			case tng::JSONLexer::TokenType::COLON:
 				tmpValue.push_back(':');
 				break;
 			case tng::JSONLexer::TokenType::STRING:
-				tmpValue += pTokens.currentToken().mDefinition;
+				appendText(pTokens.currentToken().mDefinition);
 				break;
 			case tng::JSONLexer::TokenType::NUMBER:
 				tmpValue += pTokens.currentToken().mDefinition;
@@ -304,7 +436,7 @@ namespace tng
 				tmpValue += pTokens.currentToken().mDefinition;
 				break;
 			case tng::JSONLexer::TokenType::ESCAPESEQ:
-				tmpValue += pTokens.currentToken().mDefinition;
+				appendText(pTokens.currentToken().mDefinition);
 				break;
 			case tng::JSONLexer::TokenType::MINUS:
 				tmpValue.push_back('-');
@@ -317,34 +449,35 @@ namespace tng
 					tmpValue.push_back(' ');
 				break;
 			case tng::JSONLexer::TokenType::UNICODE:
-				tmpValue += pTokens.currentToken().mDefinition;
+				appendText(pTokens.currentToken().mDefinition);
 				break;
 			default:
-				throw JSONException("The type of this token doesnt exist!");
+				return std::unexpected(JSONError{ JSONErrorCode::UNKNOWN_TOKEN, pTokens.getIndexOfCurrentToken() });
 			}
 			if (!tmpValue.empty() &&
 				*(tmpValue.end() - 1) == '\n')
 			{
 				tmpObject.helperEscapeSeq(tmpKey, counterBraces);
 				if (tmpValue.contains('[') && tmpValue.contains(']'))
-					tmpObject.addArray(tmpKey, tmpValue, tmpObject);
+				{
+					if (JSONStatus status = tmpObject.addArray(tmpKey, tmpValue); !status)
+						return std::unexpected(status.error());
+				}
 				else if (std::isdigit(tmpValue[0]) ||
 						 std::isdigit(tmpValue[1]))
 				{
-					if (tmpValue.contains('.') ||
-						tmpValue.contains('e') ||
-						tmpValue.contains('E'))
-						tmpObject.addObject(tmpKey, tng::JSONValue(std::stof(tmpValue)));
-					else if(tmpValue.contains('-'))
-						tmpObject.addObject(tmpKey, tng::JSONValue(std::stoi(tmpValue)));
-					else 
-						tmpObject.addObject(tmpKey, tng::JSONValue(uint32_t(std::stoul(tmpValue))));
+					JSONResult<tng::JSONValue> number = toNumber(tmpValue);
+					if (!number)
+						return std::unexpected(number.error());
+					tmpObject.addObject(tmpKey, *number);
 				}
 				else
 				{
 					tmpObject.addObject(tmpKey, tng::JSONValue(std::string(tmpValue)));
 				}
 				tmpValue.clear();
+				arrayDepth = 0;
+				inArrayString = false;
 			}
 		}
  		return tmpObject;
@@ -375,18 +508,24 @@ namespace tng
 
 	bool tng::JSONObject::contains(std::string_view pKey) const noexcept
 	{
-		return mKeyValueStrg.contains(std::string(pKey));
+		return mKeyValueStrg.contains(pKey);
 	}
 
 	std::optional<tng::JSONValue> tng::JSONObject::tryGetValue(std::string_view pKey) noexcept
 	{
-		if (!mKeyValueStrg.contains(std::string(pKey)) ||
-			mKeyValueStrg.empty())
+		const JSONValue* value = findValue(pKey);
+		if (value == nullptr)
 			return std::nullopt;
-		return mKeyValueStrg[std::string(pKey)];
+		return *value;
 	}
 
-	const std::unordered_map<std::string, JSONValue>& JSONObject::getStorage() const noexcept
+	const JSONValue* JSONObject::findValue(std::string_view pKey) const noexcept
+	{
+		auto it = mKeyValueStrg.find(pKey);
+		return it == mKeyValueStrg.end() ? nullptr : &it->second;
+	}
+
+	const JSONObject::Storage& JSONObject::getStorage() const noexcept
 	{
 		return mKeyValueStrg;
 	}
@@ -422,94 +561,162 @@ namespace tng
 		}
 	}
 
-	void JSONObject::addArray(std::string& pKey, std::string& pArray,
-							  tng::JSONObject& pObject)
+	JSONStatus JSONObject::addArray(std::string_view pKey, std::string_view pArray)
 	{
-		static uint32_t counterBraces = std::count(pArray.begin(), pArray.end(), '[');
-		static uint32_t currentCounterBraces = 0; 
-		if (pArray.find(']') != std::string::npos &&
-			pArray.find('[') != std::string::npos)
-		{
-			currentCounterBraces++;
-			if(pArray[pArray.size() - 1] == '\n')
-				pArray.erase(pArray.size() - 2, 1);
-			else
-				pArray.erase(pArray.size() - 1, 1);
-			pArray.erase(0, 1);
-		}
-		else
-			throw JSONException("The passed string is not an array in function addArray()!\n");
+		JSONResult<tng::JSONValue> array = parseArray(pArray);
+		if (!array)
+			return std::unexpected(array.error());
+		addObject(pKey, *array);
+		return {};
+	}
 
-		std::vector<JSONValue> mHelperStorage;
+	JSONResult<tng::JSONValue> JSONObject::parseArray(std::string_view pArray) const
+	{
+		// every open bracket has its own level, thus depth is limited only by memory;
+		std::vector<std::vector<tng::JSONValue>> levels;
+		std::optional<tng::JSONValue> result;
+		size_t elementStart{};
+		// the gap between a nested array and the next separator is the only empty element;
+		bool afterArray = false;
 
-		size_t start{}, end{};
-		while ((end = pArray.find(',', start)) != std::string::npos)
+		for (size_t i = 0; i < pArray.size(); ++i)
 		{
-			std::string element = pArray.substr(start, end - start);
-			if (!element.empty())
+			char c = pArray[i];
+			if (c == '"' && !levels.empty())
+			{
+				// separators and brackets inside a string belong to it;
+				size_t end = simd::skipString(pArray, i);
+				if (end == std::string_view::npos)
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(i) });
+				i = end - 1;
+			}
+			else if (c == '[')
 			{
-				if (element.find('[') != std::string::npos)
+				if (result.has_value())
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(i) });
+				levels.emplace_back();
+				elementStart = i + 1;
+				afterArray = false;
+			}
+			else if (c == ',' || c == ']')
+			{
+				if (levels.empty())
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(i) });
+				std::string_view element = pArray.substr(elementStart, i - elementStart);
+				bool isEmpty = element.find_first_not_of(" \t\r\n") == std::string_view::npos;
+				// "[]" is an empty array, not an empty element;
+				bool isEmptyArray = c == ']' && levels.back().empty() && pArray[elementStart - 1] == '[';
+				if (!isEmpty)
 				{
-					uint32_t startSubArray{}, endSubArray{};
-					startSubArray = pArray.find('[');
-					endSubArray = pArray.find(']');
-					std::string subArray = pArray.substr(startSubArray, endSubArray + 1);
-					if (subArray.find_last_of('\n') != std::string::npos)
-						subArray.erase(subArray.size() - 1, 1);
-					currentCounterBraces--;
-					addArray(pKey, subArray, pObject);
-					currentCounterBraces++;
-					pArray.erase(0, endSubArray + 2);
-					continue;
+					if (JSONStatus status = addElement(element, levels.back()); !status)
+						return std::unexpected(JSONError{ status.error().mCode, static_cast<uint32_t>(elementStart) });
 				}
-				if (std::any_of(element.begin(), element.end(), [](char pChar) { return std::isdigit(pChar); }))
-					addNumber(element, mHelperStorage);
-				else
-					mHelperStorage.emplace_back(tng::JSONValue(std::string(element)));
-			}	
-			start = end + 1;
+				else if (!afterArray && !isEmptyArray)
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(i) });
+				afterArray = false;
+				if (c == ']')
+				{
+					tng::JSONValue array(std::move(levels.back()));
+					levels.pop_back();
+					if (levels.empty())
+						result = std::move(array);
+					else
+					{
+						levels.back().emplace_back(std::move(array));
+						afterArray = true;
+					}
+				}
+				elementStart = i + 1;
+			}
+			else if (levels.empty() && !std::isspace(static_cast<unsigned char>(c)))
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(i) });
 		}
 
-		if (start < pArray.size())
+		if (!levels.empty() || !result.has_value())
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY, static_cast<uint32_t>(pArray.size()) });
+		return std::move(*result);
+	}
+
+	JSONStatus JSONObject::addElement(std::string_view pElement, std::vector<tng::JSONValue>& pStorage) const
+	{
+		while (!pElement.empty() && std::isspace(static_cast<unsigned char>(pElement.front())))
+			pElement.remove_prefix(1);
+		while (!pElement.empty() && std::isspace(static_cast<unsigned char>(pElement.back())))
+			pElement.remove_suffix(1);
+		if (pElement.empty())
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY });
+
+		if (pElement.front() == '"')
 		{
-			std::string element = pArray.substr(start);
-			if (element.find_last_of('\n') != std::string::npos)
-				element.erase(element.size() - 1, 1);
-			if (!element.empty())
+			// a quoted string: only \" and \\ are unescaped, other sequences are kept as they are;
+			if (pElement.size() < 2 || simd::skipString(pElement, 0) != pElement.size())
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_ARRAY });
+			std::string text;
+			text.reserve(pElement.size() - 2);
+			for (size_t i = 1; i + 1 < pElement.size(); ++i)
 			{
-				if (std::any_of(element.begin(), element.end(), [](char pChar) { return std::isdigit(pChar); }))
-					addNumber(element, mHelperStorage);
-				else
-					mHelperStorage.emplace_back(tng::JSONValue(std::string(element)));
+				if (pElement[i] == '\\' && (pElement[i + 1] == '"' || pElement[i + 1] == '\\') && i + 2 < pElement.size())
+					++i;
+				text.push_back(pElement[i]);
 			}
+			pStorage.emplace_back(std::move(text));
+			return {};
 		}
-
-		if (currentCounterBraces == counterBraces)
-		{
-			mNestedArrays.push_back(mHelperStorage);
-			pObject.addObject(pKey, tng::JSONValue(mNestedArrays));
-		}
-		else
-			mNestedArrays.push_back(mHelperStorage);
 		
+		if (std::isdigit(static_cast<unsigned char>(pElement.front())) ||
+			pElement.front() == '-' || pElement.front() == '+' || pElement.front() == '.')
+			return addNumber(pElement, pStorage);
+		if (pElement == "true" || pElement == "false")
+			pStorage.emplace_back(pElement == "true");
+		else if (pElement == "null")
+			pStorage.emplace_back(nullptr);
+		else
+			pStorage.emplace_back(std::string(pElement));
+		return {};
+	}
+
+	JSONStatus JSONObject::addNumber(std::string_view pNumber, std::vector<tng::JSONValue>& pStorage) const
+	{
+		JSONResult<tng::JSONValue> number = toNumber(pNumber);
+		if (!number)
+			return std::unexpected(number.error());
+		pStorage.emplace_back(std::move(*number));
+		return {};
 	}
 
-	void JSONObject::addNumber(std::string_view pNumber, std::vector<tng::JSONValue>& pStorage)
+	JSONResult<tng::JSONValue> JSONObject::toNumber(std::string_view pNumber) const noexcept
 	{
-		if (pNumber.find('E') != std::string::npos ||
-			pNumber.find('e') != std::string::npos ||
-			pNumber.find('.') != std::string::npos)
+		while (!pNumber.empty() && (std::isspace(static_cast<unsigned char>(pNumber.front())) || pNumber.front() == '+'))
+			pNumber.remove_prefix(1);
+
+		const char* begin = pNumber.data();
+		const char* end = pNumber.data() + pNumber.size();
+		std::from_chars_result result{};
+		tng::JSONValue value;
+		if (pNumber.find_first_of(".eE") != std::string_view::npos)
 		{
-			pStorage.emplace_back(tng::JSONValue(std::stof(std::string(pNumber))));
+			float number{};
+			result = std::from_chars(begin, end, number);
+			value = tng::JSONValue(number);
 		}
-		else if (pNumber.find('-') != std::string::npos)
+		else if (pNumber.find('-') != std::string_view::npos)
 		{
-			pStorage.emplace_back(std::stoi(std::string(pNumber)));
+			int32_t number{};
+			result = std::from_chars(begin, end, number);
+			value = tng::JSONValue(number);
 		}
 		else
 		{
-			pStorage.emplace_back(uint32_t(std::stoul(std::string(pNumber))));
+			uint32_t number{};
+			result = std::from_chars(begin, end, number);
+			value = tng::JSONValue(number);
 		}
+
+		if (result.ec == std::errc::result_out_of_range)
+			return std::unexpected(JSONError{ JSONErrorCode::NUMBER_OUT_OF_RANGE });
+		if (result.ec != std::errc())
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_NUMBER });
+		return value;
 	}
 
 	bool JSONObject::isSpecialChar(char pChar) const noexcept
@@ -524,50 +731,411 @@ namespace tng
 	}
 
 	//
-	// JSONParser class implementation
+	// stateless parse implementation
 	//
-	
-	nlohmann::json JSONParser::parseToJSON(std::string_view pText)
+
+	namespace
+	{
+		//
+		// scratch state of one thread; buffers survive between parse() calls;
+		//
+		struct ParseContext
+		{
+			JSONLexer mLexer;
+			JSONObject mBuilder;
+			// the text kept by ParseOptions::mFields;
+			std::string mInput;
+		};
+
+		ParseContext& localParseContext()
+		{
+			thread_local ParseContext context;
+			return context;
+		}
+
+		//
+		// repairs an object in appropiate way for JSON;
+		//
+		void repairObject(tng::JSONObject& pObject)
+		{
+			tng::JSONObject tmpObject;
+			std::string tmpKey, tmpValue;
+			for (auto& [key, value] : pObject.getStorage())
+			{
+				tmpKey = key;
+				if (tmpKey.size() >= 2)
+					tmpKey.erase(tmpKey.end() - 2, tmpKey.end());
+			
+				while (!tmpKey.empty() && !std::isalpha(*tmpKey.begin()) && !std::isdigit(*tmpKey.begin()))
+				{
+					tmpKey.erase(0, 1);
+				}
+				if (value.valueIsString())
+				{
+					tmpValue = value.getString();
+					if (!tmpValue.empty() && *(tmpValue.end() - 1) == '\n')
+						tmpValue.pop_back();
+					tmpObject.addObject(tmpKey, tng::JSONValue(tmpValue));
+				}
+				else
+				{
+					tmpObject.addObject(tmpKey, value);
+				}
+			}
+			pObject = std::move(tmpObject);
+		}
+
+		//
+		// fields of ParseOptions::mFields as a tree: "user.id" and "user.name" share "user";
+		//
+		struct FieldNode
+		{
+			std::string_view mName;
+			bool mWhole{ false };
+			std::vector<FieldNode> mChildren;
+
+			FieldNode& getChild(std::string_view pName)
+			{
+				for (FieldNode& child : mChildren)
+				{
+					if (child.mName == pName)
+						return child;
+				}
+				FieldNode& child = mChildren.emplace_back();
+				child.mName = pName;
+				return child;
+			}
+
+			const FieldNode* findChild(std::string_view pName) const noexcept
+			{
+				for (const FieldNode& child : mChildren)
+				{
+					if (child.mName == pName)
+						return &child;
+				}
+				return nullptr;
+			}
+		};
+
+		FieldNode makeFieldTree(const std::vector<std::string>& pFields)
+		{
+			FieldNode root;
+			for (std::string_view field : pFields)
+			{
+				FieldNode* node = &root;
+				for (size_t begin = 0;;)
+				{
+					size_t dot = field.find('.', begin);
+					node = &node->getChild(field.substr(begin, dot - begin));
+					if (dot == std::string_view::npos)
+						break;
+					begin = dot + 1;
+				}
+				node->mWhole = true;
+			}
+			return root;
+		}
+
+		//
+		// copies the members of the object at pPosition which are selected by pNode into pOutput,
+		// one member per line, the way the lexer reads them; other members are stepped over;
+		// pHasObjects is set if a kept value is or contains an object;
+		// returns the position after the object;
+		//
+		JSONResult<size_t> filterObject(std::string_view pText, size_t pPosition, const FieldNode& pNode, std::string& pOutput,
+										bool& pHasObjects)
+		{
+			pOutput += '{';
+			bool isEmpty = true;
+			std::string storage;
+			size_t position = raw::skipSeparators(pText, pPosition + 1);
+			while (true)
+			{
+				if (position >= pText.size())
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(position) });
+				if (pText[position] == '}')
+				{
+					pOutput += '}';
+					return position + 1;
+				}
+
+				size_t keyBegin = position;
+				size_t keyEnd = raw::skipValue(pText, position);
+				if (keyEnd == std::string_view::npos || pText[position] == '{' || pText[position] == '[')
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(position) });
+				const FieldNode* field = pNode.findChild(raw::getKey(pText.substr(keyBegin, keyEnd - keyBegin), storage));
+
+				position = raw::skipSpaces(pText, keyEnd);
+				if (position >= pText.size() || pText[position] != ':')
+					return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(position) });
+				position = raw::skipSpaces(pText, position + 1);
+
+				size_t valueEnd{};
+				if (field != nullptr && !field->mWhole && position < pText.size() && pText[position] == '{')
+				{
+					// only some members of the nested object are kept; the object is dropped if none are;
+					size_t mark = pOutput.size();
+					pOutput += isEmpty ? "" : "\n ";
+					pOutput += pText.substr(keyBegin, keyEnd - keyBegin);
+					pOutput += ": ";
+					size_t nestedBegin = pOutput.size();
+					JSONResult<size_t> nestedEnd = filterObject(pText, position, *field, pOutput, pHasObjects);
+					if (!nestedEnd)
+						return nestedEnd;
+					valueEnd = *nestedEnd;
+					if (pOutput.size() - nestedBegin == 2)
+						pOutput.resize(mark);
+					else
+					{
+						isEmpty = false;
+						pHasObjects = true;
+					}
+				}
+				else
+				{
+					valueEnd = raw::skipValue(pText, position);
+					if (valueEnd == std::string_view::npos)
+						return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(position) });
+					if (field != nullptr && field->mWhole)
+					{
+						pOutput += isEmpty ? "" : "\n ";
+						pOutput += pText.substr(keyBegin, keyEnd - keyBegin);
+						pOutput += ": ";
+						std::string_view value = pText.substr(position, valueEnd - position);
+						pOutput += value;
+						isEmpty = false;
+						pHasObjects = pHasObjects || value.contains('{');
+					}
+				}
+				position = raw::skipSeparators(pText, valueEnd);
+			}
+		}
+
+		//
+		// writes the text of the allowed fields of pText into pOutput;
+		//
+		JSONStatus filterFields(std::string_view pText, const std::vector<std::string>& pFields, std::string& pOutput,
+								bool& pHasObjects)
+		{
+			pOutput.clear();
+			size_t position = raw::skipSpaces(pText, 0);
+			if (position >= pText.size() || pText[position] != '{')
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(position) });
+			JSONResult<size_t> end = filterObject(pText, position, makeFieldTree(pFields), pOutput, pHasObjects);
+			if (!end)
+				return std::unexpected(end.error());
+			if (raw::skipSpaces(pText, *end) != pText.size())
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(*end) });
+			return {};
+		}
+	}
+
+	JSONResult<JSONObject> parse(std::string_view pText, const ParseOptions& pOptions)
 	{
-		std::string tmpString = std::string(pText);
-		if (!tmpString.empty() &&
-		   *(tmpString.end() - 1) == '}' &&
-		   *(tmpString.end() - 2) != '\n')
+		ParseContext& context = localParseContext();
+		std::string_view text = pText;
+		if (!pOptions.mFields.empty())
 		{
-			tmpString.insert(tmpString.end() - 1, '\n');
+			bool hasObjects = false;
+			if (JSONStatus status = filterFields(pText, pOptions.mFields, context.mInput, hasObjects); !status)
+				return std::unexpected(status.error());
+			if (hasObjects)
+			{
+				// the token builder flattens nested objects, the kept ones are built from a tape instead;
+				JSONResult<JSONTape> tape = JSONTape::create(context.mInput);
+				if (!tape)
+					return std::unexpected(tape.error());
+				return tape->toObject();
+			}
+			text = context.mInput;
+		}
+
+		// the lexer reads the text through a view, thus it is never copied;
+		JSONResult<tng::JSONObject> object = std::unexpected(JSONError{});
+		if (JSONStatus status = context.mLexer.tryTokenizeDocument(text); !status)
+			object = std::unexpected(status.error());
+		else
+			object = context.mBuilder.tryCreateObjFromTokens(context.mLexer);
+		if (object)
+			repairObject(*object);
+
+		if (context.mLexer.getRetainedBytes() + context.mInput.capacity() > pOptions.mMaxRetainedBytes)
+		{
+			context.mLexer.releaseBuffers();
+			context.mInput = std::string();
 		}
-		mLexer.tokenize(tmpString);
-		tng::JSONObject object = mJSONObject.createObjFromTokens(mLexer);
-		repairObject(object);
+		return object;
+	}
+
+	//
+	// JSONParser class implementation
+	//
+	
+	nlohmann::json JSONParser::parseToJSON(std::string_view pText) const
+	{
+		JSONResult<nlohmann::json> jsonData = tryParseToJSON(pText);
+		if (!jsonData)
+			throw JSONException(jsonData.error());
+		return std::move(*jsonData);
+	}
+
+	JSONResult<nlohmann::json> JSONParser::tryParseToJSON(std::string_view pText) const
+	{
+		return tryParseToJSON(pText, std::span<const std::string_view>());
+	}
+
+	nlohmann::json JSONParser::parseToJSON(std::string_view pText, std::initializer_list<std::string_view> pFields) const
+	{
+		return parseToJSON(pText, std::span<const std::string_view>(pFields.begin(), pFields.size()));
+	}
+
+	nlohmann::json JSONParser::parseToJSON(std::string_view pText, std::span<const std::string_view> pFields) const
+	{
+		JSONResult<nlohmann::json> jsonData = tryParseToJSON(pText, pFields);
+		if (!jsonData)
+			throw JSONException(jsonData.error());
+		return std::move(*jsonData);
+	}
+
+	JSONResult<nlohmann::json> JSONParser::tryParseToJSON(std::string_view pText, std::span<const std::string_view> pFields) const
+	{
+		ParseOptions options;
+		options.mFields.assign(pFields.begin(), pFields.end());
+		JSONResult<tng::JSONObject> object = tng::parse(pText, options);
+		if (!object)
+			return std::unexpected(object.error());
 		nlohmann::json jsonData = nlohmann::json::object();
 
 		try
 		{
-			for (auto& [key, value] : object.getStorage())
+			for (auto& [key, value] : object->getStorage())
 			{
 				jsonData[key] = valueToJson(value);
 			}
 		}
-		catch (const nlohmann::json::exception& ex)
+		catch (const nlohmann::json::exception&)
 		{
-			std::cout << std::format("The exception was caught! The exception: {}\n", ex.what());
-			jsonData = nlohmann::json::object();
+			// a value which nlohmann::json cant hold;
+			return std::unexpected(JSONError{ JSONErrorCode::TYPE_MISMATCH });
 		}
 		
 		return jsonData;
 	}
 
-	bool JSONParser::validate(std::string_view pText)
+	std::vector<JSONResult<nlohmann::json>> JSONParser::parseMany(std::span<const std::string_view> pTexts) const
 	{
-		try 
-		{
-			mLexer.tokenize(pText);
-			return true;
-		}
-		catch (const JSONException& exc)
-		{
-			return false;
-		}
+		return parseMany(pTexts, ThreadPool::getDefault());
+	}
+
+	std::vector<JSONResult<nlohmann::json>> JSONParser::parseMany(std::span<const std::string_view> pTexts, ThreadPool& pPool) const
+	{
+		std::vector<JSONResult<nlohmann::json>> results(pTexts.size());
+		pPool.parallelFor(pTexts.size(), [&](size_t pBegin, size_t pEnd)
+			{
+				for (size_t i = pBegin; i < pEnd; ++i)
+				{
+					// an exception must not leave a worker thread;
+					try
+					{
+						results[i] = tryParseToJSON(pTexts[i]);
+					}
+					catch (const JSONException& exception)
+					{
+						JSONErrorCode code = exception.getErrorCode();
+						results[i] = std::unexpected(JSONError{ code == JSONErrorCode::NONE ? JSONErrorCode::INVALID_TEXT : code });
+					}
+					catch (const std::filesystem::filesystem_error&)
+					{
+						results[i] = std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+					}
+					catch (...)
+					{
+						// std::bad_alloc and everything else;
+						results[i] = std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+					}
+				}
+			});
+		return results;
+	}
+
+	FileBuffer JSONParser::readFile(const std::filesystem::path& pPath) const
+	{
+		JSONResult<FileBuffer> file = tryReadFile(pPath);
+		if (!file)
+			throw JSONException(file.error());
+		return std::move(*file);
+	}
+
+	JSONResult<FileBuffer> JSONParser::tryReadFile(const std::filesystem::path& pPath) const
+	{
+		return FileBuffer::open(pPath);
+	}
+
+	nlohmann::json JSONParser::parseFile(const std::filesystem::path& pPath) const
+	{
+		JSONResult<nlohmann::json> jsonData = tryParseFile(pPath);
+		if (!jsonData)
+			throw JSONException(jsonData.error());
+		return std::move(*jsonData);
+	}
+
+	JSONResult<nlohmann::json> JSONParser::tryParseFile(const std::filesystem::path& pPath) const
+	{
+		JSONResult<FileBuffer> file = tryReadFile(pPath);
+		if (!file)
+			return std::unexpected(file.error());
+		return tryParseToJSON(file->getView());
+	}
+
+	void JSONParser::writeFile(const std::filesystem::path& pPath, const JSONObject& pJSONObject,
+							   const FileWriteOptions& pOptions) const
+	{
+		JSONStatus status = tryWriteFile(pPath, pJSONObject, pOptions);
+		if (!status)
+			throw JSONException(status.error());
+	}
+
+	JSONStatus JSONParser::tryWriteFile(const std::filesystem::path& pPath, const JSONObject& pJSONObject,
+										const FileWriteOptions& pOptions) const
+	{
+		std::string text;
+		JSONSerializer::serialize(pJSONObject, text);
+		return writeFileAtomically(pPath, text, pOptions);
+	}
+
+	void JSONParser::writeSnapshot(const std::filesystem::path& pPath, std::string_view pText,
+								   const FileWriteOptions& pOptions) const
+	{
+		JSONStatus status = tryWriteSnapshot(pPath, pText, pOptions);
+		if (!status)
+			throw JSONException(status.error());
+	}
+
+	JSONStatus JSONParser::tryWriteSnapshot(const std::filesystem::path& pPath, std::string_view pText,
+											const FileWriteOptions& pOptions) const
+	{
+		std::string snapshot;
+		if (JSONStatus status = JSONSnapshot::build(pText, snapshot); !status)
+			return status;
+		return writeFileAtomically(pPath, snapshot, pOptions);
+	}
+
+	JSONSnapshot JSONParser::openSnapshot(const std::filesystem::path& pPath) const
+	{
+		JSONResult<JSONSnapshot> snapshot = tryOpenSnapshot(pPath);
+		if (!snapshot)
+			throw JSONException(snapshot.error());
+		return std::move(*snapshot);
+	}
+
+	JSONResult<JSONSnapshot> JSONParser::tryOpenSnapshot(const std::filesystem::path& pPath) const
+	{
+		return JSONSnapshot::open(pPath);
+	}
+
+	bool JSONParser::validate(std::string_view pText) const
+	{
+		return localParseContext().mLexer.tryTokenize(pText).has_value();
 	}
 
 	void JSONParser::managePath(const std::filesystem::path& pPath)
@@ -627,34 +1195,6 @@ namespace tng
 		return data;
 	}
 
-	void JSONParser::repairObject(tng::JSONObject& pObject)
-	{
-		tng::JSONObject tmpObject;
-		std::string tmpKey, tmpValue;
-		for (auto& [key, value] : pObject.getStorage())
-		{
-			tmpKey = key;
-			tmpKey.erase(tmpKey.end() - 2, tmpKey.end());
-		
-			while (!std::isalpha(*tmpKey.begin()) && !std::isdigit(*tmpKey.begin()))
-			{
-				tmpKey.erase(0, 1);
-			}
-			if (value.valueIsString())
-			{
-				tmpValue = value.getString();
-				if (*(tmpValue.end() - 1) == '\n')
-					tmpValue.pop_back();
-				tmpObject.addObject(tmpKey, tng::JSONValue(tmpValue));
-			}
-			else
-			{
-				tmpObject.addObject(tmpKey, value);
-			}
-		}
-		pObject = tmpObject;
-	}
-
 	nlohmann::json JSONParser::valueToJson(const JSONValue& pValue)
 	{
 		if (pValue.valueIsArray())
@@ -678,6 +1218,17 @@ namespace tng
 			}
 			return tmpData;
 		}
+		else if (pValue.valueIsObject())
+		{
+			nlohmann::json tmpData = nlohmann::json::object();
+			for (auto& [key, value] : pValue.getObject().getStorage())
+			{
+				tmpData[key] = valueToJson(value);
+			}
+			return tmpData;
+		}
+		else if (pValue.valueIsNull())
+			return nullptr;
 		else if (pValue.valueIsBool())
 			return pValue.getBool();
 		else if (pValue.valueIsFloat())
@@ -694,10 +1245,11 @@ namespace tng
 
 	void JSONParser::openReadStream(const std::filesystem::path& pPath, std::ifstream& pIfstream)
 	{
-		managePath(pPath);
+		// a failed open() already tells that the path doesnt exist, thus no extra stat call;
 		pIfstream.open(pPath);
 		if (!pIfstream.is_open())
 			throw JSONException("Couldnt open the file!\n");
+		mPath = pPath;
 	}
 
 	void JSONParser::openWriteStream(const std::filesystem::path& pPath, std::ofstream& pOfstream)
@@ -752,27 +1304,72 @@ namespace tng
 	}
 
 	std::vector<JSONLexer::Token>& JSONLexer::tokenize(std::string_view pText)
+	{
+		if (JSONStatus status = tryTokenize(pText); !status)
+			throw JSONException(status.error());
+		return mTokens;
+	}
+
+	JSONStatus JSONLexer::tryTokenize(std::string_view pText)
+	{
+		mInput.assign(pText);
+		return scanInput();
+	}
+
+	JSONStatus JSONLexer::tryTokenizeDocument(std::string_view pText)
+	{
+		mInput.assign(pText);
+		if (pText.size() >= 2 && pText.back() == '}' && pText[pText.size() - 2] != '\n')
+		{
+			mPending.assign({ EditedText::Insertion{ pText.size() - 1, '\n' } });
+			mInput.insert(mPending);
+		}
+		return scanInput();
+	}
+
+	JSONStatus JSONLexer::scanInput()
 	{
 		mTokens.clear();
 		mCurrentPosInput = 0;
 		mCurrentToken = 0;
-		if ((!pText.empty() && pText.size() >= 2) &&
-			(*pText.begin() == '{' && *(pText.end() - 1) == '}'))
+		mError = {};
+		if (mInput.size() >= 2 && mInput[0] == '{' && mInput[mInput.size() - 1] == '}')
 		{
-			mInput = pText;
 			analyzerBraces();
 			analyzerSpaces();
-			setQuotes(mInput);
-			while (!isAtEnd())
+			setQuotes();
+			while (!isAtEnd() && mError.mCode == JSONErrorCode::NONE)
 			{
 				scan();
 			}
+			if (mError.mCode != JSONErrorCode::NONE)
+				return std::unexpected(mError);
 			if (!isValid())
-				throw JSONException("The text is not valid!\n");
-			return mTokens;
+				return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT, static_cast<uint32_t>(mCurrentPosInput) });
+			return {};
 		}
 		else
-			throw JSONException("The text is not valid!\n");
+			return std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+	}
+
+	const std::vector<JSONLexer::Token>& JSONLexer::getTokens() const noexcept
+	{
+		return mTokens;
+	}
+
+	size_t JSONLexer::getRetainedBytes() const noexcept
+	{
+		return mInput.getRetainedBytes() + mPending.capacity() * sizeof(EditedText::Insertion) +
+			   mTokens.capacity() * sizeof(Token);
+	}
+
+	void JSONLexer::releaseBuffers() noexcept
+	{
+		mInput.release();
+		mPending = std::vector<EditedText::Insertion>();
+		mTokens = std::vector<Token>();
+		mCurrentPosInput = 0;
+		mCurrentToken = 0;
 	}
 
 	JSONLexer::Token JSONLexer::previousToken()
@@ -843,7 +1440,8 @@ namespace tng
 
 	bool JSONLexer::isValid()
 	{
-		return mTokens[0].mTokenType == TokenType::LBRACE &&
+		return !mTokens.empty() &&
+			   mTokens[0].mTokenType == TokenType::LBRACE &&
 			   mTokens[mTokens.size() - 1].mTokenType == TokenType::RBRACE;
 	}
 
@@ -900,6 +1498,7 @@ namespace tng
 
 	void JSONLexer::analyzerSpaces()
 	{
+		mPending.clear();
 		for (size_t i = 0; i < mInput.size(); ++i)
 		{
 			if (mInput[i] == '\\' &&
@@ -917,16 +1516,19 @@ namespace tng
 				mInput[i + 1] != '-'		&&
 				mInput[i + 1] != '+')
 			{
-				mInput.insert(i+1, " ");
-				i++;
+				mPending.push_back(EditedText::Insertion{ i + 1, ' ' });
 			}
 		}
+		mInput.insert(mPending);
 	}
 
 	void JSONLexer::analyzerBraces()
 	{
 		if (mInput[mInput.size() - 1] == '}' && mInput[mInput.size() - 2] == '}')
-			mInput.push_back('}');
+		{
+			mPending.assign({ EditedText::Insertion{ mInput.size(), '}' } });
+			mInput.insert(mPending);
+		}
 	}
 
 	std::expected<char, std::string_view> JSONLexer::isSpecialSymbol(char pSymbol)
@@ -943,10 +1545,10 @@ namespace tng
 			return std::unexpected("There is no such a symbol!\n");
 	}
 
-	void JSONLexer::error(std::string_view pMessage)
+	void JSONLexer::error(JSONErrorCode pCode)
 	{
-		std::string errorMsg = std::format("Error! [MESSAGE] {} [CURRENT_POS_STRING] {}\n", pMessage, mCurrentPosInput);
-		throw JSONException(errorMsg.c_str());
+		if (mError.mCode == JSONErrorCode::NONE)
+			mError = JSONError{ pCode, static_cast<uint32_t>(mCurrentPosInput) };
 	}
 	char JSONLexer::inverseAdvance()
 	{
@@ -1086,9 +1688,9 @@ namespace tng
 			addToken(TokenType::ESCAPESEQ, "\t");
 			return '\t';
 		default:
-			error("Invalid character!\n");
+			error(JSONErrorCode::INVALID_CHARACTER);
 		}
-		std::unreachable();
+		return '\0';
 	}
 	
 	bool JSONLexer::isEscapeChar(char pChar)
@@ -1208,19 +1810,20 @@ namespace tng
 		mTokens[mTokens.size() - 1].mDefinition = pWordExpected;		
 	}
 
-	void JSONLexer::setQuotes(std::string& pString)
+	void JSONLexer::setQuotes()
 	{
+		mPending.clear();
 		std::string partText;
-		for (size_t i = 0; i < pString.size(); ++i)
+		for (size_t i = 0; i < mInput.size(); ++i)
 		{
-			if (pString[i] == '\\' &&
-				pString[i + 1] == 'u')
+			if (mInput[i] == '\\' &&
+				mInput[i + 1] == 'u')
 			{
 				i += 5;
 				continue;
 			}
-			if (std::isalpha(pString[i]))
-				partText += pString[i];
+			if (std::isalpha(mInput[i]))
+				partText += mInput[i];
 			else
 			{
 				if (!partText.empty())
@@ -1230,16 +1833,87 @@ namespace tng
 						partText != "true" &&
 						partText != "false"&&
 						partText != "e"	   &&
-						pString[i - partText.size() - 1] != '\"' &&
-						pString[i] != '\"')
+						mInput[i - partText.size() - 1] != '\"' &&
+						mInput[i] != '\"')
 					{
-						pString.insert(i - partText.size(), "\"");
-						pString.insert(i + 1, "\"");
-						i += 2;
+						mPending.push_back(EditedText::Insertion{ i - partText.size(), '\"' });
+						mPending.push_back(EditedText::Insertion{ i, '\"' });
 					}
 					partText.clear();
 				}
 			}
 		}
+		mInput.insert(mPending);
+	}
+
+	void JSONLexer::EditedText::assign(std::string_view pText) noexcept
+	{
+		mText = pText;
+		mInsertions.clear();
+		mCursor = 0;
+	}
+
+	void JSONLexer::EditedText::insert(const std::vector<Insertion>& pInsertions)
+	{
+		if (pInsertions.empty())
+			return;
+
+		// a position of the text is turned into a position of mText: the insertions before it are skipped;
+		mMerged.clear();
+		mMerged.reserve(mInsertions.size() + pInsertions.size());
+		size_t index = 0;
+		for (const Insertion& insertion : pInsertions)
+		{
+			while (index < mInsertions.size() && mInsertions[index].mPosition + index < insertion.mPosition)
+			{
+				mMerged.push_back(mInsertions[index]);
+				++index;
+			}
+			size_t position = index < mInsertions.size() && mInsertions[index].mPosition + index == insertion.mPosition
+							? mInsertions[index].mPosition
+							: insertion.mPosition - index;
+			mMerged.push_back(Insertion{ position, insertion.mChar });
+		}
+		mMerged.insert(mMerged.end(), mInsertions.begin() + index, mInsertions.end());
+		mInsertions.swap(mMerged);
+		mCursor = 0;
+	}
+
+	char JSONLexer::EditedText::operator[](size_t pPosition) const noexcept
+	{
+		if (pPosition >= size())
+			return '\0';
+
+		// the i-th insertion is at the position mInsertions[i].mPosition + i of the text;
+		while (mCursor > 0 && mInsertions[mCursor - 1].mPosition + mCursor - 1 >= pPosition)
+			--mCursor;
+		while (mCursor < mInsertions.size() && mInsertions[mCursor].mPosition + mCursor < pPosition)
+			++mCursor;
+		if (mCursor < mInsertions.size() && mInsertions[mCursor].mPosition + mCursor == pPosition)
+			return mInsertions[mCursor].mChar;
+		return mText[pPosition - mCursor];
+	}
+
+	size_t JSONLexer::EditedText::size() const noexcept
+	{
+		return mText.size() + mInsertions.size();
+	}
+
+	bool JSONLexer::EditedText::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	size_t JSONLexer::EditedText::getRetainedBytes() const noexcept
+	{
+		return (mInsertions.capacity() + mMerged.capacity()) * sizeof(Insertion);
+	}
+
+	void JSONLexer::EditedText::release() noexcept
+	{
+		mText = {};
+		mInsertions = std::vector<Insertion>();
+		mMerged = std::vector<Insertion>();
+		mCursor = 0;
 	}
 }
@@ -11,6 +11,13 @@
 #include <variant>
 #include <optional>
 #include <expected>
+#include <memory>
+#include <charconv>
+#include <cstring>
+#include <span>
+
+#include "JSONError.h"
+#include "FileBuffer.h"
 
 #if __has_include("JSON/json.hpp")
 	#define USE_JSON_LIBRARY 1
@@ -67,6 +74,24 @@ namespace tng
 						  isFloatNumber<T> || 
 					      isKeyword<T>	   || 
 					      isNull<T>;
+
+	class JSONObject;
+	class ThreadPool;
+	class JSONSnapshot;
+
+	//
+	// transparent hash for string keys, thus lookups by std::string_view
+	// or const char* do not construct a temporary std::string;
+	//
+	struct StringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view pKey) const noexcept
+		{
+			return std::hash<std::string_view>{}(pKey);
+		}
+	};
 	
 	class JSONValue
 	{
@@ -86,7 +111,7 @@ namespace tng
 				else if constexpr (isString<T>)
 					return mJsonValue.getString();
 				else
-					return mJsonValue.getArray();
+					return nullptr;
 			}
 			JSONValue& mJsonValue;
 		};
@@ -97,7 +122,11 @@ namespace tng
 		JSONValue(T pValue);
 	    explicit JSONValue(const std::initializer_list<JSONValue>& pArray);
 		explicit JSONValue(const std::vector<JSONValue>& pArrray);
+		explicit JSONValue(std::vector<JSONValue>&& pArray);
 		explicit JSONValue(const std::vector<std::vector<JSONValue>>& pNestedArrays);
+		explicit JSONValue(const JSONObject& pObject);
+		explicit JSONValue(JSONObject&& pObject);
+		explicit JSONValue(std::shared_ptr<const JSONObject> pObject);
 		~JSONValue() = default;
 		JSONValue(const JSONValue&) = default;
 		JSONValue& operator=(const JSONValue&) = default;
@@ -162,6 +191,11 @@ namespace tng
 		//
 		const std::vector<std::vector<JSONValue>>& getNestedArray() const;
 
+		//
+		// returns contained nested object;
+		//
+		const JSONObject& getObject() const;
+
 		//
 		// checkers if a value is an exact type;
 		// 
@@ -173,6 +207,8 @@ namespace tng
 		bool valueIsString() const noexcept;
 		bool valueIsArray() const noexcept;
 		bool valueIsNestedArray() const noexcept;
+		bool valueIsNull() const noexcept;
+		bool valueIsObject() const noexcept;
 		// ----------------------------------		
 
 	private:
@@ -185,11 +221,22 @@ namespace tng
 			STRING = 4,
 			VECTOR = 5,
 			NULLTYPE = 6,
-			NESTED_ARRAY = 7
+			NESTED_ARRAY = 7,
+			OBJECT = 8
 		};
 	private:
+		friend class JSONValueView;
+		friend class JSONSerializer;
+		friend class IncrementalDocument;
+		friend class BinaryCodec;
+
+		//
+		// nested objects are immutable once built and shared between copies,
+		// so copying a value never deep-copies a subtree;
+		//
 		std::variant<bool, uint32_t, int32_t, float, std::string,
-					 std::vector<JSONValue>, std::nullptr_t, std::vector<std::vector<JSONValue>>> mValue{ 0 };
+					 std::vector<JSONValue>, std::nullptr_t, std::vector<std::vector<JSONValue>>,
+					 std::shared_ptr<const JSONObject>> mValue{ 0 };
 		typeVariant mTypeVariant{ typeVariant::INT };
 	};
 
@@ -198,6 +245,7 @@ namespace tng
 	private:
 		enum class TokenType;
 		struct Token;
+		friend class JSONTape;
 	public:
 		JSONLexer();
 
@@ -213,6 +261,33 @@ namespace tng
 		//
 		std::vector<Token>& tokenize(std::string_view pText);
 
+		//
+		// the same as tokenize(), but reports an error instead of throwing;
+		// tokens are available via getTokens() on success;
+		//
+		JSONStatus tryTokenize(std::string_view pText);
+
+		//
+		// the same as tryTokenize(), but the last member is ended with a line break
+		// the way the object builder expects, as if it were in the text;
+		//
+		JSONStatus tryTokenizeDocument(std::string_view pText);
+
+		//
+		// returns storage of tokens;
+		//
+		const std::vector<Token>& getTokens() const noexcept;
+
+		//
+		// returns number of bytes, which the lexer keeps between tokenize() calls;
+		//
+		size_t getRetainedBytes() const noexcept;
+
+		//
+		// releases memory kept between tokenize() calls;
+		//
+		void releaseBuffers() noexcept;
+
 		//
 		// iterators for storage of tokens
 		// -------------------------------
@@ -358,7 +433,7 @@ namespace tng
 		// sets quotes around a string;
 		// was made in order to evade changing the whole logic of the lexer;
 		//
-		void setQuotes(std::string& pString);
+		void setQuotes();
 
 		//
 		// analyzes if the input string has 2 or more braces at the end;
@@ -373,19 +448,84 @@ namespace tng
 		std::expected<char, std::string_view> isSpecialSymbol(char pSymbol);
 
 		//
-		// just a simplified log-function;
+		// remembers the first error and stops scanning; 
+		// tokenize() turns it into an exception, tryTokenize() returns it;
+		//
+		void error(JSONErrorCode pCode);
+
+		//
+		// scans mInput, which is already set;
+		//
+		JSONStatus scanInput();
+
+		//
+		// the text as the lexer reads it: the passed text with the characters, which
+		// analyzerSpaces() and others add, inserted between its characters;
+		// the passed text is only viewed, it must live until tokenizing is done;
 		//
-		void error(std::string_view pMessagem);
+		class EditedText
+		{
+		public:
+			//
+			// a character and the position it is inserted before;
+			//
+			struct Insertion
+			{
+				size_t mPosition{};
+				char mChar{};
+			};
+
+			//
+			// views pText and drops the insertions;
+			//
+			void assign(std::string_view pText) noexcept;
+
+			//
+			// inserts the characters of pInsertions, positions are ascending and are given
+			// in the text as it was before the call;
+			//
+			void insert(const std::vector<Insertion>& pInsertions);
+
+			//
+			// returns a character or '\0' if pPosition is out of the text;
+			//
+			char operator[](size_t pPosition) const noexcept;
+
+			size_t size() const noexcept;
+			bool empty() const noexcept;
+
+			//
+			// returns number of bytes, which the insertions keep;
+			//
+			size_t getRetainedBytes() const noexcept;
+
+			//
+			// releases memory of the insertions;
+			//
+			void release() noexcept;
+
+		private:
+			std::string_view mText{};
+			// sorted by position in mText, several ones at one position keep their order;
+			std::vector<Insertion> mInsertions;
+			std::vector<Insertion> mMerged;
+			// number of insertions before the last read position, reads are mostly sequential;
+			mutable size_t mCursor{};
+		};
 
 	private:
 		int32_t mCurrentPosInput{};
 		uint32_t mCurrentToken{};
-		std::string mInput{};
+		EditedText mInput{};
+		std::vector<EditedText::Insertion> mPending;
 		std::vector<Token> mTokens;
+		JSONError mError{};
 	};
 
 	class JSONObject
 	{
+	public:
+		using Storage = std::unordered_map<std::string, JSONValue, StringHash, std::equal_to<>>;
 	public:
 		JSONObject() = default;
 		JSONObject(const std::string& pKey, const JSONValue& pValue);
@@ -409,6 +549,7 @@ namespace tng
 		// adds key and value
 		//
 		void addObject(std::string_view pKey, const JSONValue& pValue);
+		void addObject(std::string_view pKey, JSONValue&& pValue);
 
 		//
 		// moves value to key, and key to value;
@@ -430,7 +571,15 @@ namespace tng
 		//
 		// creates std::string from tokens, which we created in the parser class;
 		//
-		tng::JSONObject createObjFromTokens(tng::JSONLexer pTokens);
+		// the lexer is passed by reference, thus its buffers are not copied;
+		// reading starts from the current token of the lexer;
+		//
+		tng::JSONObject createObjFromTokens(tng::JSONLexer& pTokens);
+
+		//
+		// the same as createObjFromTokens(), but reports an error instead of throwing;
+		//
+		JSONResult<tng::JSONObject> tryCreateObjFromTokens(tng::JSONLexer& pTokens);
 
 		//
 		// getter for value;
@@ -465,8 +614,14 @@ namespace tng
 		// returns std::nullopt - if values is not contained in the storage;
 		//
 		std::optional<JSONValue> tryGetValue(std::string_view pKey) noexcept;
+
+		//
+		// returns a pointer to the stored value without copying it;
+		// returns nullptr - if pKey is not contained in the storage;
+		//
+		const JSONValue* findValue(std::string_view pKey) const noexcept;
 		
-		const std::unordered_map<std::string, JSONValue>& getStorage() const noexcept;
+		const Storage& getStorage() const noexcept;
 
 	private:
 		void toJsonFormatHelper(nlohmann::json& pData, const JSONValue& pValue);
@@ -481,23 +636,48 @@ namespace tng
 		// from point of view JSONValue;
 		// 
 		// ------------------------------
-		void addArray(std::string& pKey, std::string& pArray,
-					  tng::JSONObject& pObject);
-		void addNumber(std::string_view pNumber,
-					   std::vector<tng::JSONValue>& pStorage);
+		JSONStatus addArray(std::string_view pKey, std::string_view pArray);
+		JSONStatus addNumber(std::string_view pNumber,
+							 std::vector<tng::JSONValue>& pStorage) const;
 		// ------------------------------
 
+		//
+		// builds an array value of any depth from its text, like "[1, [2, [3]], test]";
+		// nested arrays become nested JSONValue arrays; a quoted element may contain ',', '[' and ']';
+		// an empty element (like in "[1,,2]") is an error;
+		// keeps all state on its own stack, thus it is reentrant;
+		//
+		JSONResult<tng::JSONValue> parseArray(std::string_view pArray) const;
+
+		//
+		// converts a single array element (number, keyword, bare or quoted string) and appends it;
+		//
+		JSONStatus addElement(std::string_view pElement,
+							  std::vector<tng::JSONValue>& pStorage) const;
+
+		//
+		// converts a number into JSONValue via std::from_chars;
+		// leading spaces and '+' are skipped, the rest after the number is ignored;
+		//
+		JSONResult<tng::JSONValue> toNumber(std::string_view pNumber) const noexcept;
+
 	private:
-		std::unordered_map<std::string, JSONValue> mKeyValueStrg;
-		std::vector<std::vector<JSONValue>> mNestedArrays;
+		friend class IncrementalDocument;
+
+		Storage mKeyValueStrg;
 	};
 
+	//
+	// the exception never allocates: the message is kept in a fixed buffer
+	// and truncated if it is longer;
+	//
 	class JSONException : public std::exception
 	{
 	public:
-		JSONException(const char* pMessage);
-		JSONException(const std::exception& pException);
-		~JSONException();
+		JSONException(const char* pMessage) noexcept;
+		JSONException(const std::exception& pException) noexcept;
+		JSONException(const JSONError& pError) noexcept;
+		~JSONException() = default;
 		JSONException(const JSONException&) = default;
 		JSONException& operator=(const JSONException&) = default;
 		JSONException(JSONException&&) = default;
@@ -506,19 +686,27 @@ namespace tng
 		//
 		// returns the reason of exception in text;
 		//
-		const char* what() const noexcept;
+		const char* what() const noexcept override;
+
+		//
+		// returns the error code (JSONErrorCode::NONE for plain messages);
+		//
+		JSONErrorCode getErrorCode() const noexcept;
 
 	private:
 		//
 		// erasing the last message of the exception;
 		//
-		void eraseMessage();
+		void eraseMessage() noexcept;
 		//
 		// assigns the message, which we've passed, to our exception's message;
 		//
-		void assignMessage(const char* pMessage);
+		void assignMessage(const char* pMessage) noexcept;
 	private:
-		char* mMessage{ nullptr };
+		static constexpr size_t mMaxMessageSize = 128;
+
+		char mMessage[mMaxMessageSize]{};
+		JSONErrorCode mErrorCode{ JSONErrorCode::NONE };
 	};
 	
 
@@ -533,25 +721,75 @@ namespace tng
 
 		//
 		// parses std::string to JSON file;
+		// parsing functions dont touch members of the parser (see tng::parse()),
+		// thus one instance can be shared between threads;
   		//
-		nlohmann::json parseToJSON(std::string_view pText);
+		nlohmann::json parseToJSON(std::string_view pText) const;
+
+		//
+		// the same as parseToJSON(), but reports an error instead of throwing;
+		//
+		JSONResult<nlohmann::json> tryParseToJSON(std::string_view pText) const;
+
+		//
+		// parses only the listed fields (see ParseOptions::mFields);
+		// nlohmann::json data = parser.parseToJSON(text, { "id", "ts", "status" });
+		//
+		nlohmann::json parseToJSON(std::string_view pText, std::initializer_list<std::string_view> pFields) const;
+		nlohmann::json parseToJSON(std::string_view pText, std::span<const std::string_view> pFields) const;
+		JSONResult<nlohmann::json> tryParseToJSON(std::string_view pText, std::span<const std::string_view> pFields) const;
+
+		//
+		// parses many independent documents in parallel on a work-stealing pool 
+		// (ThreadPool::getDefault() if pool is not passed);
+		// results are in the order of pTexts and every document has its own result or error;
+		//
+		std::vector<JSONResult<nlohmann::json>> parseMany(std::span<const std::string_view> pTexts) const;
+		std::vector<JSONResult<nlohmann::json>> parseMany(std::span<const std::string_view> pTexts, ThreadPool& pPool) const;
 
 		//
 		// validating a string without parsing; 
 		// if you dont want to parse a string, just would like to check
 		// if the string is accessible;
 		//
-		bool validate(std::string_view pText);
+		bool validate(std::string_view pText) const;
+
+		//
+		// reads data from the file;
+		// regular files are memory-mapped, thus there is no copy into std::string;
+		// pipes and procfs files are read into a buffer;
+		//
+		FileBuffer readFile(const std::filesystem::path& pPath) const;
+		JSONResult<FileBuffer> tryReadFile(const std::filesystem::path& pPath) const;
 
 		//
-		// reads data from the file (which we converted) in string;
+		// reads the file via readFile() and parses it;
+		// the mapping is passed to the parser as std::string_view and tokenized as it is,
+		// the text is never copied into std::string;
 		//
-		std::string readFile(const std::filesystem::path& pPath);
+		nlohmann::json parseFile(const std::filesystem::path& pPath) const;
+		JSONResult<nlohmann::json> tryParseFile(const std::filesystem::path& pPath) const;
 
 		//
-		// writes data into the file via JSONObject class;
+		// writes the object into the file as compact JSON text;
+		// the text is serialized straight from JSONObject into one buffer and
+		// written atomically, thus the file is never left half-written;
 		//
-		void writeFile(const std::filesystem::path& pPath, const JSONObject& pJSONObject);
+		void writeFile(const std::filesystem::path& pPath, const JSONObject& pJSONObject,
+					   const FileWriteOptions& pOptions = {}) const;
+		JSONStatus tryWriteFile(const std::filesystem::path& pPath, const JSONObject& pJSONObject,
+								const FileWriteOptions& pOptions = {}) const;
+
+		//
+		// parses the text into a binary snapshot (see JSONSnapshot) and writes it atomically;
+		// openSnapshot() maps it back and queries run on the mapping, without parsing it again;
+		//
+		void writeSnapshot(const std::filesystem::path& pPath, std::string_view pText,
+						   const FileWriteOptions& pOptions = {}) const;
+		JSONStatus tryWriteSnapshot(const std::filesystem::path& pPath, std::string_view pText,
+									const FileWriteOptions& pOptions = {}) const;
+		JSONSnapshot openSnapshot(const std::filesystem::path& pPath) const;
+		JSONResult<JSONSnapshot> tryOpenSnapshot(const std::filesystem::path& pPath) const;
 
 		// 
 		// erasing all data in the converted file;
@@ -615,38 +853,65 @@ namespace tng
 		//
 		nlohmann::json repairJSONString(const std::string& pJSONString);
 
-		//
-		// repairs an object in appropiate way for JSON;
-		//
-		void repairObject(tng::JSONObject& pObject);
-
 		//
 		// converts JSONValue into a json value;
 		//
-		nlohmann::json valueToJson(const JSONValue& pValue);
+		static nlohmann::json valueToJson(const JSONValue& pValue);
 
 	private:
 		JSONObject mJSONObject;
-		JSONLexer mLexer;
 		std::string mResourcePath{};
 		std::filesystem::path mPath{ std::filesystem::current_path() };
 		nlohmann::json mData{ nlohmann::json::object() };
 	};
 
+	//
+	// options of the stateless parse();
+	//
+	struct ParseOptions
+	{
+		//
+		// scratch buffers of the calling thread are kept between calls,
+		// but if they have grown beyond this size (in bytes), they are released;
+		// thus one huge document doesnt pin memory in every worker thread;
+		//
+		size_t mMaxRetainedBytes{ 4 * 1024 * 1024 };
+
+		//
+		// allow-list of fields; if it is not empty, only these members are parsed,
+		// a dotted name selects a member of a nested object ("user.id");
+		// every other member is stepped over by its brackets and quotes without being tokenized;
+		// if a kept value holds an object, the kept members are built with JSONTape
+		// (strings are decoded then), since the lexer cant build nested objects;
+		//
+		std::vector<std::string> mFields{};
+	};
+
+	//
+	// parses pText into JSONObject without any shared state;
+	// every thread has its own scratch context (lexer and buffers), which keeps
+	// its memory between calls; thus it can be called from many threads at once
+	// and there is no need in a parser per thread;
+	// JSONResult<JSONObject> object = tng::parse("{port: 8080}");
+	//
+	JSONResult<JSONObject> parse(std::string_view pText, const ParseOptions& pOptions = {});
+
 	template<typename T>
 	requires ProperValue<T>
 	inline JSONValue::JSONValue(T pValue)
 	{
-		if constexpr (std::is_unsigned_v<T>) 
+		if constexpr (isKeyword<T>)
+			mTypeVariant = typeVariant::BOOL;
+		else if constexpr (std::is_unsigned_v<T>) 
 			mTypeVariant = typeVariant::UINT;
 		else if constexpr(isIntNumber<T>)
 			mTypeVariant = typeVariant::INT;
-		else if constexpr (isKeyword<T>)
-			mTypeVariant = typeVariant::BOOL;
 		else if constexpr (isFloatNumber<T>)
 			mTypeVariant = typeVariant::FLOAT;
 		else if constexpr (isString<T>)
 			mTypeVariant = typeVariant::STRING;
+		else if constexpr (isNull<T>)
+			mTypeVariant = typeVariant::NULLTYPE;
 		else
 			throw JSONException("This is not a value!\n");
 		mValue = pValue;
@@ -0,0 +1,194 @@
+#include "JSONPointer.h"
+#include "RawScan.h"
+
+#include <string>
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		//
+		// splits a pointer into reference tokens and resolves "~1" and "~0";
+		//
+		class ReferenceTokens
+		{
+		public:
+			explicit ReferenceTokens(std::string_view pPointer) noexcept
+				: mPointer(pPointer)
+			{
+			}
+
+			bool isValid() const noexcept
+			{
+				return mPointer.empty() || mPointer.front() == '/';
+			}
+
+			//
+			// moves to the next token, returns false at the end;
+			//
+			bool next()
+			{
+				if (mPosition >= mPointer.size())
+					return false;
+				size_t begin = mPosition + 1;
+				size_t end = mPointer.find('/', begin);
+				if (end == std::string_view::npos)
+					end = mPointer.size();
+				mPosition = end;
+				mToken = mPointer.substr(begin, end - begin);
+				if (mToken.find('~') != std::string_view::npos)
+				{
+					mUnescaped.clear();
+					for (size_t i = 0; i < mToken.size(); ++i)
+					{
+						if (mToken[i] == '~' && i + 1 < mToken.size() && (mToken[i + 1] == '0' || mToken[i + 1] == '1'))
+						{
+							mUnescaped.push_back(mToken[i + 1] == '0' ? '~' : '/');
+							++i;
+						}
+						else
+							mUnescaped.push_back(mToken[i]);
+					}
+					mToken = mUnescaped;
+				}
+				return true;
+			}
+
+			std::string_view getToken() const noexcept
+			{
+				return mToken;
+			}
+
+			//
+			// returns the token as an array index; leading zeros and "-" (the element after the last) are rejected;
+			//
+			bool getIndex(size_t& pIndex) const noexcept
+			{
+				if (mToken.empty() || (mToken.size() > 1 && mToken.front() == '0'))
+					return false;
+				const char* end = mToken.data() + mToken.size();
+				auto [ptr, errorCode] = std::from_chars(mToken.data(), end, pIndex);
+				return errorCode == std::errc() && ptr == end;
+			}
+
+		private:
+			std::string_view mPointer;
+			size_t mPosition{};
+			std::string_view mToken;
+			std::string mUnescaped;
+		};
+	}
+
+	JSONResult<std::string_view> pointerLookup(std::string_view pText, std::string_view pPointer)
+	{
+		ReferenceTokens tokens(pPointer);
+		if (!tokens.isValid())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+
+		size_t position = raw::skipSpaces(pText, 0);
+		while (tokens.next())
+		{
+			if (position >= pText.size())
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+			char open = pText[position];
+			if (open == '{')
+			{
+				position = raw::skipSeparators(pText, position + 1);
+				while (true)
+				{
+					if (position >= pText.size())
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					if (pText[position] == '}')
+						return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, position));
+
+					size_t keyEnd = raw::skipValue(pText, position);
+					if (keyEnd == std::string_view::npos || pText[position] == '{' || pText[position] == '[')
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					bool found = raw::keyEquals(pText.substr(position, keyEnd - position), tokens.getToken());
+
+					position = raw::skipSpaces(pText, keyEnd);
+					if (position >= pText.size() || pText[position] != ':')
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					position = raw::skipSpaces(pText, position + 1);
+					if (found)
+						break;
+
+					size_t valueEnd = raw::skipValue(pText, position);
+					if (valueEnd == std::string_view::npos)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					position = raw::skipSeparators(pText, valueEnd);
+				}
+			}
+			else if (open == '[')
+			{
+				size_t index{};
+				if (!tokens.getIndex(index))
+					return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, position));
+				position = raw::skipSeparators(pText, position + 1);
+				for (size_t i = 0;; ++i)
+				{
+					if (position >= pText.size())
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					if (pText[position] == ']')
+						return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, position));
+					if (i == index)
+						break;
+					size_t valueEnd = raw::skipValue(pText, position);
+					if (valueEnd == std::string_view::npos)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					position = raw::skipSeparators(pText, valueEnd);
+				}
+			}
+			else
+				return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, position));
+		}
+
+		size_t end = raw::skipValue(pText, position);
+		if (end == std::string_view::npos)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+		return pText.substr(position, end - position);
+	}
+
+	JSONResult<size_t> pointerLookup(const JSONTape& pTape, std::string_view pPointer)
+	{
+		ReferenceTokens tokens(pPointer);
+		if (!tokens.isValid() || pTape.size() == 0)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+
+		size_t index{};
+		while (tokens.next())
+		{
+			const JSONTape::Entry& entry = pTape[index];
+			size_t close = entry.mMatch;
+			if (entry.mType == JSONTape::TokenType::LBRACE)
+			{
+				size_t member = index + 1;
+				while (member < close && !raw::keyEquals(pTape.getRaw(member), tokens.getToken()))
+					member = pTape.skip(member + 1);
+				if (member >= close)
+					return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, entry.mOffset));
+				index = member + 1;
+			}
+			else if (entry.mType == JSONTape::TokenType::LBRACKET)
+			{
+				size_t position{};
+				if (!tokens.getIndex(position))
+					return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, entry.mOffset));
+				size_t element = index + 1;
+				for (; element < close && position != 0; --position)
+					element = pTape.skip(element);
+				if (element >= close)
+					return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, entry.mOffset));
+				index = element;
+			}
+			else
+				return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, entry.mOffset));
+		}
+		return index;
+	}
+}
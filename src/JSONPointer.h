@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+#include "JSONParser.h"
+#include "JSONTape.h"
+
+namespace tng
+{
+	//
+	// finds the value of the JSON Pointer (RFC 6901) in the text without building anything:
+	// only the members on the path are looked at, every other subtree is stepped over by its brackets;
+	// returns the text of the value (with quotes for strings, the whole subtree for containers);
+	// std::string_view route = tng::pointerLookup(payload, "/meta/routing/0/queue").value_or("");
+	//
+	// "" is the whole document, "~1" and "~0" in a reference token are '/' and '~';
+	// errors: MISSING_KEY - no such member or element, TYPE_MISMATCH - a token applied to a scalar,
+	// INVALID_TEXT - the pointer or the text on the path is malformed;
+	// text outside the path is not validated; among duplicate keys the first one is found;
+	//
+	JSONResult<std::string_view> pointerLookup(std::string_view pText, std::string_view pPointer);
+
+	//
+	// the same on a tape, which is better when many pointers are looked up in one document;
+	// returns the index of the entry of the value;
+	//
+	JSONResult<size_t> pointerLookup(const JSONTape& pTape, std::string_view pPointer);
+}
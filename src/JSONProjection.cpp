@@ -0,0 +1,254 @@
+#include "JSONProjection.h"
+#include "JSONTape.h"
+#include "RawScan.h"
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+	}
+
+	JSONResult<JSONProjection> JSONProjection::compile(std::span<const std::string_view> pSelectors)
+	{
+		JSONProjection projection;
+		projection.mNodes.emplace_back();
+		for (size_t i = 0; i < pSelectors.size(); ++i)
+		{
+			if (JSONStatus status = projection.addSelector(pSelectors[i], static_cast<uint32_t>(i)); !status)
+				return std::unexpected(status.error());
+		}
+		projection.mSelectorCount = pSelectors.size();
+		return projection;
+	}
+
+	JSONResult<JSONProjection> JSONProjection::compile(std::initializer_list<std::string_view> pSelectors)
+	{
+		return compile(std::span<const std::string_view>(pSelectors.begin(), pSelectors.size()));
+	}
+
+	JSONResult<ProjectionMatches> JSONProjection::run(std::string_view pText) const
+	{
+		ProjectionMatches matches;
+		if (JSONStatus status = run(pText, matches); !status)
+			return std::unexpected(status.error());
+		return matches;
+	}
+
+	JSONStatus JSONProjection::run(std::string_view pText, ProjectionMatches& pMatches) const
+	{
+		pMatches.resize(mSelectorCount);
+		for (auto& matches : pMatches)
+			matches.clear();
+
+		Levels levels(mMaxDepth + 1);
+		levels[0].push_back(0);
+		size_t position = raw::skipSpaces(pText, 0);
+		JSONResult<size_t> end = scan(pText, position, 0, levels, pMatches);
+		if (!end)
+			return std::unexpected(end.error());
+		if (raw::skipSpaces(pText, *end) != pText.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, *end));
+		return {};
+	}
+
+	JSONResult<JSONValue> JSONProjection::decode(std::string_view pMatch)
+	{
+		JSONResult<JSONTape> tape = JSONTape::create(pMatch);
+		if (!tape)
+			return std::unexpected(tape.error());
+		return tape->toValue();
+	}
+
+	JSONStatus JSONProjection::addSelector(std::string_view pSelector, uint32_t pId)
+	{
+		if (pSelector.empty() || pSelector.front() != '$')
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+
+		uint32_t node = 0;
+		size_t depth{};
+		size_t i = 1;
+		while (i < pSelector.size())
+		{
+			if (pSelector[i] == '.')
+			{
+				size_t end = pSelector.find_first_of(".[", i + 1);
+				if (end == std::string_view::npos)
+					end = pSelector.size();
+				std::string_view key = pSelector.substr(i + 1, end - i - 1);
+				if (key.empty())
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+				node = key == "*" ? getAnyChild(node) : getChild(node, key);
+				i = end;
+			}
+			else if (pSelector[i] == '[')
+			{
+				size_t close{};
+				if (i + 1 < pSelector.size() && (pSelector[i + 1] == '\'' || pSelector[i + 1] == '"'))
+				{
+					char quote = pSelector[i + 1];
+					size_t end = pSelector.find(quote, i + 2);
+					if (end == std::string_view::npos || end + 1 >= pSelector.size() || pSelector[end + 1] != ']')
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+					node = getChild(node, pSelector.substr(i + 2, end - i - 2));
+					close = end + 1;
+				}
+				else
+				{
+					close = pSelector.find(']', i + 1);
+					if (close == std::string_view::npos)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+					std::string_view inside = pSelector.substr(i + 1, close - i - 1);
+					if (inside == "*")
+						node = getAnyChild(node);
+					else
+					{
+						size_t index{};
+						auto [ptr, errorCode] = std::from_chars(inside.data(), inside.data() + inside.size(), index);
+						if (inside.empty() || errorCode != std::errc() || ptr != inside.data() + inside.size())
+							return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+						node = getChild(node, index);
+					}
+				}
+				i = close + 1;
+			}
+			else
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+			++depth;
+		}
+
+		mNodes[node].mSelectors.push_back(pId);
+		mMaxDepth = std::max(mMaxDepth, depth);
+		return {};
+	}
+
+	uint32_t JSONProjection::getChild(uint32_t pNode, std::string_view pKey)
+	{
+		auto it = mNodes[pNode].mKeys.find(pKey);
+		if (it != mNodes[pNode].mKeys.end())
+			return it->second;
+		uint32_t child = static_cast<uint32_t>(mNodes.size());
+		mNodes.emplace_back();
+		mNodes[pNode].mKeys.emplace(std::string(pKey), child);
+		return child;
+	}
+
+	uint32_t JSONProjection::getChild(uint32_t pNode, size_t pIndex)
+	{
+		auto it = mNodes[pNode].mIndices.find(pIndex);
+		if (it != mNodes[pNode].mIndices.end())
+			return it->second;
+		uint32_t child = static_cast<uint32_t>(mNodes.size());
+		mNodes.emplace_back();
+		mNodes[pNode].mIndices.emplace(pIndex, child);
+		return child;
+	}
+
+	uint32_t JSONProjection::getAnyChild(uint32_t pNode)
+	{
+		if (mNodes[pNode].mAny == NONE)
+		{
+			uint32_t child = static_cast<uint32_t>(mNodes.size());
+			mNodes.emplace_back();
+			mNodes[pNode].mAny = child;
+		}
+		return mNodes[pNode].mAny;
+	}
+
+	JSONResult<size_t> JSONProjection::scan(std::string_view pText, size_t pPosition, size_t pDepth,
+											Levels& pLevels, ProjectionMatches& pMatches) const
+	{
+		if (pPosition >= pText.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pPosition));
+
+		const std::vector<uint32_t>& nodes = pLevels[pDepth];
+		bool descend = false;
+		for (uint32_t node : nodes)
+			descend = descend || mNodes[node].hasChildren();
+
+		char open = pText[pPosition];
+		size_t end{};
+		if (!descend || (open != '{' && open != '['))
+		{
+			end = raw::skipValue(pText, pPosition);
+			if (end == std::string_view::npos)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pPosition));
+		}
+		else
+		{
+			// children of the active nodes, which match the current member or element;
+			std::vector<uint32_t>& children = pLevels[pDepth + 1];
+			bool isObject = open == '{';
+			char close = isObject ? '}' : ']';
+			std::string storage;
+			size_t position = raw::skipSeparators(pText, pPosition + 1);
+			for (size_t index = 0;; ++index)
+			{
+				if (position >= pText.size())
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+				if (pText[position] == close)
+				{
+					end = position + 1;
+					break;
+				}
+
+				children.clear();
+				if (isObject)
+				{
+					size_t keyEnd = raw::skipValue(pText, position);
+					if (keyEnd == std::string_view::npos || pText[position] == '{' || pText[position] == '[')
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					std::string_view key = raw::getKey(pText.substr(position, keyEnd - position), storage);
+					for (uint32_t node : nodes)
+					{
+						if (auto it = mNodes[node].mKeys.find(key); it != mNodes[node].mKeys.end())
+							children.push_back(it->second);
+						if (mNodes[node].mAny != NONE)
+							children.push_back(mNodes[node].mAny);
+					}
+
+					position = raw::skipSpaces(pText, keyEnd);
+					if (position >= pText.size() || pText[position] != ':')
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+					position = raw::skipSpaces(pText, position + 1);
+				}
+				else
+				{
+					for (uint32_t node : nodes)
+					{
+						if (auto it = mNodes[node].mIndices.find(index); it != mNodes[node].mIndices.end())
+							children.push_back(it->second);
+						if (mNodes[node].mAny != NONE)
+							children.push_back(mNodes[node].mAny);
+					}
+				}
+
+				size_t valueEnd{};
+				if (children.empty())
+				{
+					valueEnd = raw::skipValue(pText, position);
+					if (valueEnd == std::string_view::npos)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, position));
+				}
+				else
+				{
+					JSONResult<size_t> scanned = scan(pText, position, pDepth + 1, pLevels, pMatches);
+					if (!scanned)
+						return scanned;
+					valueEnd = *scanned;
+				}
+				position = raw::skipSeparators(pText, valueEnd);
+			}
+		}
+
+		for (uint32_t node : nodes)
+		{
+			for (uint32_t selector : mNodes[node].mSelectors)
+				pMatches[selector].push_back(pText.substr(pPosition, end - pPosition));
+		}
+		return end;
+	}
+}
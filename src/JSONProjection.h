@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// matches of a projection: for every selector (in the order of compiling) -
+	// the text of every matched value in the order of the document;
+	//
+	using ProjectionMatches = std::vector<std::vector<std::string_view>>;
+
+	//
+	// a set of JSONPath-like selectors compiled into one matcher, which runs over the text once
+	// and fills the matches of all selectors; a subtree which no selector can match is stepped over
+	// by its brackets without being decoded or validated;
+	//
+	// selector syntax: $ is the root, then any sequence of
+	// .key  ['key']  ["key"]  - a member of an object,
+	// [3]                     - an element of an array,
+	// .*  [*]                 - every member or element;
+	//
+	// JSONResult<JSONProjection> projection = JSONProjection::compile({ "$.user.id", "$.items[*].price" });
+	// JSONResult<ProjectionMatches> matches = projection->run(text);
+	// (*matches)[1] - prices of all items;
+	//
+	class JSONProjection
+	{
+	public:
+		static JSONResult<JSONProjection> compile(std::span<const std::string_view> pSelectors);
+		static JSONResult<JSONProjection> compile(std::initializer_list<std::string_view> pSelectors);
+
+		//
+		// runs the matcher; views point into pText;
+		// the second overload reuses vectors of pMatches between documents;
+		//
+		JSONResult<ProjectionMatches> run(std::string_view pText) const;
+		JSONStatus run(std::string_view pText, ProjectionMatches& pMatches) const;
+
+		size_t getSelectorCount() const noexcept;
+
+		//
+		// decodes a matched text into a value;
+		//
+		static JSONResult<JSONValue> decode(std::string_view pMatch);
+
+	private:
+		static constexpr uint32_t NONE = static_cast<uint32_t>(-1);
+
+		//
+		// a node of the trie of selectors; selectors with a common prefix share nodes;
+		//
+		struct Node
+		{
+			std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> mKeys;
+			std::unordered_map<size_t, uint32_t> mIndices;
+			uint32_t mAny{ NONE };
+			// selectors which end at this node;
+			std::vector<uint32_t> mSelectors;
+
+			bool hasChildren() const noexcept;
+		};
+
+		//
+		// active nodes of every depth; depth is limited by the longest selector;
+		//
+		using Levels = std::vector<std::vector<uint32_t>>;
+
+	private:
+		JSONStatus addSelector(std::string_view pSelector, uint32_t pId);
+		uint32_t getChild(uint32_t pNode, std::string_view pKey);
+		uint32_t getChild(uint32_t pNode, size_t pIndex);
+		uint32_t getAnyChild(uint32_t pNode);
+
+		//
+		// scans the value at pPosition with the active nodes pLevels[pDepth];
+		// returns the position after the value;
+		//
+		JSONResult<size_t> scan(std::string_view pText, size_t pPosition, size_t pDepth,
+								Levels& pLevels, ProjectionMatches& pMatches) const;
+
+	private:
+		std::vector<Node> mNodes;
+		size_t mSelectorCount{};
+		size_t mMaxDepth{};
+	};
+
+	//
+	// JSONProjection implementation
+	//
+
+	inline size_t JSONProjection::getSelectorCount() const noexcept
+	{
+		return mSelectorCount;
+	}
+
+	inline bool JSONProjection::Node::hasChildren() const noexcept
+	{
+		return !mKeys.empty() || !mIndices.empty() || mAny != NONE;
+	}
+}
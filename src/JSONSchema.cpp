@@ -0,0 +1,406 @@
+#include "JSONSchema.h"
+#include "RawScan.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <charconv>
+#include <memory>
+#include <mutex>
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		//
+		// the tape of the thread, its entries survive between validate() calls;
+		// while the thread waits for a parallel check it may run a task which validates
+		// another document, such a nested call gets a tape of its own;
+		//
+		class LocalTape
+		{
+		public:
+			LocalTape()
+				: mSlot(getSlot())
+			{
+				if (mSlot.mInUse)
+					mOwned = std::make_unique<JSONTape>();
+				else
+					mSlot.mInUse = true;
+			}
+
+			~LocalTape()
+			{
+				if (mOwned == nullptr)
+					mSlot.mInUse = false;
+			}
+
+			LocalTape(const LocalTape&) = delete;
+			LocalTape& operator=(const LocalTape&) = delete;
+
+			JSONTape& get() noexcept
+			{
+				return mOwned != nullptr ? *mOwned : mSlot.mTape;
+			}
+
+		private:
+			struct Slot
+			{
+				JSONTape mTape;
+				bool mInUse{ false };
+			};
+
+			static Slot& getSlot()
+			{
+				thread_local Slot slot;
+				return slot;
+			}
+
+		private:
+			Slot& mSlot;
+			std::unique_ptr<JSONTape> mOwned;
+		};
+
+		bool toNumber(std::string_view pRaw, double& pNumber) noexcept
+		{
+			if (!pRaw.empty() && pRaw.front() == '+')
+				pRaw.remove_prefix(1);
+			const char* end = pRaw.data() + pRaw.size();
+			auto [ptr, errorCode] = std::from_chars(pRaw.data(), end, pNumber);
+			return errorCode == std::errc() && ptr == end;
+		}
+
+		//
+		// number of code points of a UTF-8 string;
+		//
+		size_t countCodePoints(std::string_view pText) noexcept
+		{
+			size_t count{};
+			for (char c : pText)
+				count += (static_cast<uint8_t>(c) & 0xC0) != 0x80 ? 1 : 0;
+			return count;
+		}
+	}
+
+	JSONResult<JSONSchema> JSONSchema::compile(std::string_view pSchema)
+	{
+		JSONResult<JSONTape> tape = JSONTape::create(pSchema);
+		if (!tape)
+			return std::unexpected(tape.error());
+		JSONSchema schema;
+		JSONResult<uint32_t> root = schema.compileRule(*tape, 0);
+		if (!root)
+			return std::unexpected(root.error());
+		return schema;
+	}
+
+	JSONResult<uint32_t> JSONSchema::compileRule(const JSONTape& pTape, size_t pIndex)
+	{
+		const JSONTape::Entry& entry = pTape[pIndex];
+		if (entry.mType != JSONTape::TokenType::LBRACE)
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, entry.mOffset));
+
+		uint32_t rule = static_cast<uint32_t>(mRules.size());
+		mRules.emplace_back();
+		std::string storage;
+		for (size_t member = pIndex + 1; member < entry.mMatch; member = pTape.skip(member + 1))
+		{
+			std::string keyword(raw::getKey(pTape.getRaw(member), storage));
+			size_t value = member + 1;
+			const JSONTape::Entry& valueEntry = pTape[value];
+			JSONError invalid = makeError(JSONErrorCode::INVALID_TEXT, valueEntry.mOffset);
+
+			if (keyword == "type")
+			{
+				// a name or a list of names;
+				size_t first = valueEntry.mType == JSONTape::TokenType::LBRACKET ? value + 1 : value;
+				size_t last = valueEntry.mType == JSONTape::TokenType::LBRACKET ? valueEntry.mMatch : value + 1;
+				if (first == last)
+					return std::unexpected(invalid);
+				for (size_t i = first; i < last; ++i)
+				{
+					std::string_view name = raw::getKey(pTape.getRaw(i), storage);
+					uint8_t type{};
+					if (name == "null")			type = NULL_TYPE;
+					else if (name == "boolean")	type = BOOLEAN_TYPE;
+					else if (name == "integer")	type = INTEGER_TYPE;
+					else if (name == "number")	type = NUMBER_TYPE;
+					else if (name == "string")	type = STRING_TYPE;
+					else if (name == "array")	type = ARRAY_TYPE;
+					else if (name == "object")	type = OBJECT_TYPE;
+					else
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pTape[i].mOffset));
+					mRules[rule].mTypes |= type;
+				}
+			}
+			else if (keyword == "properties")
+			{
+				if (valueEntry.mType != JSONTape::TokenType::LBRACE)
+					return std::unexpected(invalid);
+				for (size_t property = value + 1; property < valueEntry.mMatch; property = pTape.skip(property + 1))
+				{
+					std::string name(raw::getKey(pTape.getRaw(property), storage));
+					JSONResult<uint32_t> child = compileRule(pTape, property + 1);
+					if (!child)
+						return child;
+					mRules[rule].mProperties[name].mRule = *child;
+				}
+			}
+			else if (keyword == "required")
+			{
+				if (valueEntry.mType != JSONTape::TokenType::LBRACKET || valueEntry.mMatch - value - 1 > MAX_REQUIRED)
+					return std::unexpected(invalid);
+				for (size_t i = value + 1; i < valueEntry.mMatch; ++i)
+				{
+					if (pTape[i].mType != JSONTape::TokenType::STRING)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pTape[i].mOffset));
+					Property& property = mRules[rule].mProperties[std::string(raw::getKey(pTape.getRaw(i), storage))];
+					if (property.mRequiredBit == 0)
+					{
+						property.mRequiredBit = uint64_t{ 1 } << (i - value - 1);
+						mRules[rule].mRequiredMask |= property.mRequiredBit;
+					}
+				}
+			}
+			else if (keyword == "items")
+			{
+				JSONResult<uint32_t> child = compileRule(pTape, value);
+				if (!child)
+					return child;
+				mRules[rule].mItems = *child;
+			}
+			else if (keyword == "enum")
+			{
+				if (valueEntry.mType != JSONTape::TokenType::LBRACKET)
+					return std::unexpected(invalid);
+				for (size_t i = value + 1; i < valueEntry.mMatch; i = pTape.skip(i))
+				{
+					EnumValue option;
+					option.mType = getType(pTape, i);
+					if (option.mType == STRING_TYPE)
+					{
+						JSONResult<std::string> text = JSONTape::decodeString(pTape.getRaw(i));
+						if (!text)
+							return std::unexpected(makeError(text.error().mCode, pTape[i].mOffset));
+						option.mText = std::move(*text);
+					}
+					else if (option.mType == INTEGER_TYPE || option.mType == NUMBER_TYPE)
+					{
+						if (!toNumber(pTape.getRaw(i), option.mNumber))
+							return std::unexpected(makeError(JSONErrorCode::INVALID_NUMBER, pTape[i].mOffset));
+					}
+					else
+						option.mText = pTape.getRaw(i);
+					mRules[rule].mEnum.push_back(std::move(option));
+				}
+			}
+			else if (keyword == "minimum" || keyword == "maximum")
+			{
+				double bound{};
+				if (valueEntry.mType != JSONTape::TokenType::NUMBER || !toNumber(pTape.getRaw(value), bound))
+					return std::unexpected(invalid);
+				bool isMinimum = keyword == "minimum";
+				(isMinimum ? mRules[rule].mHasMinimum : mRules[rule].mHasMaximum) = true;
+				(isMinimum ? mRules[rule].mMinimum : mRules[rule].mMaximum) = bound;
+			}
+			else if (keyword == "maxLength")
+			{
+				std::string_view number = pTape.getRaw(value);
+				uint32_t length{};
+				auto [ptr, errorCode] = std::from_chars(number.data(), number.data() + number.size(), length);
+				if (valueEntry.mType != JSONTape::TokenType::NUMBER || errorCode != std::errc() ||
+					ptr != number.data() + number.size() || length == NONE)
+					return std::unexpected(invalid);
+				mRules[rule].mMaxLength = length;
+			}
+		}
+		return rule;
+	}
+
+	JSONStatus JSONSchema::validate(std::string_view pText) const
+	{
+		return validate(pText, ThreadPool::getDefault());
+	}
+
+	JSONStatus JSONSchema::validate(std::string_view pText, ThreadPool& pPool) const
+	{
+		LocalTape tape;
+		if (JSONStatus status = tape.get().build(pText); !status)
+			return status;
+		return validate(tape.get(), pPool);
+	}
+
+	JSONStatus JSONSchema::validate(const JSONTape& pTape, ThreadPool& pPool) const
+	{
+		if (pTape.size() == 0 || mRules.empty())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+		return check(pTape, 0, 0, &pPool);
+	}
+
+	JSONResult<JSONObject> JSONSchema::parse(std::string_view pText) const
+	{
+		LocalTape tape;
+		if (JSONStatus status = tape.get().build(pText); !status)
+			return std::unexpected(status.error());
+		if (JSONStatus status = validate(tape.get(), ThreadPool::getDefault()); !status)
+			return std::unexpected(status.error());
+		return tape.get().toObject();
+	}
+
+	uint8_t JSONSchema::getType(const JSONTape& pTape, size_t pIndex) noexcept
+	{
+		const JSONTape::Entry& entry = pTape[pIndex];
+		switch (entry.mType)
+		{
+		case JSONTape::TokenType::LBRACE:
+			return OBJECT_TYPE;
+		case JSONTape::TokenType::LBRACKET:
+			return ARRAY_TYPE;
+		case JSONTape::TokenType::KEYWORD:
+			return pTape.getRaw(pIndex) == "null" ? NULL_TYPE : BOOLEAN_TYPE;
+		case JSONTape::TokenType::NUMBER:
+			return pTape.getRaw(pIndex).find_first_of(".eE") == std::string_view::npos ? INTEGER_TYPE : NUMBER_TYPE;
+		default:
+			return STRING_TYPE;
+		}
+	}
+
+	JSONStatus JSONSchema::check(const JSONTape& pTape, size_t pIndex, uint32_t pRule, ThreadPool* pPool) const
+	{
+		const Rule& rule = mRules[pRule];
+		uint8_t type = getType(pTape, pIndex);
+		// an integer is a number as well;
+		uint8_t accepted = type == INTEGER_TYPE ? INTEGER_TYPE | NUMBER_TYPE : type;
+		if (rule.mTypes != 0 && (rule.mTypes & accepted) == 0)
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pTape[pIndex].mOffset));
+
+		if (type == OBJECT_TYPE && !rule.mProperties.empty())
+		{
+			if (JSONStatus status = checkObject(pTape, pIndex, rule, pPool); !status)
+				return status;
+		}
+		else if (type == ARRAY_TYPE && rule.mItems != NONE)
+		{
+			if (JSONStatus status = checkArray(pTape, pIndex, rule, pPool); !status)
+				return status;
+		}
+		return checkScalar(pTape, pIndex, type, rule);
+	}
+
+	JSONStatus JSONSchema::checkObject(const JSONTape& pTape, size_t pIndex, const Rule& pRule, ThreadPool* pPool) const
+	{
+		const JSONTape::Entry& entry = pTape[pIndex];
+		uint64_t seen{};
+		std::string storage;
+		for (size_t member = pIndex + 1; member < entry.mMatch; member = pTape.skip(member + 1))
+		{
+			auto it = pRule.mProperties.find(raw::getKey(pTape.getRaw(member), storage));
+			if (it == pRule.mProperties.end())
+				continue;
+			seen |= it->second.mRequiredBit;
+			if (it->second.mRule == NONE)
+				continue;
+			if (JSONStatus status = check(pTape, member + 1, it->second.mRule, pPool); !status)
+				return status;
+		}
+		if (seen != pRule.mRequiredMask)
+			return std::unexpected(makeError(JSONErrorCode::MISSING_KEY, entry.mOffset));
+		return {};
+	}
+
+	JSONStatus JSONSchema::checkArray(const JSONTape& pTape, size_t pIndex, const Rule& pRule, ThreadPool* pPool) const
+	{
+		if (pRule.mItems == NONE)
+			return {};
+		const JSONTape::Entry& entry = pTape[pIndex];
+
+		std::vector<uint32_t> elements;
+		for (size_t element = pIndex + 1; element < entry.mMatch; element = pTape.skip(element))
+			elements.push_back(static_cast<uint32_t>(element));
+
+		if (pPool == nullptr || elements.size() < PARALLEL_ELEMENTS)
+		{
+			for (uint32_t element : elements)
+			{
+				if (JSONStatus status = check(pTape, element, pRule.mItems, pPool); !status)
+					return status;
+			}
+			return {};
+		}
+
+		// the first failed element in the order of the array wins;
+		// chunks don't check elements after the best failure found so far;
+		std::atomic<size_t> firstFailed{ elements.size() };
+		JSONError firstError{};
+		std::mutex mutex;
+		pPool->parallelFor(elements.size(), [&](size_t pBegin, size_t pEnd)
+			{
+				for (size_t i = pBegin; i < pEnd && i < firstFailed.load(std::memory_order_relaxed); ++i)
+				{
+					JSONStatus status = check(pTape, elements[i], pRule.mItems, nullptr);
+					if (status)
+						continue;
+					std::lock_guard lock(mutex);
+					if (i < firstFailed.load(std::memory_order_relaxed))
+					{
+						firstError = status.error();
+						firstFailed.store(i, std::memory_order_relaxed);
+					}
+					return;
+				}
+			});
+		if (firstFailed.load() != elements.size())
+			return std::unexpected(firstError);
+		return {};
+	}
+
+	JSONStatus JSONSchema::checkScalar(const JSONTape& pTape, size_t pIndex, uint8_t pType, const Rule& pRule) const
+	{
+		size_t position = pTape[pIndex].mOffset;
+		std::string_view raw = pTape.getRaw(pIndex);
+		JSONError violation = makeError(JSONErrorCode::SCHEMA_VIOLATION, position);
+
+		double number{};
+		bool isNumber = pType == INTEGER_TYPE || pType == NUMBER_TYPE;
+		if (isNumber && (pRule.mHasMinimum || pRule.mHasMaximum || !pRule.mEnum.empty()))
+		{
+			if (!toNumber(raw, number))
+				return std::unexpected(makeError(JSONErrorCode::INVALID_NUMBER, position));
+			if ((pRule.mHasMinimum && number < pRule.mMinimum) || (pRule.mHasMaximum && number > pRule.mMaximum))
+				return std::unexpected(violation);
+		}
+
+		std::string decoded;
+		std::string_view text = raw;
+		if (pType == STRING_TYPE && (pRule.mMaxLength != NONE || !pRule.mEnum.empty()))
+		{
+			if (raw.size() >= 2 && raw.front() == '"')
+				text = raw.substr(1, raw.size() - 2);
+			if (text.find('\\') != std::string_view::npos)
+			{
+				JSONResult<std::string> string = JSONTape::decodeString(raw);
+				if (!string)
+					return std::unexpected(makeError(string.error().mCode, position));
+				decoded = std::move(*string);
+				text = decoded;
+			}
+			// a string has no more code points than bytes, thus short strings are not counted;
+			if (text.size() > pRule.mMaxLength && countCodePoints(text) > pRule.mMaxLength)
+				return std::unexpected(violation);
+		}
+
+		if (pRule.mEnum.empty())
+			return {};
+		for (const EnumValue& option : pRule.mEnum)
+		{
+			bool optionIsNumber = option.mType == INTEGER_TYPE || option.mType == NUMBER_TYPE;
+			if (isNumber ? optionIsNumber && option.mNumber == number : option.mType == pType && option.mText == text)
+				return {};
+		}
+		return std::unexpected(violation);
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "JSONParser.h"
+#include "JSONTape.h"
+
+namespace tng
+{
+	class ThreadPool;
+
+	//
+	// a JSON Schema compiled into a table of rules, which is checked against the token tape of a document;
+	// the document is lexed once and no DOM is built for validation, subtrees without rules are stepped over;
+	// elements of large arrays are checked in parallel on a thread pool;
+	//
+	// supported keywords: type (a name or a list of names), properties, required, items,
+	// enum, minimum, maximum, maxLength; other keywords are ignored;
+	//
+	// JSONResult<JSONSchema> schema = JSONSchema::compile(R"({"type": "object", "required": ["id"],
+	//													 "properties": {"id": {"type": "integer", "minimum": 1}}})");
+	// JSONStatus status = schema->validate(text);
+	// status.error().mCode - TYPE_MISMATCH, MISSING_KEY or SCHEMA_VIOLATION, mPosition - offset of the value;
+	//
+	class JSONSchema
+	{
+	public:
+		//
+		// arrays with at least this number of elements are split between threads;
+		//
+		static constexpr size_t PARALLEL_ELEMENTS = 512;
+
+		//
+		// an object may require at most this number of properties;
+		//
+		static constexpr size_t MAX_REQUIRED = 64;
+
+	public:
+		static JSONResult<JSONSchema> compile(std::string_view pSchema);
+
+		//
+		// checks the document against the schema (ThreadPool::getDefault() if pool is not passed);
+		// the reported error is the first one in the order of the document;
+		//
+		JSONStatus validate(std::string_view pText) const;
+		JSONStatus validate(std::string_view pText, ThreadPool& pPool) const;
+		JSONStatus validate(const JSONTape& pTape, ThreadPool& pPool) const;
+
+		//
+		// lexes the document once, validates it and builds the object from the same tape;
+		//
+		JSONResult<JSONObject> parse(std::string_view pText) const;
+
+		size_t getRuleCount() const noexcept;
+
+	private:
+		static constexpr uint32_t NONE = static_cast<uint32_t>(-1);
+
+		enum TypeMask : uint8_t
+		{
+			NULL_TYPE = 1 << 0,
+			BOOLEAN_TYPE = 1 << 1,
+			INTEGER_TYPE = 1 << 2,
+			NUMBER_TYPE = 1 << 3,
+			STRING_TYPE = 1 << 4,
+			ARRAY_TYPE = 1 << 5,
+			OBJECT_TYPE = 1 << 6
+		};
+
+		//
+		// a value of enum: decoded text for strings, the number for numbers, raw text otherwise;
+		//
+		struct EnumValue
+		{
+			uint8_t mType{};
+			std::string mText;
+			double mNumber{};
+		};
+
+		struct Property
+		{
+			uint32_t mRule{ NONE };
+			// bit of a required property in the mask of seen properties;
+			uint64_t mRequiredBit{};
+		};
+
+		//
+		// the compiled subschema; 0 in mTypes means any type;
+		//
+		struct Rule
+		{
+			uint8_t mTypes{};
+			bool mHasMinimum{ false };
+			bool mHasMaximum{ false };
+			double mMinimum{};
+			double mMaximum{};
+			uint32_t mMaxLength{ NONE };
+			uint32_t mItems{ NONE };
+			uint64_t mRequiredMask{};
+			std::unordered_map<std::string, Property, StringHash, std::equal_to<>> mProperties;
+			std::vector<EnumValue> mEnum;
+		};
+
+	private:
+		JSONResult<uint32_t> compileRule(const JSONTape& pTape, size_t pIndex);
+
+		//
+		// checks the value at pIndex; without a pool arrays are checked in the calling thread;
+		//
+		JSONStatus check(const JSONTape& pTape, size_t pIndex, uint32_t pRule, ThreadPool* pPool) const;
+		JSONStatus checkObject(const JSONTape& pTape, size_t pIndex, const Rule& pRule, ThreadPool* pPool) const;
+		JSONStatus checkArray(const JSONTape& pTape, size_t pIndex, const Rule& pRule, ThreadPool* pPool) const;
+		JSONStatus checkScalar(const JSONTape& pTape, size_t pIndex, uint8_t pType, const Rule& pRule) const;
+
+		static uint8_t getType(const JSONTape& pTape, size_t pIndex) noexcept;
+
+	private:
+		std::vector<Rule> mRules;
+	};
+
+	//
+	// JSONSchema implementation
+	//
+
+	inline size_t JSONSchema::getRuleCount() const noexcept
+	{
+		return mRules.size();
+	}
+}
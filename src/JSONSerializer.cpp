@@ -0,0 +1,405 @@
+#include "JSONSerializer.h"
+#include "SIMDScan.h"
+
+#include <cmath>
+
+namespace tng
+{
+	namespace
+	{
+		//
+		// the longest shortest-round-trip texts: "-1.17549435e-38", "-1.7976931348623157e+308"
+		// and "-9223372036854775808";
+		//
+		constexpr size_t MAX_FLOAT_LENGTH = 16;
+		constexpr size_t MAX_DOUBLE_LENGTH = 24;
+		constexpr size_t MAX_INTEGER_LENGTH = 20;
+
+		template<typename T>
+		constexpr size_t maxNumberLength() noexcept
+		{
+			if constexpr (std::is_same_v<T, float>)
+				return MAX_FLOAT_LENGTH;
+			else if constexpr (std::is_floating_point_v<T>)
+				return MAX_DOUBLE_LENGTH;
+			else
+				return MAX_INTEGER_LENGTH;
+		}
+
+		//
+		// writes the shortest text, which reads back to the same float/double (std::to_chars);
+		// integral values below 2^24 (float) or 2^53 (double) take the integer path,
+		// which is several times cheaper and prints them with all digits ("100000000", not "1e+08");
+		// NaN and infinity are written as null, because JSON has no representation for them;
+		//
+		template<typename T>
+		char* writeFloat(T pNumber, char* pCursor) noexcept
+		{
+			constexpr T exactLimit = std::is_same_v<T, float> ? T(1 << 24) : T(1ull << 53);
+			if (!std::isfinite(pNumber))
+			{
+				std::memcpy(pCursor, "null", 4);
+				return pCursor + 4;
+			}
+			if (std::abs(pNumber) < exactLimit)
+			{
+				int64_t integral = static_cast<int64_t>(pNumber);
+				if (static_cast<T>(integral) == pNumber && (integral != 0 || !std::signbit(pNumber)))
+					return std::to_chars(pCursor, pCursor + MAX_INTEGER_LENGTH, integral).ptr;
+			}
+			return std::to_chars(pCursor, pCursor + maxNumberLength<T>(), pNumber).ptr;
+		}
+
+		template<typename T>
+		char* writeNumber(T pNumber, char* pCursor) noexcept
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return writeFloat(pNumber, pCursor);
+			else
+				return std::to_chars(pCursor, pCursor + MAX_INTEGER_LENGTH, pNumber).ptr;
+		}
+
+		//
+		// returns the letter after '\' for the character, or 'u' if it is written as \u00XX;
+		//
+		constexpr char escapeLetter(unsigned char pChar) noexcept
+		{
+			switch (pChar)
+			{
+			case '"':  return '"';
+			case '\\': return '\\';
+			case '\b': return 'b';
+			case '\f': return 'f';
+			case '\n': return 'n';
+			case '\r': return 'r';
+			case '\t': return 't';
+			default:   return 'u';
+			}
+		}
+
+		//
+		// the first pass: counts bytes of the output;
+		//
+		struct SizeCounter
+		{
+			const SerializeOptions& mOptions;
+			size_t mSize{};
+
+			void put(char) noexcept
+			{
+				mSize++;
+			}
+
+			void putRaw(std::string_view pText) noexcept
+			{
+				mSize += pText.size();
+			}
+
+			void putIndent(uint32_t pDepth) noexcept
+			{
+				mSize += 1 + static_cast<size_t>(pDepth) * mOptions.mIndent;
+			}
+
+			void putString(std::string_view pString) noexcept
+			{
+				mSize += pString.size() + 2;
+				for (size_t i = simd::findEscape(pString, 0); i < pString.size(); i = simd::findEscape(pString, i + 1))
+					mSize += escapeLetter(static_cast<unsigned char>(pString[i])) == 'u' ? 5 : 1;
+			}
+
+			template<typename T>
+			void putNumber(T pNumber) noexcept
+			{
+				if constexpr (std::is_floating_point_v<T>)
+					mSize += maxNumberLength<T>();
+				else
+				{
+					uint64_t magnitude = pNumber < 0 ? 0 - static_cast<uint64_t>(pNumber) : static_cast<uint64_t>(pNumber);
+					size_t length = pNumber < 0 ? 2 : 1;
+					for (; magnitude >= 10; magnitude /= 10)
+						length++;
+					mSize += length;
+				}
+			}
+		};
+
+		//
+		// the second pass: writes into the buffer, which is already big enough;
+		//
+		struct BufferWriter
+		{
+			const SerializeOptions& mOptions;
+			char* mCursor{ nullptr };
+
+			void put(char pChar) noexcept
+			{
+				*mCursor++ = pChar;
+			}
+
+			void putRaw(std::string_view pText) noexcept
+			{
+				std::memcpy(mCursor, pText.data(), pText.size());
+				mCursor += pText.size();
+			}
+
+			void putIndent(uint32_t pDepth) noexcept
+			{
+				size_t spaces = static_cast<size_t>(pDepth) * mOptions.mIndent;
+				*mCursor++ = '\n';
+				std::memset(mCursor, ' ', spaces);
+				mCursor += spaces;
+			}
+
+			//
+			// escape-free runs are found by the vector scan and copied at once;
+			//
+			void putString(std::string_view pString) noexcept
+			{
+				static constexpr char hexDigits[] = "0123456789abcdef";
+				*mCursor++ = '"';
+				size_t begin{};
+				while (true)
+				{
+					size_t end = simd::findEscape(pString, begin);
+					putRaw(pString.substr(begin, end - begin));
+					if (end == pString.size())
+						break;
+
+					unsigned char c = static_cast<unsigned char>(pString[end]);
+					char letter = escapeLetter(c);
+					*mCursor++ = '\\';
+					*mCursor++ = letter;
+					if (letter == 'u')
+					{
+						putRaw("00");
+						*mCursor++ = hexDigits[c >> 4];
+						*mCursor++ = hexDigits[c & 0xF];
+					}
+					begin = end + 1;
+				}
+				*mCursor++ = '"';
+			}
+
+			template<typename T>
+			void putNumber(T pNumber) noexcept
+			{
+				mCursor = writeNumber(pNumber, mCursor);
+			}
+		};
+	}
+
+	void JSONSerializer::serialize(const JSONObject& pObject, std::string& pOutput, const SerializeOptions& pOptions)
+	{
+		append(pObject, pOutput, pOptions);
+	}
+
+	void JSONSerializer::serialize(const JSONValue& pValue, std::string& pOutput, const SerializeOptions& pOptions)
+	{
+		append(pValue, pOutput, pOptions);
+	}
+
+	std::string JSONSerializer::toString(const JSONObject& pObject, const SerializeOptions& pOptions)
+	{
+		std::string output;
+		append(pObject, output, pOptions);
+		return output;
+	}
+
+	size_t JSONSerializer::measure(const JSONObject& pObject, const SerializeOptions& pOptions)
+	{
+		SizeCounter counter{ pOptions };
+		writeObject(pObject, counter, 0);
+		return counter.mSize;
+	}
+
+	size_t JSONSerializer::measure(const JSONValue& pValue, const SerializeOptions& pOptions)
+	{
+		SizeCounter counter{ pOptions };
+		writeValue(pValue, counter, 0);
+		return counter.mSize;
+	}
+
+	void JSONSerializer::serializeArray(std::span<const double> pNumbers, std::string& pOutput)
+	{
+		appendNumbers(pNumbers, pNumbers.size(), false, pOutput);
+	}
+
+	void JSONSerializer::serializeArray(std::span<const float> pNumbers, std::string& pOutput)
+	{
+		appendNumbers(pNumbers, pNumbers.size(), false, pOutput);
+	}
+
+	void JSONSerializer::serializeArray(std::span<const int64_t> pNumbers, std::string& pOutput)
+	{
+		appendNumbers(pNumbers, pNumbers.size(), false, pOutput);
+	}
+
+	void JSONSerializer::serializeMatrix(std::span<const double> pNumbers, size_t pColumns, std::string& pOutput)
+	{
+		appendNumbers(pNumbers, pColumns, true, pOutput);
+	}
+
+	void JSONSerializer::serializeMatrix(std::span<const float> pNumbers, size_t pColumns, std::string& pOutput)
+	{
+		appendNumbers(pNumbers, pColumns, true, pOutput);
+	}
+
+	template<typename T>
+	void JSONSerializer::appendNumbers(std::span<const T> pNumbers, size_t pColumns, bool pIsMatrix, std::string& pOutput)
+	{
+		// a plain array is written as a single row without the outer brackets;
+		pColumns = std::max<size_t>(pColumns, 1);
+		size_t rows = pIsMatrix ? (pNumbers.size() + pColumns - 1) / pColumns : 1;
+		size_t oldSize = pOutput.size();
+		size_t bound = pNumbers.size() * (maxNumberLength<T>() + 1) + rows * 3 + 2;
+		pOutput.resize_and_overwrite(oldSize + bound, [&](char* pData, size_t)
+			{
+				char* cursor = pData + oldSize;
+				if (pIsMatrix)
+					*cursor++ = '[';
+				for (size_t row = 0; row < rows; ++row)
+				{
+					if (row != 0)
+						*cursor++ = ',';
+					*cursor++ = '[';
+					size_t begin = row * pColumns;
+					size_t end = pIsMatrix ? std::min(begin + pColumns, pNumbers.size()) : pNumbers.size();
+					for (size_t i = begin; i < end; ++i)
+					{
+						if (i != begin)
+							*cursor++ = ',';
+						cursor = writeNumber(pNumbers[i], cursor);
+					}
+					*cursor++ = ']';
+				}
+				if (pIsMatrix)
+					*cursor++ = ']';
+				return static_cast<size_t>(cursor - pData);
+			});
+	}
+
+	template<typename Value>
+	void JSONSerializer::append(const Value& pValue, std::string& pOutput, const SerializeOptions& pOptions)
+	{
+		size_t oldSize = pOutput.size();
+		size_t bound = measure(pValue, pOptions);
+		pOutput.resize_and_overwrite(oldSize + bound, [&](char* pData, size_t)
+			{
+				BufferWriter writer{ pOptions, pData + oldSize };
+				if constexpr (std::is_same_v<Value, JSONObject>)
+					writeObject(pValue, writer, 0);
+				else
+					writeValue(pValue, writer, 0);
+				return static_cast<size_t>(writer.mCursor - pData);
+			});
+	}
+
+	template<typename Output>
+	void JSONSerializer::writeValue(const JSONValue& pValue, Output& pOutput, uint32_t pDepth)
+	{
+		std::visit([&](const auto& pContained)
+			{
+				using T = std::decay_t<decltype(pContained)>;
+				if constexpr (std::is_same_v<T, bool>)
+					pOutput.putRaw(pContained ? "true" : "false");
+				else if constexpr (std::is_same_v<T, std::string>)
+					pOutput.putString(pContained);
+				else if constexpr (std::is_same_v<T, std::vector<JSONValue>>)
+					writeArray(pContained, pOutput, pDepth);
+				else if constexpr (std::is_same_v<T, std::vector<std::vector<JSONValue>>>)
+					writeNestedArray(pContained, pOutput, pDepth);
+				else if constexpr (std::is_same_v<T, std::shared_ptr<const JSONObject>>)
+				{
+					if (pContained != nullptr)
+						writeObject(*pContained, pOutput, pDepth);
+					else
+						pOutput.putRaw("null");
+				}
+				else if constexpr (std::is_same_v<T, std::nullptr_t>)
+					pOutput.putRaw("null");
+				else
+					pOutput.putNumber(pContained);
+			}, pValue.mValue);
+	}
+
+	template<typename Output>
+	void JSONSerializer::writeObject(const JSONObject& pObject, Output& pOutput, uint32_t pDepth)
+	{
+		auto& storage = pObject.getStorage();
+		if (storage.empty())
+		{
+			pOutput.putRaw("{}");
+			return;
+		}
+
+		bool pretty = pOutput.mOptions.mPretty;
+		pOutput.put('{');
+		bool first = true;
+		for (auto& [key, value] : storage)
+		{
+			if (!first)
+				pOutput.put(',');
+			first = false;
+			if (pretty)
+				pOutput.putIndent(pDepth + 1);
+			pOutput.putString(key);
+			pOutput.putRaw(pretty ? ": " : ":");
+			writeValue(value, pOutput, pDepth + 1);
+		}
+		if (pretty)
+			pOutput.putIndent(pDepth);
+		pOutput.put('}');
+	}
+
+	template<typename Output>
+	void JSONSerializer::writeArray(const std::vector<JSONValue>& pArray, Output& pOutput, uint32_t pDepth)
+	{
+		if (pArray.empty())
+		{
+			pOutput.putRaw("[]");
+			return;
+		}
+
+		bool pretty = pOutput.mOptions.mPretty;
+		pOutput.put('[');
+		bool first = true;
+		for (auto& element : pArray)
+		{
+			if (!first)
+				pOutput.put(',');
+			first = false;
+			if (pretty)
+				pOutput.putIndent(pDepth + 1);
+			writeValue(element, pOutput, pDepth + 1);
+		}
+		if (pretty)
+			pOutput.putIndent(pDepth);
+		pOutput.put(']');
+	}
+
+	template<typename Output>
+	void JSONSerializer::writeNestedArray(const std::vector<std::vector<JSONValue>>& pArray, Output& pOutput, uint32_t pDepth)
+	{
+		if (pArray.empty())
+		{
+			pOutput.putRaw("[]");
+			return;
+		}
+
+		bool pretty = pOutput.mOptions.mPretty;
+		pOutput.put('[');
+		bool first = true;
+		for (auto& row : pArray)
+		{
+			if (!first)
+				pOutput.put(',');
+			first = false;
+			if (pretty)
+				pOutput.putIndent(pDepth + 1);
+			writeArray(row, pOutput, pDepth + 1);
+		}
+		if (pretty)
+			pOutput.putIndent(pDepth);
+		pOutput.put(']');
+	}
+}
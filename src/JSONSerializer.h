@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <span>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// options of JSONSerializer;
+	//
+	struct SerializeOptions
+	{
+		//
+		// puts every member and element on its own line, indented by mIndent spaces
+		// per level (the same layout as nlohmann::json::dump(4));
+		//
+		bool mPretty{ false };
+		uint32_t mIndent{ 4 };
+	};
+
+	//
+	// writes JSONValue/JSONObject as JSON text directly, without nlohmann::json;
+	// output is appended to the passed buffer, thus one buffer can be reused for many documents;
+	// the output size is measured first, so the buffer grows at most once per call;
+	//
+	class JSONSerializer
+	{
+	public:
+		//
+		// appends JSON text of the object/value to pOutput;
+		//
+		static void serialize(const JSONObject& pObject, std::string& pOutput, const SerializeOptions& pOptions = {});
+		static void serialize(const JSONValue& pValue, std::string& pOutput, const SerializeOptions& pOptions = {});
+
+		//
+		// returns JSON text of the object;
+		//
+		static std::string toString(const JSONObject& pObject, const SerializeOptions& pOptions = {});
+
+		//
+		// returns the size of JSON text of the object/value;
+		// it is exact, except for floats, which are counted with their maximal length;
+		//
+		static size_t measure(const JSONObject& pObject, const SerializeOptions& pOptions = {});
+		static size_t measure(const JSONValue& pValue, const SerializeOptions& pOptions = {});
+
+		//
+		// appends numbers as a JSON array, with one allocation for the whole array;
+		// floats are written as the shortest text which reads back to the same value;
+		//
+		static void serializeArray(std::span<const double> pNumbers, std::string& pOutput);
+		static void serializeArray(std::span<const float> pNumbers, std::string& pOutput);
+		static void serializeArray(std::span<const int64_t> pNumbers, std::string& pOutput);
+
+		//
+		// appends a row-major matrix with pColumns columns as an array of rows;
+		//
+		static void serializeMatrix(std::span<const double> pNumbers, size_t pColumns, std::string& pOutput);
+		static void serializeMatrix(std::span<const float> pNumbers, size_t pColumns, std::string& pOutput);
+
+	private:
+		//
+		// one traversal is used for both passes: Output is either a counter of bytes
+		// or a writer into the preallocated buffer;
+		//
+		template<typename Output>
+		static void writeValue(const JSONValue& pValue, Output& pOutput, uint32_t pDepth);
+		template<typename Output>
+		static void writeObject(const JSONObject& pObject, Output& pOutput, uint32_t pDepth);
+		template<typename Output>
+		static void writeArray(const std::vector<JSONValue>& pArray, Output& pOutput, uint32_t pDepth);
+		template<typename Output>
+		static void writeNestedArray(const std::vector<std::vector<JSONValue>>& pArray, Output& pOutput, uint32_t pDepth);
+
+		//
+		// writes numbers as an array, or as an array of rows of pColumns numbers if pIsMatrix;
+		//
+		template<typename T>
+		static void appendNumbers(std::span<const T> pNumbers, size_t pColumns, bool pIsMatrix, std::string& pOutput);
+
+		//
+		// measures and then writes pValue to the end of pOutput;
+		//
+		template<typename Value>
+		static void append(const Value& pValue, std::string& pOutput, const SerializeOptions& pOptions);
+	};
+}
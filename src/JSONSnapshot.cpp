@@ -0,0 +1,468 @@
+#include "JSONSnapshot.h"
+#include "JSONTape.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+namespace tng
+{
+	namespace
+	{
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		//
+		// the same classification as JSONTape::decodeNumber(), but 64 bits wide;
+		//
+		JSONStatus decodeNumber(std::string_view pRaw, SnapshotNode& pNode) noexcept
+		{
+			if (!pRaw.empty() && pRaw.front() == '+')
+				pRaw.remove_prefix(1);
+
+			const char* begin = pRaw.data();
+			const char* end = pRaw.data() + pRaw.size();
+			std::from_chars_result result{};
+			if (pRaw.find_first_of(".eE") != std::string_view::npos)
+			{
+				double number{};
+				result = std::from_chars(begin, end, number);
+				pNode.mType = SnapshotType::DOUBLE;
+				pNode.mPayload = std::bit_cast<uint64_t>(number);
+			}
+			else if (!pRaw.empty() && pRaw.front() == '-')
+			{
+				int64_t number{};
+				result = std::from_chars(begin, end, number);
+				pNode.mType = SnapshotType::INT;
+				pNode.mPayload = static_cast<uint64_t>(number);
+			}
+			else
+			{
+				uint64_t number{};
+				result = std::from_chars(begin, end, number);
+				pNode.mType = SnapshotType::UINT;
+				pNode.mPayload = number;
+			}
+
+			if (result.ec == std::errc::result_out_of_range)
+				return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, 0));
+			if (result.ec != std::errc() || result.ptr != end)
+				return std::unexpected(makeError(JSONErrorCode::INVALID_NUMBER, 0));
+			return {};
+		}
+
+		//
+		// writes snapshot nodes into a region of the output which is reserved up front
+		// and appends strings after it;
+		//
+		class SnapshotWriter
+		{
+		public:
+			SnapshotWriter(std::string& pOutput, size_t pBase, uint64_t pNodeCount)
+				: mOutput(pOutput)
+				, mNodes(pBase + sizeof(SnapshotHeader))
+				, mStrings(mNodes + pNodeCount * sizeof(SnapshotNode))
+			{
+				SnapshotHeader header;
+				std::memcpy(header.mMagic, SnapshotHeader::MAGIC, sizeof(header.mMagic));
+				header.mVersion = SnapshotHeader::VERSION;
+				header.mByteOrder = SnapshotHeader::ENDIAN_MARK;
+				header.mNodeCount = pNodeCount;
+				header.mNodeOffset = sizeof(SnapshotHeader);
+				header.mStringOffset = mStrings - pBase;
+				mOutput.resize(mStrings);
+				std::memcpy(mOutput.data() + pBase, &header, sizeof(header));
+			}
+
+			void putNode(uint64_t pIndex, const SnapshotNode& pNode) noexcept
+			{
+				std::memcpy(mOutput.data() + mNodes + pIndex * sizeof(SnapshotNode), &pNode, sizeof(pNode));
+			}
+
+			//
+			// appends the string and points pNode at it; keys are stored once;
+			//
+			void putString(std::string_view pString, bool pIsKey, SnapshotNode& pNode)
+			{
+				pNode.mType = SnapshotType::STRING;
+				pNode.mSize = static_cast<uint32_t>(pString.size());
+				if (pIsKey)
+				{
+					auto it = mKeys.find(pString);
+					if (it != mKeys.end())
+					{
+						pNode.mPayload = it->second;
+						return;
+					}
+				}
+				pNode.mPayload = mOutput.size() - mStrings;
+				mOutput.append(pString);
+				if (pIsKey)
+					mKeys.emplace(pString, pNode.mPayload);
+			}
+
+			//
+			// writes the size of the string blob into the header;
+			//
+			void finish(size_t pBase) noexcept
+			{
+				uint64_t stringSize = mOutput.size() - mStrings;
+				std::memcpy(mOutput.data() + pBase + offsetof(SnapshotHeader, mStringSize), &stringSize, sizeof(stringSize));
+			}
+
+		private:
+			std::string& mOutput;
+			size_t mNodes;
+			size_t mStrings;
+			std::unordered_map<std::string, uint64_t, StringHash, std::equal_to<>> mKeys;
+		};
+	}
+
+	//
+	// JSONSnapshot
+	//
+
+	JSONSnapshot::JSONSnapshot(JSONSnapshot&& pOther) noexcept
+	{
+		*this = std::move(pOther);
+	}
+
+	JSONSnapshot& JSONSnapshot::operator=(JSONSnapshot&& pOther) noexcept
+	{
+		if (this == &pOther)
+			return *this;
+		bool owned = !pOther.mFile.getView().empty();
+		mFile = std::move(pOther.mFile);
+		if (owned)
+			attach(mFile.getView());
+		else
+		{
+			mData = pOther.mData;
+			mNodes = pOther.mNodes;
+			mNodeCount = pOther.mNodeCount;
+			mStrings = pOther.mStrings;
+		}
+		pOther.mData = {};
+		pOther.mNodes = nullptr;
+		pOther.mNodeCount = 0;
+		pOther.mStrings = {};
+		return *this;
+	}
+
+	JSONStatus JSONSnapshot::build(std::string_view pText, std::string& pOutput)
+	{
+		JSONResult<JSONTape> tape = JSONTape::create(pText);
+		if (!tape)
+			return std::unexpected(tape.error());
+
+		using TokenType = JSONTape::TokenType;
+		uint64_t nodeCount{};
+		for (const JSONTape::Entry& entry : tape->getEntries())
+			nodeCount += entry.mType != TokenType::RBRACE && entry.mType != TokenType::RBRACKET ? 1 : 0;
+
+		struct Frame
+		{
+			uint64_t mNode{};
+			uint32_t mChildren{};
+			bool mIsObject{ false };
+		};
+
+		size_t base = pOutput.size();
+		SnapshotWriter writer(pOutput, base, nodeCount);
+		std::vector<Frame> frames;
+		std::string decoded;
+		uint64_t node{};
+		for (size_t i = 0; i < tape->size(); ++i)
+		{
+			const JSONTape::Entry& entry = (*tape)[i];
+			SnapshotNode current;
+			switch (entry.mType)
+			{
+			case TokenType::RBRACE:
+			case TokenType::RBRACKET:
+			{
+				Frame frame = frames.back();
+				frames.pop_back();
+				current.mType = frame.mIsObject ? SnapshotType::OBJECT : SnapshotType::ARRAY;
+				current.mSize = frame.mIsObject ? frame.mChildren / 2 : frame.mChildren;
+				current.mPayload = node;
+				writer.putNode(frame.mNode, current);
+				continue;
+			}
+			default:
+				break;
+			}
+
+			bool isKey{ false };
+			if (!frames.empty())
+			{
+				++frames.back().mChildren;
+				isKey = frames.back().mIsObject && frames.back().mChildren % 2 == 1;
+			}
+
+			if (entry.mType == TokenType::LBRACE || entry.mType == TokenType::LBRACKET)
+			{
+				// the node is written when the container is closed;
+				frames.push_back(Frame{ node, 0, entry.mType == TokenType::LBRACE });
+				++node;
+				continue;
+			}
+
+			std::string_view raw = tape->getRaw(i);
+			if (isKey || entry.mType == TokenType::STRING)
+			{
+				// a string without escapes is copied straight from the text;
+				if (raw.find('\\') == std::string_view::npos)
+					writer.putString(raw.size() >= 2 && raw.front() == '"' ? raw.substr(1, raw.size() - 2) : raw, isKey, current);
+				else
+				{
+					JSONResult<std::string> string = JSONTape::decodeString(raw);
+					if (!string)
+					{
+						pOutput.resize(base);
+						return std::unexpected(makeError(string.error().mCode, entry.mOffset + string.error().mPosition));
+					}
+					decoded = std::move(*string);
+					writer.putString(decoded, isKey, current);
+				}
+			}
+			else if (entry.mType == TokenType::NUMBER)
+			{
+				if (JSONStatus status = decodeNumber(raw, current); !status)
+				{
+					pOutput.resize(base);
+					return std::unexpected(makeError(status.error().mCode, entry.mOffset));
+				}
+			}
+			else if (raw != "null")
+			{
+				current.mType = SnapshotType::BOOL;
+				current.mSize = raw == "true" ? 1 : 0;
+			}
+			writer.putNode(node++, current);
+		}
+		writer.finish(base);
+		return {};
+	}
+
+	JSONResult<JSONSnapshot> JSONSnapshot::open(const std::filesystem::path& pPath)
+	{
+		FileReadOptions options;
+		options.mMinMappedSize = 0;
+		options.mPopulate = false;
+		options.mSequential = false;
+
+		JSONSnapshot snapshot;
+		JSONResult<FileBuffer> file = FileBuffer::open(pPath, options);
+		if (!file)
+			return std::unexpected(file.error());
+		snapshot.mFile = std::move(*file);
+		if (JSONStatus status = snapshot.attach(snapshot.mFile.getView()); !status)
+			return std::unexpected(status.error());
+		return snapshot;
+	}
+
+	JSONResult<JSONSnapshot> JSONSnapshot::view(std::string_view pData)
+	{
+		JSONSnapshot snapshot;
+		if (JSONStatus status = snapshot.attach(pData); !status)
+			return std::unexpected(status.error());
+		return snapshot;
+	}
+
+	JSONStatus JSONSnapshot::attach(std::string_view pData) noexcept
+	{
+		SnapshotHeader header;
+		if (pData.size() < sizeof(header) || reinterpret_cast<uintptr_t>(pData.data()) % alignof(SnapshotNode) != 0)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+		std::memcpy(&header, pData.data(), sizeof(header));
+
+		// every size is checked before it is multiplied or added, thus nothing overflows;
+		uint64_t size = pData.size();
+		bool valid = std::memcmp(header.mMagic, SnapshotHeader::MAGIC, sizeof(header.mMagic)) == 0 &&
+					 header.mVersion == SnapshotHeader::VERSION &&
+					 header.mByteOrder == SnapshotHeader::ENDIAN_MARK &&
+					 header.mNodeOffset == sizeof(SnapshotHeader) &&
+					 header.mNodeCount <= (size - header.mNodeOffset) / sizeof(SnapshotNode) &&
+					 header.mStringOffset == header.mNodeOffset + header.mNodeCount * sizeof(SnapshotNode) &&
+					 header.mStringSize == size - header.mStringOffset;
+		if (!valid)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+
+		mData = pData;
+		mNodes = reinterpret_cast<const SnapshotNode*>(pData.data() + header.mNodeOffset);
+		mNodeCount = header.mNodeCount;
+		mStrings = pData.substr(static_cast<size_t>(header.mStringOffset));
+		return {};
+	}
+
+	std::string_view JSONSnapshot::getString(const SnapshotNode& pNode) const noexcept
+	{
+		if (pNode.mPayload > mStrings.size() || pNode.mSize > mStrings.size() - pNode.mPayload)
+			return {};
+		return mStrings.substr(static_cast<size_t>(pNode.mPayload), pNode.mSize);
+	}
+
+	uint64_t JSONSnapshot::skip(uint64_t pIndex) const noexcept
+	{
+		const SnapshotNode* node = getNode(pIndex);
+		if (node == nullptr)
+			return mNodeCount;
+		if (node->mType != SnapshotType::ARRAY && node->mType != SnapshotType::OBJECT)
+			return pIndex + 1;
+		// a damaged end would loop or jump back;
+		return node->mPayload > pIndex && node->mPayload <= mNodeCount ? node->mPayload : mNodeCount;
+	}
+
+	//
+	// SnapshotValue
+	//
+
+	std::optional<bool> SnapshotValue::getBool() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		if (node == nullptr || node->mType != SnapshotType::BOOL)
+			return std::nullopt;
+		return node->mSize != 0;
+	}
+
+	std::optional<int64_t> SnapshotValue::getInt() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		if (node == nullptr)
+			return std::nullopt;
+		if (node->mType == SnapshotType::INT)
+			return static_cast<int64_t>(node->mPayload);
+		if (node->mType == SnapshotType::UINT && node->mPayload <= static_cast<uint64_t>(INT64_MAX))
+			return static_cast<int64_t>(node->mPayload);
+		return std::nullopt;
+	}
+
+	std::optional<uint64_t> SnapshotValue::getUint() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		if (node == nullptr)
+			return std::nullopt;
+		if (node->mType == SnapshotType::UINT)
+			return node->mPayload;
+		if (node->mType == SnapshotType::INT && static_cast<int64_t>(node->mPayload) >= 0)
+			return node->mPayload;
+		return std::nullopt;
+	}
+
+	std::optional<double> SnapshotValue::getDouble() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		if (node == nullptr)
+			return std::nullopt;
+		switch (node->mType)
+		{
+		case SnapshotType::DOUBLE: return std::bit_cast<double>(node->mPayload);
+		case SnapshotType::INT:	   return static_cast<double>(static_cast<int64_t>(node->mPayload));
+		case SnapshotType::UINT:   return static_cast<double>(node->mPayload);
+		default:				   return std::nullopt;
+		}
+	}
+
+	std::optional<std::string_view> SnapshotValue::getString() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		if (node == nullptr || node->mType != SnapshotType::STRING)
+			return std::nullopt;
+		return mSnapshot->getString(*node);
+	}
+
+	std::string_view SnapshotValue::getKey() const noexcept
+	{
+		const SnapshotNode* key = mKey != NO_KEY && mSnapshot != nullptr ? mSnapshot->getNode(mKey) : nullptr;
+		if (key == nullptr || key->mType != SnapshotType::STRING)
+			return {};
+		return mSnapshot->getString(*key);
+	}
+
+	SnapshotValue SnapshotValue::operator[](std::string_view pKey) const noexcept
+	{
+		SnapshotValue found;
+		if (!isObject())
+			return found;
+		uint64_t end = mSnapshot->skip(mIndex);
+		for (uint64_t key = mIndex + 1; key + 1 < end; key = mSnapshot->skip(key + 1))
+		{
+			const SnapshotNode* node = mSnapshot->getNode(key);
+			if (node->mType == SnapshotType::STRING && mSnapshot->getString(*node) == pKey)
+				found = SnapshotValue(mSnapshot, key + 1, key);
+		}
+		return found;
+	}
+
+	SnapshotValue SnapshotValue::getElement(uint64_t pIndex) const noexcept
+	{
+		if (!isArray() || pIndex >= size())
+			return SnapshotValue();
+		uint64_t end = mSnapshot->skip(mIndex);
+		uint64_t element = mIndex + 1;
+		for (uint64_t i = 0; i < pIndex && element < end; ++i)
+			element = mSnapshot->skip(element);
+		return element < end ? SnapshotValue(mSnapshot, element, NO_KEY) : SnapshotValue();
+	}
+
+	SnapshotValue::iterator SnapshotValue::begin() const noexcept
+	{
+		SnapshotType type = getType();
+		if (type != SnapshotType::ARRAY && type != SnapshotType::OBJECT)
+			return iterator();
+		return iterator(mSnapshot, mIndex + 1, mSnapshot->skip(mIndex), type == SnapshotType::OBJECT);
+	}
+
+	SnapshotValue::iterator SnapshotValue::end() const noexcept
+	{
+		SnapshotType type = getType();
+		if (type != SnapshotType::ARRAY && type != SnapshotType::OBJECT)
+			return iterator();
+		uint64_t end = mSnapshot->skip(mIndex);
+		return iterator(mSnapshot, end, end, type == SnapshotType::OBJECT);
+	}
+
+	//
+	// SnapshotValue::iterator
+	//
+
+	SnapshotValue::iterator::iterator(const JSONSnapshot* pSnapshot, uint64_t pIndex, uint64_t pEnd, bool pIsObject) noexcept
+		: mSnapshot(pSnapshot)
+		, mIndex(std::min(pIndex, pEnd))
+		, mEnd(pEnd)
+		, mIsObject(pIsObject)
+	{
+	}
+
+	SnapshotValue SnapshotValue::iterator::operator*() const noexcept
+	{
+		if (mIsObject)
+			return SnapshotValue(mSnapshot, mIndex + 1, mIndex);
+		return SnapshotValue(mSnapshot, mIndex, NO_KEY);
+	}
+
+	SnapshotValue::iterator& SnapshotValue::iterator::operator++() noexcept
+	{
+		// a damaged subtree cant move the iterator past the end of its container;
+		mIndex = std::min(mSnapshot->skip(mIsObject ? mIndex + 1 : mIndex), mEnd);
+		return *this;
+	}
+
+	SnapshotValue::iterator SnapshotValue::iterator::operator++(int) noexcept
+	{
+		iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	bool SnapshotValue::iterator::operator==(const iterator& pOther) const noexcept
+	{
+		return mSnapshot == pOther.mSnapshot && mIndex == pOther.mIndex;
+	}
+}
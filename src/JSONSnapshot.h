@@ -0,0 +1,404 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "JSONError.h"
+#include "FileBuffer.h"
+
+namespace tng
+{
+	//
+	// binary snapshot of a parsed document: a flat tape of fixed-size nodes and a blob of decoded strings;
+	// a snapshot is written once (JSONSnapshot::build(), JSONParser::writeSnapshot()) and then mapped
+	// and queried in place, there is no deserialization step - opening costs O(1) and pages
+	// are faulted in by the queries which touch them;
+	//
+	// layout (integers in the byte order of the writer, a reader with another order rejects the file):
+	//
+	// offset					size				contents
+	// 0						48					SnapshotHeader
+	// mNodeOffset (48)			mNodeCount * 16		SnapshotNode[mNodeCount], preorder (a container is followed
+	//												by its subtree, no closing nodes), the root is node 0
+	// mStringOffset			mStringSize			strings: keys and string values, decoded (no quotes,
+	//												escapes resolved to UTF-8), not terminated; repeated keys
+	//												are stored once
+	//
+	// members of an object are pairs of nodes: a STRING node of the key and the subtree of the value;
+	// mStringOffset + mStringSize is the size of the file;
+	//
+
+	enum class SnapshotType : uint8_t
+	{
+		NULLTYPE = 0,
+		BOOL = 1,
+		INT = 2,
+		UINT = 3,
+		DOUBLE = 4,
+		STRING = 5,
+		ARRAY = 6,
+		OBJECT = 7
+	};
+
+	struct SnapshotHeader
+	{
+		static constexpr char MAGIC[8] = { 'T', 'N', 'G', 'S', 'N', 'A', 'P', '\0' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+		char mMagic[8]{};
+		uint32_t mVersion{};
+		uint32_t mByteOrder{};
+		uint64_t mNodeCount{};
+		uint64_t mNodeOffset{};
+		uint64_t mStringOffset{};
+		uint64_t mStringSize{};
+	};
+
+	//
+	// mSize:
+	// BOOL				- 1 for true, 0 for false;
+	// STRING			- length in bytes;
+	// ARRAY/OBJECT		- number of elements/members;
+	// mPayload:
+	// INT/UINT			- the value as int64_t/uint64_t;
+	// DOUBLE			- bits of the double;
+	// STRING			- offset of the string from mStringOffset;
+	// ARRAY/OBJECT		- index of the node after the subtree, thus a subtree is skipped in O(1);
+	//
+	// numbers are typed as JSONObject types them, but 64 bits wide:
+	// with '.', 'e' or 'E' - DOUBLE, negative - INT, other - UINT;
+	//
+	struct SnapshotNode
+	{
+		SnapshotType mType{ SnapshotType::NULLTYPE };
+		uint8_t mReserved[3]{};
+		uint32_t mSize{};
+		uint64_t mPayload{};
+	};
+
+	static_assert(sizeof(SnapshotHeader) == 48 && sizeof(SnapshotNode) == 16, "the snapshot layout is fixed");
+
+	class JSONSnapshot;
+
+	//
+	// handle to a value of a snapshot; cheap to copy, valid while the snapshot lives;
+	// a handle of a missing value is empty and every accessor on it returns std::nullopt
+	// (or an empty handle), thus lookups can be chained like JSONValueView:
+	// snapshot["a"]["b"][3].getInt();
+	// strings are views into the snapshot, nothing is allocated;
+	//
+	class SnapshotValue
+	{
+	public:
+		class iterator;
+	public:
+		SnapshotValue() = default;
+
+		bool exists() const noexcept;
+		explicit operator bool() const noexcept;
+
+		//
+		// returns NULLTYPE for an empty handle;
+		//
+		SnapshotType getType() const noexcept;
+
+		// ----------------------------------
+		bool isNull() const noexcept;
+		bool isBool() const noexcept;
+		bool isNumber() const noexcept;
+		bool isString() const noexcept;
+		bool isArray() const noexcept;
+		bool isObject() const noexcept;
+		// ----------------------------------
+
+		//
+		// non-throwing typed accessors; return std::nullopt if the handle is empty, holds another type
+		// or the value doesnt fit: getInt() and getUint() accept both INT and UINT, getDouble() - any number;
+		// ----------------------------------
+		std::optional<bool> getBool() const noexcept;
+		std::optional<int64_t> getInt() const noexcept;
+		std::optional<uint64_t> getUint() const noexcept;
+		std::optional<double> getDouble() const noexcept;
+		std::optional<std::string_view> getString() const noexcept;
+		// ----------------------------------
+
+		//
+		// the key of a member which was found by a key or reached by iterating over an object,
+		// empty otherwise;
+		//
+		std::string_view getKey() const noexcept;
+
+		//
+		// lookup by key (objects) and by index (arrays); both walk the members, skipping subtrees;
+		// among duplicate keys the last one is found, as in JSONObject;
+		// the index takes any integer type, a literal 0 included;
+		//
+		SnapshotValue operator[](std::string_view pKey) const noexcept;
+		SnapshotValue operator[](const char* pKey) const noexcept;
+		template<std::integral T>
+		SnapshotValue operator[](T pIndex) const noexcept;
+
+		bool contains(std::string_view pKey) const noexcept;
+
+		//
+		// number of elements or members, 0 for scalars;
+		//
+		size_t size() const noexcept;
+
+		//
+		// iterating over elements of an array or values of an object (with their keys);
+		// for other types the range is empty;
+		//
+		iterator begin() const noexcept;
+		iterator end() const noexcept;
+
+	public:
+		class iterator
+		{
+		public:
+			using value_type = SnapshotValue;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+
+			SnapshotValue operator*() const noexcept;
+			iterator& operator++() noexcept;
+			iterator operator++(int) noexcept;
+			bool operator==(const iterator& pOther) const noexcept;
+
+		private:
+			friend class SnapshotValue;
+
+			iterator(const JSONSnapshot* pSnapshot, uint64_t pIndex, uint64_t pEnd, bool pIsObject) noexcept;
+
+		private:
+			const JSONSnapshot* mSnapshot{};
+			// the key node for objects, the value node for arrays;
+			uint64_t mIndex{};
+			uint64_t mEnd{};
+			bool mIsObject{ false };
+		};
+
+	private:
+		friend class JSONSnapshot;
+
+		static constexpr uint64_t NO_KEY = ~uint64_t{};
+
+		SnapshotValue(const JSONSnapshot* pSnapshot, uint64_t pIndex, uint64_t pKey) noexcept;
+
+		const SnapshotNode* getNode() const noexcept;
+		SnapshotValue getElement(uint64_t pIndex) const noexcept;
+
+	private:
+		const JSONSnapshot* mSnapshot{};
+		uint64_t mIndex{};
+		uint64_t mKey{ NO_KEY };
+	};
+
+	//
+	// a snapshot opened from a file (mapped) or viewed in memory;
+	// the layout is checked when it is opened, node bounds - on every access,
+	// thus a damaged file gives empty handles and never reads out of the mapping;
+	// lookups dont modify the snapshot and are thread-safe;
+	//
+	// JSONParser parser;
+	// parser.writeSnapshot("state.snap", text);
+	// JSONSnapshot snapshot = parser.openSnapshot("state.snap");
+	// std::optional<int64_t> port = snapshot["server"]["port"].getInt();
+	//
+	class JSONSnapshot
+	{
+	public:
+		JSONSnapshot() = default;
+		JSONSnapshot(const JSONSnapshot&) = delete;
+		JSONSnapshot& operator=(const JSONSnapshot&) = delete;
+		JSONSnapshot(JSONSnapshot&& pOther) noexcept;
+		JSONSnapshot& operator=(JSONSnapshot&& pOther) noexcept;
+
+		//
+		// parses the text (JSONTape dialect) and appends its snapshot to pOutput;
+		// on error pOutput is left as it was and the position is an offset into pText;
+		//
+		static JSONStatus build(std::string_view pText, std::string& pOutput);
+
+		//
+		// maps the file; pages are not prefaulted and are advised for random access;
+		// a file which is not a snapshot gives INVALID_TEXT;
+		//
+		static JSONResult<JSONSnapshot> open(const std::filesystem::path& pPath);
+
+		//
+		// uses a snapshot in memory which must outlive the JSONSnapshot;
+		// pData must be aligned to 8 bytes (std::string and mappings are);
+		//
+		static JSONResult<JSONSnapshot> view(std::string_view pData);
+
+		SnapshotValue getRoot() const noexcept;
+		SnapshotValue operator[](std::string_view pKey) const noexcept;
+		SnapshotValue operator[](const char* pKey) const noexcept;
+
+		size_t getNodeCount() const noexcept;
+
+		//
+		// returns the whole snapshot;
+		//
+		std::string_view getData() const noexcept;
+
+		bool isMapped() const noexcept;
+
+	private:
+		friend class SnapshotValue;
+
+		//
+		// checks the header and points mNodes and mStrings into pData;
+		//
+		JSONStatus attach(std::string_view pData) noexcept;
+
+		const SnapshotNode* getNode(uint64_t pIndex) const noexcept;
+		std::string_view getString(const SnapshotNode& pNode) const noexcept;
+
+		//
+		// returns the index after the value at pIndex (skips the whole subtree);
+		//
+		uint64_t skip(uint64_t pIndex) const noexcept;
+
+	private:
+		FileBuffer mFile;
+		std::string_view mData;
+		const SnapshotNode* mNodes{};
+		uint64_t mNodeCount{};
+		std::string_view mStrings;
+	};
+
+	//
+	// SnapshotValue implementation
+	//
+
+	inline SnapshotValue::SnapshotValue(const JSONSnapshot* pSnapshot, uint64_t pIndex, uint64_t pKey) noexcept
+		: mSnapshot(pSnapshot)
+		, mIndex(pIndex)
+		, mKey(pKey)
+	{
+	}
+
+	inline const SnapshotNode* SnapshotValue::getNode() const noexcept
+	{
+		return mSnapshot != nullptr ? mSnapshot->getNode(mIndex) : nullptr;
+	}
+
+	inline bool SnapshotValue::exists() const noexcept
+	{
+		return getNode() != nullptr;
+	}
+
+	inline SnapshotValue::operator bool() const noexcept
+	{
+		return exists();
+	}
+
+	inline SnapshotType SnapshotValue::getType() const noexcept
+	{
+		const SnapshotNode* node = getNode();
+		return node != nullptr ? node->mType : SnapshotType::NULLTYPE;
+	}
+
+	inline bool SnapshotValue::isNull() const noexcept
+	{
+		return exists() && getType() == SnapshotType::NULLTYPE;
+	}
+
+	inline bool SnapshotValue::isBool() const noexcept
+	{
+		return getType() == SnapshotType::BOOL;
+	}
+
+	inline bool SnapshotValue::isNumber() const noexcept
+	{
+		SnapshotType type = getType();
+		return type == SnapshotType::INT || type == SnapshotType::UINT || type == SnapshotType::DOUBLE;
+	}
+
+	inline bool SnapshotValue::isString() const noexcept
+	{
+		return getType() == SnapshotType::STRING;
+	}
+
+	inline bool SnapshotValue::isArray() const noexcept
+	{
+		return getType() == SnapshotType::ARRAY;
+	}
+
+	inline bool SnapshotValue::isObject() const noexcept
+	{
+		return getType() == SnapshotType::OBJECT;
+	}
+
+	inline SnapshotValue SnapshotValue::operator[](const char* pKey) const noexcept
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+
+	template<std::integral T>
+	inline SnapshotValue SnapshotValue::operator[](T pIndex) const noexcept
+	{
+		// a negative index becomes huge and is out of range;
+		return getElement(static_cast<uint64_t>(pIndex));
+	}
+
+	inline bool SnapshotValue::contains(std::string_view pKey) const noexcept
+	{
+		return (*this)[pKey].exists();
+	}
+
+	inline size_t SnapshotValue::size() const noexcept
+	{
+		SnapshotType type = getType();
+		return type == SnapshotType::ARRAY || type == SnapshotType::OBJECT ? getNode()->mSize : 0;
+	}
+
+	//
+	// JSONSnapshot implementation
+	//
+
+	inline SnapshotValue JSONSnapshot::getRoot() const noexcept
+	{
+		return SnapshotValue(mNodeCount != 0 ? this : nullptr, 0, SnapshotValue::NO_KEY);
+	}
+
+	inline SnapshotValue JSONSnapshot::operator[](std::string_view pKey) const noexcept
+	{
+		return getRoot()[pKey];
+	}
+
+	inline SnapshotValue JSONSnapshot::operator[](const char* pKey) const noexcept
+	{
+		return getRoot()[std::string_view(pKey)];
+	}
+
+	inline size_t JSONSnapshot::getNodeCount() const noexcept
+	{
+		return static_cast<size_t>(mNodeCount);
+	}
+
+	inline std::string_view JSONSnapshot::getData() const noexcept
+	{
+		return mData;
+	}
+
+	inline bool JSONSnapshot::isMapped() const noexcept
+	{
+		return mFile.isMapped();
+	}
+
+	inline const SnapshotNode* JSONSnapshot::getNode(uint64_t pIndex) const noexcept
+	{
+		return pIndex < mNodeCount ? mNodes + pIndex : nullptr;
+	}
+}
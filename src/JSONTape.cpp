@@ -0,0 +1,450 @@
+#include "JSONTape.h"
+#include "RawScan.h"
+
+#include <limits>
+
+namespace tng
+{
+	namespace
+	{
+		//
+		// what the scanner accepts next;
+		//
+		enum class Expect : uint8_t
+		{
+			VALUE,
+			KEY,
+			COLON,
+			SEPARATOR,
+			END
+		};
+
+		struct Level
+		{
+			uint32_t mOpen{};
+			bool mIsObject{ false };
+		};
+
+		JSONError makeError(JSONErrorCode pCode, size_t pPosition) noexcept
+		{
+			return JSONError{ pCode, static_cast<uint32_t>(pPosition) };
+		}
+
+		int32_t hexValue(char pChar) noexcept
+		{
+			if (pChar >= '0' && pChar <= '9')
+				return pChar - '0';
+			if (pChar >= 'a' && pChar <= 'f')
+				return pChar - 'a' + 10;
+			if (pChar >= 'A' && pChar <= 'F')
+				return pChar - 'A' + 10;
+			return -1;
+		}
+
+		//
+		// reads 4 hex digits at pText[pPosition], returns -1 if they are invalid;
+		//
+		int32_t readCodeUnit(std::string_view pText, size_t pPosition) noexcept
+		{
+			if (pPosition + 4 > pText.size())
+				return -1;
+			int32_t value{};
+			for (size_t i = 0; i < 4; ++i)
+			{
+				int32_t digit = hexValue(pText[pPosition + i]);
+				if (digit < 0)
+					return -1;
+				value = value * 16 + digit;
+			}
+			return value;
+		}
+
+		void appendUtf8(std::string& pOutput, uint32_t pCodePoint)
+		{
+			if (pCodePoint < 0x80)
+				pOutput.push_back(static_cast<char>(pCodePoint));
+			else if (pCodePoint < 0x800)
+			{
+				pOutput.push_back(static_cast<char>(0xC0 | (pCodePoint >> 6)));
+				pOutput.push_back(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+			}
+			else if (pCodePoint < 0x10000)
+			{
+				pOutput.push_back(static_cast<char>(0xE0 | (pCodePoint >> 12)));
+				pOutput.push_back(static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3F)));
+				pOutput.push_back(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+			}
+			else
+			{
+				pOutput.push_back(static_cast<char>(0xF0 | (pCodePoint >> 18)));
+				pOutput.push_back(static_cast<char>(0x80 | ((pCodePoint >> 12) & 0x3F)));
+				pOutput.push_back(static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3F)));
+				pOutput.push_back(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+			}
+		}
+
+		//
+		// one open container while the tape is converted into JSONValue;
+		//
+		struct Frame
+		{
+			bool mIsObject{ false };
+			bool mHasKey{ false };
+			std::string mKey;
+			JSONObject mObject;
+			std::vector<JSONValue> mArray;
+		};
+	}
+
+	JSONStatus JSONTape::build(std::string_view pText)
+	{
+		mText = pText;
+		mEntries.clear();
+		if (pText.size() >= std::numeric_limits<uint32_t>::max())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, 0));
+
+		std::vector<Level> levels;
+		Expect expect = Expect::VALUE;
+		// right after an open bracket the container may be closed at once;
+		bool mayClose = false;
+
+		auto acceptsValue = [&]()
+			{
+				return expect == Expect::VALUE || (expect == Expect::SEPARATOR && !levels.back().mIsObject);
+			};
+		auto acceptsKey = [&]()
+			{
+				return expect == Expect::KEY || (expect == Expect::SEPARATOR && levels.back().mIsObject);
+			};
+		auto afterValue = [&]()
+			{
+				expect = levels.empty() ? Expect::END : Expect::SEPARATOR;
+				mayClose = false;
+			};
+		auto addEntry = [&](TokenType pType, size_t pBegin, size_t pEnd)
+			{
+				uint32_t index = static_cast<uint32_t>(mEntries.size());
+				mEntries.push_back({ pType, static_cast<uint32_t>(pBegin), static_cast<uint32_t>(pEnd - pBegin), index + 1 });
+			};
+
+		size_t i = 0;
+		while (i < pText.size())
+		{
+			char c = pText[i];
+			switch (c)
+			{
+			case ' ': case '\t': case '\r': case '\n':
+				++i;
+				continue;
+
+			case '{':
+			case '[':
+			{
+				if (!acceptsValue())
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+				bool isObject = c == '{';
+				levels.push_back({ static_cast<uint32_t>(mEntries.size()), isObject });
+				addEntry(isObject ? TokenType::LBRACE : TokenType::LBRACKET, i, i + 1);
+				expect = isObject ? Expect::KEY : Expect::VALUE;
+				mayClose = true;
+				++i;
+				continue;
+			}
+
+			case '}':
+			case ']':
+			{
+				bool isObject = c == '}';
+				Expect emptyState = isObject ? Expect::KEY : Expect::VALUE;
+				if (levels.empty() || levels.back().mIsObject != isObject ||
+					!(expect == Expect::SEPARATOR || (expect == emptyState && mayClose)))
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+				uint32_t open = levels.back().mOpen;
+				levels.pop_back();
+				addEntry(isObject ? TokenType::RBRACE : TokenType::RBRACKET, i, i + 1);
+				mEntries[open].mMatch = static_cast<uint32_t>(mEntries.size() - 1);
+				mEntries.back().mMatch = open;
+				afterValue();
+				++i;
+				continue;
+			}
+
+			case ',':
+				if (expect != Expect::SEPARATOR)
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+				expect = levels.back().mIsObject ? Expect::KEY : Expect::VALUE;
+				mayClose = false;
+				++i;
+				continue;
+
+			case ':':
+				if (expect != Expect::COLON)
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+				expect = Expect::VALUE;
+				++i;
+				continue;
+
+			default:
+				break;
+			}
+
+			// a scalar: quoted string or bare word;
+			size_t end{};
+			if (c == '"')
+			{
+				end = simd::skipString(pText, i);
+				if (end == std::string_view::npos)
+					return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, i));
+			}
+			else
+			{
+				end = i + 1;
+				while (end < pText.size() && !raw::isDelimiter(pText[end]))
+					++end;
+			}
+
+			if (acceptsKey())
+			{
+				addEntry(TokenType::STRING, i, end);
+				expect = Expect::COLON;
+				mayClose = false;
+			}
+			else if (acceptsValue())
+			{
+				TokenType type = TokenType::STRING;
+				if (c != '"')
+				{
+					std::string_view word = pText.substr(i, end - i);
+					if (word == "true" || word == "false" || word == "null")
+						type = TokenType::KEYWORD;
+					else if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.')
+						type = TokenType::NUMBER;
+				}
+				addEntry(type, i, end);
+				afterValue();
+			}
+			else
+				return std::unexpected(makeError(expect == Expect::COLON ? JSONErrorCode::MISSING_KEY
+																		 : JSONErrorCode::INVALID_TEXT, i));
+			i = end;
+		}
+
+		if (!levels.empty() || expect != Expect::END)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, pText.size()));
+		return {};
+	}
+
+	JSONResult<JSONTape> JSONTape::create(std::string_view pText)
+	{
+		JSONTape tape;
+		if (JSONStatus status = tape.build(pText); !status)
+			return std::unexpected(status.error());
+		return tape;
+	}
+
+	JSONResult<JSONValue> JSONTape::toValue(size_t pIndex) const
+	{
+		JSONValue value;
+		if (JSONStatus status = materialize(pIndex, value, nullptr); !status)
+			return std::unexpected(status.error());
+		return value;
+	}
+
+	JSONResult<JSONObject> JSONTape::toObject(size_t pIndex) const
+	{
+		if (pIndex >= mEntries.size() || mEntries[pIndex].mType != TokenType::LBRACE)
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, pIndex < mEntries.size() ? mEntries[pIndex].mOffset : 0));
+		JSONValue value;
+		JSONObject object;
+		if (JSONStatus status = materialize(pIndex, value, &object); !status)
+			return std::unexpected(status.error());
+		return object;
+	}
+
+	JSONStatus JSONTape::materialize(size_t pIndex, JSONValue& pValue, JSONObject* pRootObject) const
+	{
+		if (pIndex >= mEntries.size())
+			return std::unexpected(makeError(JSONErrorCode::INVALID_TEXT, mText.size()));
+
+		std::vector<Frame> frames;
+		size_t end = skip(pIndex);
+		for (size_t i = pIndex; i < end; ++i)
+		{
+			const Entry& entry = mEntries[i];
+			JSONValue value;
+			switch (entry.mType)
+			{
+			case TokenType::LBRACE:
+			case TokenType::LBRACKET:
+				frames.emplace_back().mIsObject = entry.mType == TokenType::LBRACE;
+				continue;
+
+			case TokenType::RBRACE:
+			case TokenType::RBRACKET:
+			{
+				Frame& frame = frames.back();
+				if (frames.size() == 1 && pRootObject != nullptr)
+				{
+					*pRootObject = std::move(frame.mObject);
+					return {};
+				}
+				value = frame.mIsObject ? JSONValue(std::move(frame.mObject)) : JSONValue(std::move(frame.mArray));
+				frames.pop_back();
+				break;
+			}
+
+			default:
+				if (!frames.empty() && frames.back().mIsObject && !frames.back().mHasKey)
+				{
+					JSONResult<std::string> key = decodeString(getRaw(i));
+					if (!key)
+						return std::unexpected(makeError(key.error().mCode, entry.mOffset));
+					frames.back().mKey = std::move(*key);
+					frames.back().mHasKey = true;
+					continue;
+				}
+				else
+				{
+					JSONResult<JSONValue> scalar = decodeScalar(i);
+					if (!scalar)
+						return std::unexpected(scalar.error());
+					value = std::move(*scalar);
+				}
+				break;
+			}
+
+			if (frames.empty())
+				pValue = std::move(value);
+			else if (frames.back().mIsObject)
+			{
+				frames.back().mObject.addObject(frames.back().mKey, std::move(value));
+				frames.back().mHasKey = false;
+			}
+			else
+				frames.back().mArray.push_back(std::move(value));
+		}
+		return {};
+	}
+
+	JSONResult<std::string> JSONTape::decodeString(std::string_view pRaw)
+	{
+		if (pRaw.size() >= 2 && pRaw.front() == '"')
+			pRaw = pRaw.substr(1, pRaw.size() - 2);
+		size_t slash = pRaw.find('\\');
+		if (slash == std::string_view::npos)
+			return std::string(pRaw);
+
+		std::string output;
+		output.reserve(pRaw.size());
+		size_t begin{};
+		while (slash != std::string_view::npos)
+		{
+			output.append(pRaw, begin, slash - begin);
+			if (slash + 1 >= pRaw.size())
+				return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER, slash));
+			char escaped = pRaw[slash + 1];
+			begin = slash + 2;
+			switch (escaped)
+			{
+			case '"':  output.push_back('"'); break;
+			case '\\': output.push_back('\\'); break;
+			case '/':  output.push_back('/'); break;
+			case 'b':  output.push_back('\b'); break;
+			case 'f':  output.push_back('\f'); break;
+			case 'n':  output.push_back('\n'); break;
+			case 'r':  output.push_back('\r'); break;
+			case 't':  output.push_back('\t'); break;
+			case 'u':
+			{
+				int32_t unit = readCodeUnit(pRaw, slash + 2);
+				if (unit < 0)
+					return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER, slash));
+				uint32_t codePoint = static_cast<uint32_t>(unit);
+				begin = slash + 6;
+				// a surrogate pair is written as two escapes, a lone half has no UTF-8 encoding;
+				if (unit >= 0xD800 && unit <= 0xDBFF)
+				{
+					int32_t low = pRaw.substr(begin, 2) == "\\u" ? readCodeUnit(pRaw, begin + 2) : -1;
+					if (low < 0xDC00 || low > 0xDFFF)
+						return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER, slash));
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + static_cast<uint32_t>(low - 0xDC00);
+					begin += 6;
+				}
+				else if (unit >= 0xDC00 && unit <= 0xDFFF)
+					return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER, slash));
+				appendUtf8(output, codePoint);
+				break;
+			}
+			default:
+				return std::unexpected(makeError(JSONErrorCode::INVALID_CHARACTER, slash));
+			}
+			slash = pRaw.find('\\', begin);
+		}
+		output.append(pRaw, begin);
+		return output;
+	}
+
+	JSONResult<JSONValue> JSONTape::decodeNumber(std::string_view pRaw) noexcept
+	{
+		if (!pRaw.empty() && pRaw.front() == '+')
+			pRaw.remove_prefix(1);
+
+		const char* begin = pRaw.data();
+		const char* end = pRaw.data() + pRaw.size();
+		std::from_chars_result result{};
+		JSONValue value;
+		if (pRaw.find_first_of(".eE") != std::string_view::npos)
+		{
+			float number{};
+			result = std::from_chars(begin, end, number);
+			value = JSONValue(number);
+		}
+		else if (!pRaw.empty() && pRaw.front() == '-')
+		{
+			int32_t number{};
+			result = std::from_chars(begin, end, number);
+			value = JSONValue(number);
+		}
+		else
+		{
+			uint32_t number{};
+			result = std::from_chars(begin, end, number);
+			value = JSONValue(number);
+		}
+
+		if (result.ec == std::errc::result_out_of_range)
+			return std::unexpected(makeError(JSONErrorCode::NUMBER_OUT_OF_RANGE, 0));
+		if (result.ec != std::errc() || result.ptr != end)
+			return std::unexpected(makeError(JSONErrorCode::INVALID_NUMBER, 0));
+		return value;
+	}
+
+	JSONResult<JSONValue> JSONTape::decodeScalar(size_t pIndex) const
+	{
+		const Entry& entry = mEntries[pIndex];
+		std::string_view raw = getRaw(pIndex);
+		switch (entry.mType)
+		{
+		case TokenType::STRING:
+		{
+			JSONResult<std::string> string = decodeString(raw);
+			if (!string)
+				return std::unexpected(makeError(string.error().mCode, entry.mOffset + string.error().mPosition));
+			return JSONValue(std::move(*string));
+		}
+		case TokenType::NUMBER:
+		{
+			JSONResult<JSONValue> number = decodeNumber(raw);
+			if (!number)
+				return std::unexpected(makeError(number.error().mCode, entry.mOffset));
+			return number;
+		}
+		case TokenType::KEYWORD:
+			if (raw == "null")
+				return JSONValue(nullptr);
+			return JSONValue(raw == "true");
+		default:
+			return std::unexpected(makeError(JSONErrorCode::TYPE_MISMATCH, entry.mOffset));
+		}
+	}
+}
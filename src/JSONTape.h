@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// structural index of a document: one entry per token with its place in the text;
+	// brackets know the index of their pair, thus a whole subtree is skipped in O(1)
+	// and nothing is decoded or allocated until it is asked for;
+	// the tape doesnt own the text, the text must outlive it;
+	//
+	// accepted text is JSON and the dialect of JSONLexer: keys and string values may be unquoted
+	// (a bare word ends at a space or at one of ,:{}[]"), commas between members are optional;
+	//
+	class JSONTape
+	{
+	public:
+		using TokenType = JSONLexer::TokenType;
+
+		//
+		// mType is one of LBRACE, RBRACE, LBRACKET, RBRACKET, STRING, NUMBER and KEYWORD;
+		// mMatch of a bracket is the index of its pair, of a scalar - its own index + 1;
+		// quoted strings include their quotes in [mOffset, mOffset + mLength);
+		//
+		struct Entry
+		{
+			TokenType mType{ TokenType::LBRACE };
+			uint32_t mOffset{};
+			uint32_t mLength{};
+			uint32_t mMatch{};
+		};
+
+	public:
+		JSONTape() = default;
+
+		//
+		// scans the text and builds the tape; entries are reused between calls;
+		//
+		JSONStatus build(std::string_view pText);
+
+		//
+		// returns a tape of the text or the first error with its position;
+		//
+		static JSONResult<JSONTape> create(std::string_view pText);
+
+		std::string_view getText() const noexcept;
+		std::span<const Entry> getEntries() const noexcept;
+		const Entry& operator[](size_t pIndex) const noexcept;
+		size_t size() const noexcept;
+
+		//
+		// returns the index after the value at pIndex (skips the whole subtree);
+		//
+		size_t skip(size_t pIndex) const noexcept;
+
+		//
+		// returns the text of the value at pIndex, for brackets - of the whole subtree;
+		//
+		std::string_view getRaw(size_t pIndex) const noexcept;
+
+		bool isContainer(size_t pIndex) const noexcept;
+
+		//
+		// converts the value at pIndex (of the whole subtree) into JSONValue/JSONObject;
+		// nesting depth is limited only by memory;
+		//
+		JSONResult<JSONValue> toValue(size_t pIndex = 0) const;
+		JSONResult<JSONObject> toObject(size_t pIndex = 0) const;
+
+		//
+		// decodes a string token: removes quotes and resolves escapes, \uXXXX becomes UTF-8;
+		//
+		static JSONResult<std::string> decodeString(std::string_view pRaw);
+
+		//
+		// converts a number token the same way as JSONObject does:
+		// negative integers - int32, other integers - uint32, with '.', 'e' or 'E' - float;
+		//
+		static JSONResult<JSONValue> decodeNumber(std::string_view pRaw) noexcept;
+
+		//
+		// converts a scalar entry (STRING, NUMBER or KEYWORD);
+		//
+		JSONResult<JSONValue> decodeScalar(size_t pIndex) const;
+
+	private:
+		//
+		// builds the value at pIndex into pValue; if pRootObject is set and the value is an object,
+		// the object is moved there instead, without wrapping it into a shared JSONValue;
+		//
+		JSONStatus materialize(size_t pIndex, JSONValue& pValue, JSONObject* pRootObject) const;
+
+	private:
+		friend class IncrementalDocument;
+
+		std::string_view mText;
+		std::vector<Entry> mEntries;
+	};
+
+	//
+	// JSONTape implementation
+	//
+
+	inline std::string_view JSONTape::getText() const noexcept
+	{
+		return mText;
+	}
+
+	inline std::span<const JSONTape::Entry> JSONTape::getEntries() const noexcept
+	{
+		return mEntries;
+	}
+
+	inline const JSONTape::Entry& JSONTape::operator[](size_t pIndex) const noexcept
+	{
+		return mEntries[pIndex];
+	}
+
+	inline size_t JSONTape::size() const noexcept
+	{
+		return mEntries.size();
+	}
+
+	inline bool JSONTape::isContainer(size_t pIndex) const noexcept
+	{
+		TokenType type = mEntries[pIndex].mType;
+		return type == TokenType::LBRACE || type == TokenType::LBRACKET;
+	}
+
+	inline size_t JSONTape::skip(size_t pIndex) const noexcept
+	{
+		return isContainer(pIndex) ? mEntries[pIndex].mMatch + 1 : pIndex + 1;
+	}
+
+	inline std::string_view JSONTape::getRaw(size_t pIndex) const noexcept
+	{
+		const Entry& entry = mEntries[pIndex];
+		if (!isContainer(pIndex))
+			return mText.substr(entry.mOffset, entry.mLength);
+		const Entry& close = mEntries[entry.mMatch];
+		return mText.substr(entry.mOffset, close.mOffset + close.mLength - entry.mOffset);
+	}
+}
@@ -0,0 +1,507 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	class JSONObjectView;
+
+	//
+	// non-owning, read-only handle to a JSONValue;
+	// never copies the underlying data and never throws;
+	// a view over a missing value is empty and every accessor on it
+	// returns std::nullopt (or an empty view), thus lookups can be chained:
+	// view["a"]["b"][3].getInt();
+	// the viewed value must outlive the view;
+	//
+	class JSONValueView
+	{
+	public:
+		class iterator;
+	public:
+		JSONValueView() = default;
+		JSONValueView(const JSONValue& pValue) noexcept;
+		explicit JSONValueView(const JSONValue* pValue) noexcept;
+
+		//
+		// a row of a nested array, which is not a JSONValue on its own;
+		//
+		explicit JSONValueView(const std::vector<JSONValue>& pRow) noexcept;
+
+		//
+		// returns false - if the view doesnt point at any value;
+		//
+		bool exists() const noexcept;
+		explicit operator bool() const noexcept;
+
+		//
+		// checkers if the viewed value is an exact type;
+		// all of them return false on an empty view;
+		// ----------------------------------
+		bool isBool() const noexcept;
+		bool isInt() const noexcept;
+		bool isUint() const noexcept;
+		bool isFloat() const noexcept;
+		bool isNumber() const noexcept;
+		bool isString() const noexcept;
+		bool isNull() const noexcept;
+		bool isArray() const noexcept;
+		bool isObject() const noexcept;
+		// ----------------------------------
+
+		//
+		// non-throwing typed accessors;
+		// return std::nullopt if the view is empty or holds another type;
+		// getInt() accepts both signed and unsigned numbers,
+		// getFloat() accepts any number;
+		// ----------------------------------
+		std::optional<bool> getBool() const noexcept;
+		std::optional<int64_t> getInt() const noexcept;
+		std::optional<uint32_t> getUint() const noexcept;
+		std::optional<float> getFloat() const noexcept;
+		std::optional<std::string_view> getString() const noexcept;
+		// ----------------------------------
+
+		//
+		// returns the contained value or pDefault;
+		// JSONValueView view = object["port"];
+		// int32_t port = view.getOr<int32_t>(8080);
+		//
+		template<typename T>
+			requires ProperValue<T>
+		T getOr(T pDefault) const noexcept;
+
+		//
+		// lookup by key (objects) and by index (arrays and nested arrays);
+		// returns an empty view if there is no such element;
+		// the index is a template, thus a literal 0 is not ambiguous with const char*;
+		//
+		JSONValueView operator[](std::string_view pKey) const noexcept;
+		JSONValueView operator[](const char* pKey) const noexcept;
+		template<std::integral T>
+		JSONValueView operator[](T pIndex) const noexcept;
+
+		//
+		// returns a view of the nested object (empty if it is not an object);
+		//
+		JSONObjectView getObject() const noexcept;
+
+		//
+		// number of elements for arrays and objects, 0 otherwise;
+		//
+		size_t size() const noexcept;
+
+		//
+		// iterating over elements of an array;
+		// for other types the range is empty;
+		//
+		iterator begin() const noexcept;
+		iterator end() const noexcept;
+
+		//
+		// returns the viewed value (nullptr for empty views and rows);
+		//
+		const JSONValue* get() const noexcept;
+
+	public:
+		class iterator
+		{
+		public:
+			using value_type = JSONValueView;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+			iterator(const JSONValue* pElement, const std::vector<JSONValue>* pRow) noexcept
+				: mElement(pElement), mRow(pRow) {}
+
+			JSONValueView operator*() const noexcept
+			{
+				return mRow != nullptr ? JSONValueView(*mRow) : JSONValueView(mElement);
+			}
+			iterator& operator++() noexcept
+			{
+				if (mRow != nullptr)
+					++mRow;
+				else
+					++mElement;
+				return *this;
+			}
+			iterator operator++(int) noexcept
+			{
+				iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+			bool operator==(const iterator&) const noexcept = default;
+
+		private:
+			const JSONValue* mElement{ nullptr };
+			const std::vector<JSONValue>* mRow{ nullptr };
+		};
+
+	private:
+		//
+		// returns the viewed array storage (plain array or a row), otherwise nullptr;
+		//
+		const std::vector<JSONValue>* arrayStorage() const noexcept;
+
+	private:
+		const JSONValue* mValue{ nullptr };
+		const std::vector<JSONValue>* mRow{ nullptr };
+	};
+
+	//
+	// non-owning, read-only handle to a JSONObject;
+	// iteration yields (key, JSONValueView) pairs without copying;
+	//
+	class JSONObjectView
+	{
+	public:
+		class iterator;
+	public:
+		JSONObjectView() = default;
+		JSONObjectView(const JSONObject& pObject) noexcept;
+		explicit JSONObjectView(const JSONObject* pObject) noexcept;
+
+		bool exists() const noexcept;
+		explicit operator bool() const noexcept;
+
+		//
+		// lookup by key; returns an empty view if there is no such key;
+		//
+		JSONValueView operator[](std::string_view pKey) const noexcept;
+		JSONValueView operator[](const char* pKey) const noexcept;
+
+		bool contains(std::string_view pKey) const noexcept;
+		size_t size() const noexcept;
+
+		iterator begin() const noexcept;
+		iterator end() const noexcept;
+
+		const JSONObject* get() const noexcept;
+
+	public:
+		class iterator
+		{
+		public:
+			using value_type = std::pair<std::string_view, JSONValueView>;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+			explicit iterator(JSONObject::Storage::const_iterator pIterator) noexcept
+				: mIterator(pIterator) {}
+
+			value_type operator*() const noexcept
+			{
+				return { std::string_view(mIterator->first), JSONValueView(mIterator->second) };
+			}
+			iterator& operator++() noexcept
+			{
+				++mIterator;
+				return *this;
+			}
+			iterator operator++(int) noexcept
+			{
+				iterator tmp = *this;
+				++mIterator;
+				return tmp;
+			}
+			bool operator==(const iterator&) const noexcept = default;
+
+		private:
+			JSONObject::Storage::const_iterator mIterator{};
+		};
+
+	private:
+		const JSONObject* mObject{ nullptr };
+	};
+
+	//
+	// JSONValueView implementation
+	//
+
+	inline JSONValueView::JSONValueView(const JSONValue& pValue) noexcept
+		: mValue(&pValue) {}
+
+	inline JSONValueView::JSONValueView(const JSONValue* pValue) noexcept
+		: mValue(pValue) {}
+
+	inline JSONValueView::JSONValueView(const std::vector<JSONValue>& pRow) noexcept
+		: mRow(&pRow) {}
+
+	inline bool JSONValueView::exists() const noexcept
+	{
+		return mValue != nullptr || mRow != nullptr;
+	}
+
+	inline JSONValueView::operator bool() const noexcept
+	{
+		return exists();
+	}
+
+	inline bool JSONValueView::isBool() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsBool();
+	}
+
+	inline bool JSONValueView::isInt() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsInt();
+	}
+
+	inline bool JSONValueView::isUint() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsUint();
+	}
+
+	inline bool JSONValueView::isFloat() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsFloat();
+	}
+
+	inline bool JSONValueView::isNumber() const noexcept
+	{
+		return isInt() || isUint() || isFloat();
+	}
+
+	inline bool JSONValueView::isString() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsString();
+	}
+
+	inline bool JSONValueView::isNull() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsNull();
+	}
+
+	inline bool JSONValueView::isArray() const noexcept
+	{
+		return mRow != nullptr ||
+			   (mValue != nullptr && (mValue->valueIsArray() || mValue->valueIsNestedArray()));
+	}
+
+	inline bool JSONValueView::isObject() const noexcept
+	{
+		return mValue != nullptr && mValue->valueIsObject();
+	}
+
+	inline std::optional<bool> JSONValueView::getBool() const noexcept
+	{
+		if (const bool* value = mValue != nullptr ? std::get_if<bool>(&mValue->mValue) : nullptr)
+			return *value;
+		return std::nullopt;
+	}
+
+	inline std::optional<int64_t> JSONValueView::getInt() const noexcept
+	{
+		if (mValue == nullptr)
+			return std::nullopt;
+		if (const int32_t* value = std::get_if<int32_t>(&mValue->mValue))
+			return *value;
+		if (const uint32_t* value = std::get_if<uint32_t>(&mValue->mValue))
+			return *value;
+		return std::nullopt;
+	}
+
+	inline std::optional<uint32_t> JSONValueView::getUint() const noexcept
+	{
+		if (const uint32_t* value = mValue != nullptr ? std::get_if<uint32_t>(&mValue->mValue) : nullptr)
+			return *value;
+		return std::nullopt;
+	}
+
+	inline std::optional<float> JSONValueView::getFloat() const noexcept
+	{
+		if (mValue == nullptr)
+			return std::nullopt;
+		if (const float* value = std::get_if<float>(&mValue->mValue))
+			return *value;
+		if (std::optional<int64_t> value = getInt())
+			return static_cast<float>(*value);
+		return std::nullopt;
+	}
+
+	inline std::optional<std::string_view> JSONValueView::getString() const noexcept
+	{
+		if (const std::string* value = mValue != nullptr ? std::get_if<std::string>(&mValue->mValue) : nullptr)
+			return std::string_view(*value);
+		return std::nullopt;
+	}
+
+	template<typename T>
+		requires ProperValue<T>
+	inline T JSONValueView::getOr(T pDefault) const noexcept
+	{
+		if constexpr (isKeyword<T>)
+			return getBool().value_or(pDefault);
+		else if constexpr (isIntNumber<T>)
+		{
+			std::optional<int64_t> value = getInt();
+			return value.has_value() ? static_cast<T>(*value) : pDefault;
+		}
+		else if constexpr (isFloatNumber<T>)
+		{
+			std::optional<float> value = getFloat();
+			return value.has_value() ? static_cast<T>(*value) : pDefault;
+		}
+		else if constexpr (std::is_same_v<std::string_view, T>)
+			return getString().value_or(pDefault);
+		else if constexpr (std::is_same_v<std::string, T>)
+		{
+			std::optional<std::string_view> value = getString();
+			return value.has_value() ? std::string(*value) : pDefault;
+		}
+		else
+			return pDefault;
+	}
+
+	inline JSONValueView JSONValueView::operator[](std::string_view pKey) const noexcept
+	{
+		if (!isObject())
+			return {};
+		return JSONValueView(std::get<std::shared_ptr<const JSONObject>>(mValue->mValue)->findValue(pKey));
+	}
+
+	inline JSONValueView JSONValueView::operator[](const char* pKey) const noexcept
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+
+	template<std::integral T>
+	inline JSONValueView JSONValueView::operator[](T pIndex) const noexcept
+	{
+		// a negative index becomes huge and is out of range;
+		size_t index = static_cast<size_t>(pIndex);
+		if (const std::vector<JSONValue>* array = arrayStorage())
+			return index < array->size() ? JSONValueView((*array)[index]) : JSONValueView();
+		if (mValue != nullptr)
+		{
+			if (const auto* nested = std::get_if<std::vector<std::vector<JSONValue>>>(&mValue->mValue))
+				return index < nested->size() ? JSONValueView((*nested)[index]) : JSONValueView();
+		}
+		return {};
+	}
+
+	inline JSONObjectView JSONValueView::getObject() const noexcept
+	{
+		if (!isObject())
+			return {};
+		return JSONObjectView(std::get<std::shared_ptr<const JSONObject>>(mValue->mValue).get());
+	}
+
+	inline size_t JSONValueView::size() const noexcept
+	{
+		if (const std::vector<JSONValue>* array = arrayStorage())
+			return array->size();
+		if (mValue == nullptr)
+			return 0;
+		if (const auto* nested = std::get_if<std::vector<std::vector<JSONValue>>>(&mValue->mValue))
+			return nested->size();
+		if (isObject())
+			return getObject().size();
+		return 0;
+	}
+
+	inline JSONValueView::iterator JSONValueView::begin() const noexcept
+	{
+		if (const std::vector<JSONValue>* array = arrayStorage())
+			return iterator(array->data(), nullptr);
+		if (mValue != nullptr)
+		{
+			if (const auto* nested = std::get_if<std::vector<std::vector<JSONValue>>>(&mValue->mValue))
+				return iterator(nullptr, nested->data());
+		}
+		return {};
+	}
+
+	inline JSONValueView::iterator JSONValueView::end() const noexcept
+	{
+		if (const std::vector<JSONValue>* array = arrayStorage())
+			return iterator(array->data() + array->size(), nullptr);
+		if (mValue != nullptr)
+		{
+			if (const auto* nested = std::get_if<std::vector<std::vector<JSONValue>>>(&mValue->mValue))
+				return iterator(nullptr, nested->data() + nested->size());
+		}
+		return {};
+	}
+
+	inline const JSONValue* JSONValueView::get() const noexcept
+	{
+		return mValue;
+	}
+
+	inline const std::vector<JSONValue>* JSONValueView::arrayStorage() const noexcept
+	{
+		if (mRow != nullptr)
+			return mRow;
+		if (mValue != nullptr)
+			return std::get_if<std::vector<JSONValue>>(&mValue->mValue);
+		return nullptr;
+	}
+
+	//
+	// JSONObjectView implementation
+	//
+
+	inline JSONObjectView::JSONObjectView(const JSONObject& pObject) noexcept
+		: mObject(&pObject) {}
+
+	inline JSONObjectView::JSONObjectView(const JSONObject* pObject) noexcept
+		: mObject(pObject) {}
+
+	inline bool JSONObjectView::exists() const noexcept
+	{
+		return mObject != nullptr;
+	}
+
+	inline JSONObjectView::operator bool() const noexcept
+	{
+		return exists();
+	}
+
+	inline JSONValueView JSONObjectView::operator[](std::string_view pKey) const noexcept
+	{
+		if (mObject == nullptr)
+			return {};
+		return JSONValueView(mObject->findValue(pKey));
+	}
+
+	inline JSONValueView JSONObjectView::operator[](const char* pKey) const noexcept
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+
+	inline bool JSONObjectView::contains(std::string_view pKey) const noexcept
+	{
+		return mObject != nullptr && mObject->contains(pKey);
+	}
+
+	inline size_t JSONObjectView::size() const noexcept
+	{
+		return mObject != nullptr ? mObject->getSize() : 0;
+	}
+
+	inline JSONObjectView::iterator JSONObjectView::begin() const noexcept
+	{
+		return mObject != nullptr ? iterator(mObject->getStorage().begin()) : iterator();
+	}
+
+	inline JSONObjectView::iterator JSONObjectView::end() const noexcept
+	{
+		return mObject != nullptr ? iterator(mObject->getStorage().end()) : iterator();
+	}
+
+	inline const JSONObject* JSONObjectView::get() const noexcept
+	{
+		return mObject;
+	}
+}
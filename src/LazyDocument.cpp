@@ -0,0 +1,175 @@
+#include "LazyDocument.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tng
+{
+	//
+	// everything behind a document; it doesnt move when the document is moved, thus handles stay valid;
+	// nodes of unordered_map dont move on rehash, thus references into the caches stay valid too;
+	//
+	struct LazyValue::State
+	{
+		using Members = std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>;
+
+		std::string mText;
+		JSONTape mTape;
+
+		std::mutex mMutex;
+		// entry of an object -> its keys with entries of their values;
+		std::unordered_map<uint32_t, Members> mObjects;
+		// entry of an array -> entries of its elements;
+		std::unordered_map<uint32_t, std::vector<uint32_t>> mArrays;
+		// entry -> decoded value;
+		std::unordered_map<uint32_t, JSONValue> mValues;
+
+		//
+		// must be called under mMutex;
+		//
+		const Members& getMembers(uint32_t pIndex)
+		{
+			auto [it, inserted] = mObjects.try_emplace(pIndex);
+			if (inserted)
+			{
+				size_t close = mTape[pIndex].mMatch;
+				for (size_t key = pIndex + 1; key < close; key = mTape.skip(key + 1))
+				{
+					JSONResult<std::string> name = JSONTape::decodeString(mTape.getRaw(key));
+					if (name)
+						it->second.insert_or_assign(std::move(*name), static_cast<uint32_t>(key + 1));
+				}
+			}
+			return it->second;
+		}
+
+		//
+		// must be called under mMutex;
+		//
+		const std::vector<uint32_t>& getElements(uint32_t pIndex)
+		{
+			auto [it, inserted] = mArrays.try_emplace(pIndex);
+			if (inserted)
+			{
+				size_t close = mTape[pIndex].mMatch;
+				for (size_t element = pIndex + 1; element < close; element = mTape.skip(element))
+					it->second.push_back(static_cast<uint32_t>(element));
+			}
+			return it->second;
+		}
+	};
+
+	bool LazyValue::isObject() const noexcept
+	{
+		return mState != nullptr && mState->mTape[mIndex].mType == JSONTape::TokenType::LBRACE;
+	}
+
+	bool LazyValue::isArray() const noexcept
+	{
+		return mState != nullptr && mState->mTape[mIndex].mType == JSONTape::TokenType::LBRACKET;
+	}
+
+	LazyValue LazyValue::operator[](std::string_view pKey) const
+	{
+		if (!isObject())
+			return {};
+		std::scoped_lock lock(mState->mMutex);
+		const State::Members& members = mState->getMembers(mIndex);
+		auto it = members.find(pKey);
+		return it == members.end() ? LazyValue() : LazyValue(mState, it->second);
+	}
+
+	LazyValue LazyValue::getElement(size_t pIndex) const
+	{
+		if (!isArray())
+			return {};
+		std::scoped_lock lock(mState->mMutex);
+		const std::vector<uint32_t>& elements = mState->getElements(mIndex);
+		return pIndex < elements.size() ? LazyValue(mState, elements[pIndex]) : LazyValue();
+	}
+
+	bool LazyValue::contains(std::string_view pKey) const
+	{
+		return (*this)[pKey].exists();
+	}
+
+	size_t LazyValue::size() const
+	{
+		if (isObject())
+		{
+			std::scoped_lock lock(mState->mMutex);
+			return mState->getMembers(mIndex).size();
+		}
+		if (isArray())
+		{
+			std::scoped_lock lock(mState->mMutex);
+			return mState->getElements(mIndex).size();
+		}
+		return 0;
+	}
+
+	JSONValueView LazyValue::getView() const
+	{
+		if (mState == nullptr)
+			return {};
+		std::scoped_lock lock(mState->mMutex);
+		auto it = mState->mValues.find(mIndex);
+		if (it == mState->mValues.end())
+		{
+			JSONResult<JSONValue> value = mState->mTape.toValue(mIndex);
+			if (!value)
+				return {};
+			it = mState->mValues.emplace(mIndex, std::move(*value)).first;
+		}
+		return JSONValueView(it->second);
+	}
+
+	std::string_view LazyValue::getRaw() const noexcept
+	{
+		return mState == nullptr ? std::string_view() : mState->mTape.getRaw(mIndex);
+	}
+
+	//
+	// LazyDocument implementation
+	//
+
+	LazyDocument::~LazyDocument() = default;
+	LazyDocument::LazyDocument(LazyDocument&&) noexcept = default;
+	LazyDocument& LazyDocument::operator=(LazyDocument&&) noexcept = default;
+
+	JSONResult<LazyDocument> LazyDocument::create(std::string pText)
+	{
+		LazyDocument document;
+		document.mState = std::make_unique<LazyValue::State>();
+		document.mState->mText = std::move(pText);
+		if (JSONStatus status = document.mState->mTape.build(document.mState->mText); !status)
+			return std::unexpected(status.error());
+		return document;
+	}
+
+	LazyValue LazyDocument::getRoot() const noexcept
+	{
+		if (mState == nullptr || mState->mTape.size() == 0)
+			return {};
+		return LazyValue(mState.get(), 0);
+	}
+
+	LazyValue LazyDocument::operator[](std::string_view pKey) const
+	{
+		return getRoot()[pKey];
+	}
+
+	const JSONTape& LazyDocument::getTape() const noexcept
+	{
+		return mState->mTape;
+	}
+
+	size_t LazyDocument::getDecodedCount() const
+	{
+		if (mState == nullptr)
+			return 0;
+		std::scoped_lock lock(mState->mMutex);
+		return mState->mValues.size();
+	}
+}
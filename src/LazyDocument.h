@@ -0,0 +1,164 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "JSONParser.h"
+#include "JSONTape.h"
+#include "JSONView.h"
+
+namespace tng
+{
+	class LazyDocument;
+
+	//
+	// handle to a value of a LazyDocument; cheap to copy, valid while the document lives;
+	// a handle of a missing value is empty and lookups on it return empty handles,
+	// thus they can be chained like JSONValueView: document["a"]["b"][3].getOr<int32_t>(0);
+	//
+	class LazyValue
+	{
+	public:
+		LazyValue() = default;
+
+		bool exists() const noexcept;
+		explicit operator bool() const noexcept;
+
+		bool isObject() const noexcept;
+		bool isArray() const noexcept;
+
+		//
+		// lookup by key (objects) and by index (arrays);
+		// the first lookup in a container decodes its keys (not its values) and remembers them;
+		// among duplicate keys the last one is found, as in JSONObject;
+		// any integer is an index (a literal 0 included, it doesnt pick the const char* overload);
+		//
+		LazyValue operator[](std::string_view pKey) const;
+		LazyValue operator[](const char* pKey) const;
+		template<std::integral T>
+		LazyValue operator[](T pIndex) const;
+
+		bool contains(std::string_view pKey) const;
+
+		//
+		// number of members or elements, 0 for scalars;
+		//
+		size_t size() const;
+
+		//
+		// decodes the value (for containers - the whole subtree) on the first call and keeps it;
+		// returns an empty view if the handle is empty or the value cant be converted
+		// (a number out of range, for example);
+		//
+		JSONValueView getView() const;
+
+		//
+		// returns the contained value or pDefault, see JSONValueView::getOr();
+		//
+		template<typename T>
+			requires ProperValue<T>
+		T getOr(T pDefault) const;
+
+		//
+		// returns the text of the value without decoding it;
+		//
+		std::string_view getRaw() const noexcept;
+
+	private:
+		friend class LazyDocument;
+
+		struct State;
+		LazyValue(State* pState, uint32_t pIndex) noexcept;
+
+		LazyValue getElement(size_t pIndex) const;
+
+	private:
+		State* mState{};
+		uint32_t mIndex{};
+	};
+
+	//
+	// document which is parsed only into a structural index (JSONTape);
+	// keys and values are decoded when they are touched for the first time and kept,
+	// untouched strings, numbers and subtrees are never decoded or allocated;
+	// this is for consumers which read a few fields of a document with hundreds of them;
+	// lookups are thread-safe, the caches are guarded by a mutex;
+	//
+	class LazyDocument
+	{
+	public:
+		LazyDocument() = default;
+		~LazyDocument();
+		LazyDocument(LazyDocument&&) noexcept;
+		LazyDocument& operator=(LazyDocument&&) noexcept;
+
+		//
+		// scans the text (the whole text is validated structurally, scalars are checked on access);
+		//
+		static JSONResult<LazyDocument> create(std::string pText);
+
+		LazyValue getRoot() const noexcept;
+		LazyValue operator[](std::string_view pKey) const;
+		LazyValue operator[](const char* pKey) const;
+
+		const JSONTape& getTape() const noexcept;
+
+		//
+		// returns the number of values decoded so far;
+		//
+		size_t getDecodedCount() const;
+
+	private:
+		std::unique_ptr<LazyValue::State> mState;
+	};
+
+	//
+	// LazyValue implementation
+	//
+
+	inline LazyValue::LazyValue(State* pState, uint32_t pIndex) noexcept
+		: mState(pState)
+		, mIndex(pIndex)
+	{
+	}
+
+	inline bool LazyValue::exists() const noexcept
+	{
+		return mState != nullptr;
+	}
+
+	inline LazyValue::operator bool() const noexcept
+	{
+		return exists();
+	}
+
+	inline LazyValue LazyValue::operator[](const char* pKey) const
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+
+	template<std::integral T>
+	inline LazyValue LazyValue::operator[](T pIndex) const
+	{
+		// a negative index becomes huge and is out of range;
+		return getElement(static_cast<size_t>(pIndex));
+	}
+
+	template<typename T>
+		requires ProperValue<T>
+	inline T LazyValue::getOr(T pDefault) const
+	{
+		return getView().getOr<T>(pDefault);
+	}
+
+	//
+	// LazyDocument implementation
+	//
+
+	inline LazyValue LazyDocument::operator[](const char* pKey) const
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+}
@@ -0,0 +1,309 @@
+#include "NDJSONReader.h"
+#include "SIMDScan.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace tng
+{
+	namespace
+	{
+		//
+		// one chunk of the input: whole records only, parsed results and their lines;
+		// chunks are recycled, thus their buffers keep capacity between uses;
+		//
+		struct Chunk
+		{
+			uint64_t mSequence{};
+			std::string mData;
+			std::vector<uint32_t> mLineEnds;
+			std::vector<std::pair<uint32_t, uint32_t>> mSpans;
+			std::vector<uint64_t> mLineNumbers;
+			std::vector<JSONResult<JSONObject>> mRecords;
+			std::atomic<size_t> mRemainingTasks{};
+		};
+
+		//
+		// state shared by the reader thread, parse tasks and the consumer;
+		//
+		struct Pipeline
+		{
+			std::mutex mMutex;
+			std::condition_variable mCondition;
+			std::vector<std::shared_ptr<Chunk>> mFreeChunks;
+			std::deque<std::shared_ptr<Chunk>> mParsedChunks;
+			size_t mChunksInFlight{};
+			uint64_t mChunksProduced{};
+			bool mReaderDone{ false };
+			bool mReadFailed{ false };
+			bool mStop{ false };
+		};
+
+		//
+		// waits for a free slot (backpressure) and returns a recycled or a new chunk;
+		// returns nullptr if the pipeline is stopped;
+		//
+		std::shared_ptr<Chunk> acquireChunk(Pipeline& pPipeline, size_t pMaxChunksInFlight)
+		{
+			std::unique_lock lock(pPipeline.mMutex);
+			pPipeline.mCondition.wait(lock, [&]()
+				{
+					return pPipeline.mStop || pPipeline.mChunksInFlight < pMaxChunksInFlight;
+				});
+			if (pPipeline.mStop)
+				return nullptr;
+			pPipeline.mChunksInFlight++;
+			if (pPipeline.mFreeChunks.empty())
+				return std::make_shared<Chunk>();
+			std::shared_ptr<Chunk> chunk = std::move(pPipeline.mFreeChunks.back());
+			pPipeline.mFreeChunks.pop_back();
+			return chunk;
+		}
+
+		void publishChunk(Pipeline& pPipeline, std::shared_ptr<Chunk> pChunk)
+		{
+			{
+				std::lock_guard lock(pPipeline.mMutex);
+				pPipeline.mParsedChunks.push_back(std::move(pChunk));
+			}
+			pPipeline.mCondition.notify_all();
+		}
+
+		void recycleChunk(Pipeline& pPipeline, std::shared_ptr<Chunk> pChunk)
+		{
+			{
+				std::lock_guard lock(pPipeline.mMutex);
+				pPipeline.mFreeChunks.push_back(std::move(pChunk));
+				pPipeline.mChunksInFlight--;
+			}
+			pPipeline.mCondition.notify_all();
+		}
+
+		//
+		// splits the chunk into non-empty records and remembers their lines;
+		//
+		void splitRecords(Chunk& pChunk, uint64_t pFirstLine)
+		{
+			pChunk.mLineEnds.clear();
+			pChunk.mSpans.clear();
+			pChunk.mLineNumbers.clear();
+			NDJSONReader::findLineEnds(pChunk.mData, pChunk.mLineEnds);
+			if (!pChunk.mData.empty() && pChunk.mData.back() != '\n')
+				pChunk.mLineEnds.push_back(static_cast<uint32_t>(pChunk.mData.size()));
+
+			uint32_t begin{};
+			for (size_t i = 0; i < pChunk.mLineEnds.size(); ++i)
+			{
+				uint32_t end = pChunk.mLineEnds[i];
+				uint32_t recordEnd = end > begin && pChunk.mData[end - 1] == '\r' ? end - 1 : end;
+				std::string_view record(pChunk.mData.data() + begin, recordEnd - begin);
+				if (record.find_first_not_of(" \t") != std::string_view::npos)
+				{
+					pChunk.mSpans.emplace_back(begin, recordEnd);
+					pChunk.mLineNumbers.push_back(pFirstLine + i);
+				}
+				begin = end + 1;
+			}
+			pChunk.mRecords.resize(pChunk.mSpans.size());
+		}
+
+		//
+		// stage 1: reads chunks which end on a record boundary and hands them to parse tasks;
+		//
+		void readerStage(std::istream& pStream, const NDJSONOptions& pOptions, ThreadPool& pPool,
+						 const std::shared_ptr<Pipeline>& pPipeline)
+		{
+			std::string carry;
+			uint64_t sequence{};
+			uint64_t line = 1;
+			bool endOfInput = false;
+			while (!endOfInput)
+			{
+				std::shared_ptr<Chunk> chunk = acquireChunk(*pPipeline, pOptions.mMaxChunksInFlight);
+				if (chunk == nullptr)
+					break;
+
+				chunk->mData.swap(carry);
+				carry.clear();
+				// a record longer than a chunk makes the chunk grow until its newline;
+				size_t lastNewline = std::string::npos;
+				while (lastNewline == std::string::npos && !endOfInput)
+				{
+					size_t searchFrom = chunk->mData.size();
+					chunk->mData.resize(searchFrom + pOptions.mChunkSize);
+					pStream.read(chunk->mData.data() + searchFrom, static_cast<std::streamsize>(pOptions.mChunkSize));
+					chunk->mData.resize(searchFrom + static_cast<size_t>(pStream.gcount()));
+					endOfInput = !pStream;
+					// the bytes before searchFrom (the carry and earlier reads) have no newline,
+					// thus only the new block is scanned and a long record stays linear;
+					size_t found = std::string_view(chunk->mData).substr(searchFrom).find_last_of('\n');
+					if (found != std::string_view::npos)
+						lastNewline = searchFrom + found;
+				}
+				if (pStream.bad())
+				{
+					std::lock_guard lock(pPipeline->mMutex);
+					pPipeline->mReadFailed = true;
+				}
+				if (!endOfInput)
+				{
+					carry.assign(chunk->mData, lastNewline + 1);
+					chunk->mData.resize(lastNewline + 1);
+				}
+
+				chunk->mSequence = sequence++;
+				splitRecords(*chunk, line);
+				line += chunk->mLineEnds.size();
+
+				size_t records = chunk->mSpans.size();
+				size_t tasks = (records + pOptions.mRecordsPerTask - 1) / pOptions.mRecordsPerTask;
+				{
+					std::lock_guard lock(pPipeline->mMutex);
+					pPipeline->mChunksProduced = sequence;
+				}
+				if (tasks == 0)
+				{
+					publishChunk(*pPipeline, std::move(chunk));
+					continue;
+				}
+
+				chunk->mRemainingTasks.store(tasks, std::memory_order_relaxed);
+				for (size_t task = 0; task < tasks; ++task)
+				{
+					size_t begin = task * pOptions.mRecordsPerTask;
+					size_t end = std::min(records, begin + pOptions.mRecordsPerTask);
+					// stage 2: parser workers;
+					pPool.submit([chunk, pPipeline, begin, end, parseOptions = pOptions.mParseOptions]()
+						{
+							for (size_t i = begin; i < end; ++i)
+							{
+								auto [recordBegin, recordEnd] = chunk->mSpans[i];
+								std::string_view record(chunk->mData.data() + recordBegin, recordEnd - recordBegin);
+								try
+								{
+									chunk->mRecords[i] = tng::parse(record, parseOptions);
+								}
+								catch (const std::exception&)
+								{
+									chunk->mRecords[i] = std::unexpected(JSONError{ JSONErrorCode::INVALID_TEXT });
+								}
+							}
+							if (chunk->mRemainingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+								publishChunk(*pPipeline, chunk);
+						});
+				}
+			}
+
+			{
+				std::lock_guard lock(pPipeline->mMutex);
+				pPipeline->mReaderDone = true;
+			}
+			pPipeline->mCondition.notify_all();
+		}
+	}
+
+	NDJSONReader::NDJSONReader(const NDJSONOptions& pOptions)
+		: mOptions(pOptions)
+	{
+		mOptions.mChunkSize = std::max<size_t>(mOptions.mChunkSize, 1);
+		mOptions.mMaxChunksInFlight = std::max<size_t>(mOptions.mMaxChunksInFlight, 1);
+		mOptions.mRecordsPerTask = std::max<size_t>(mOptions.mRecordsPerTask, 1);
+	}
+
+	JSONStatus NDJSONReader::read(std::istream& pStream, const Callback& pCallback)
+	{
+		ThreadPool& pool = mOptions.mPool != nullptr ? *mOptions.mPool : ThreadPool::getDefault();
+		auto pipeline = std::make_shared<Pipeline>();
+		std::thread reader(readerStage, std::ref(pStream), std::cref(mOptions), std::ref(pool), std::cref(pipeline));
+
+		auto stopReader = [&]()
+			{
+				{
+					std::lock_guard lock(pipeline->mMutex);
+					pipeline->mStop = true;
+				}
+				pipeline->mCondition.notify_all();
+				reader.join();
+			};
+
+		// stage 3: the consumer;
+		std::map<uint64_t, std::shared_ptr<Chunk>> waiting;
+		std::deque<std::shared_ptr<Chunk>> parsed;
+		uint64_t nextSequence{};
+		uint64_t consumed{};
+		try
+		{
+			while (true)
+			{
+				{
+					std::unique_lock lock(pipeline->mMutex);
+					pipeline->mCondition.wait(lock, [&]()
+						{
+							return !pipeline->mParsedChunks.empty() ||
+								   (pipeline->mReaderDone && consumed == pipeline->mChunksProduced);
+						});
+					if (pipeline->mParsedChunks.empty())
+						break;
+					parsed.swap(pipeline->mParsedChunks);
+				}
+
+				for (auto& chunk : parsed)
+				{
+					if (mOptions.mOrdered)
+						waiting.emplace(chunk->mSequence, std::move(chunk));
+					else
+					{
+						for (size_t i = 0; i < chunk->mRecords.size(); ++i)
+							pCallback(chunk->mLineNumbers[i], std::move(chunk->mRecords[i]));
+						consumed++;
+						recycleChunk(*pipeline, std::move(chunk));
+					}
+				}
+				parsed.clear();
+
+				while (!waiting.empty() && waiting.begin()->first == nextSequence)
+				{
+					std::shared_ptr<Chunk> chunk = std::move(waiting.begin()->second);
+					waiting.erase(waiting.begin());
+					for (size_t i = 0; i < chunk->mRecords.size(); ++i)
+						pCallback(chunk->mLineNumbers[i], std::move(chunk->mRecords[i]));
+					nextSequence++;
+					consumed++;
+					recycleChunk(*pipeline, std::move(chunk));
+				}
+			}
+		}
+		catch (...)
+		{
+			// parse tasks in flight own the pipeline, thus only the reader has to be stopped;
+			stopReader();
+			throw;
+		}
+		reader.join();
+
+		if (pipeline->mReadFailed)
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		return {};
+	}
+
+	JSONStatus NDJSONReader::readFile(const std::filesystem::path& pPath, const Callback& pCallback)
+	{
+		std::ifstream stream(pPath, std::ios::binary);
+		if (!stream.is_open())
+			return std::unexpected(JSONError{ JSONErrorCode::FILE_ERROR });
+		return read(stream, pCallback);
+	}
+
+	void NDJSONReader::findLineEnds(std::string_view pText, std::vector<uint32_t>& pPositions)
+	{
+		simd::forEachChar(pText, '\n', [&](size_t pPosition)
+			{
+				pPositions.push_back(static_cast<uint32_t>(pPosition));
+			});
+	}
+}
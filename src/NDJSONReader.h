@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONParser.h"
+
+namespace tng
+{
+	//
+	// options of NDJSONReader;
+	//
+	struct NDJSONOptions
+	{
+		//
+		// size of one chunk, which the reader thread reads at once (a record is never split);
+		//
+		size_t mChunkSize{ 1024 * 1024 };
+
+		//
+		// maximum number of chunks, which are read but not consumed yet;
+		// the reader thread waits when this limit is reached (backpressure),
+		// thus memory is bounded by about mChunkSize * mMaxChunksInFlight;
+		//
+		size_t mMaxChunksInFlight{ 16 };
+
+		//
+		// number of records, which one parse task takes;
+		//
+		size_t mRecordsPerTask{ 256 };
+
+		//
+		// true  - the callback gets records in the order of the input;
+		// false - the callback gets records as soon as their chunk is parsed;
+		//
+		bool mOrdered{ true };
+
+		//
+		// pool of parser workers; nullptr means ThreadPool::getDefault();
+		//
+		ThreadPool* mPool{ nullptr };
+
+		ParseOptions mParseOptions{};
+	};
+
+	//
+	// reader of NDJSON / JSON Lines (one object per line) working as a pipeline:
+	// reader thread  - reads chunks and splits them into records on newlines (SIMD);
+	// parser workers - parse records of a chunk in parallel on the thread pool;
+	// consumer	      - the calling thread, which invokes the callback (ordered or unordered);
+	// empty lines are skipped, a trailing '\r' is removed;
+	//
+	class NDJSONReader
+	{
+	public:
+		//
+		// pLineNumber - 1-based line of the record in the input;
+		//
+		using Callback = std::function<void(uint64_t pLineNumber, JSONResult<JSONObject>&& pRecord)>;
+	public:
+		explicit NDJSONReader(const NDJSONOptions& pOptions = {});
+
+		//
+		// reads the whole stream and invokes pCallback for every record;
+		// returns an error only if the input couldnt be read, errors of single records
+		// are passed to the callback;
+		//
+		JSONStatus read(std::istream& pStream, const Callback& pCallback);
+
+		//
+		// the same, but opens the file itself;
+		//
+		JSONStatus readFile(const std::filesystem::path& pPath, const Callback& pCallback);
+
+		//
+		// appends positions of every '\n' in pText into pPositions;
+		//
+		static void findLineEnds(std::string_view pText, std::vector<uint32_t>& pPositions);
+
+	private:
+		NDJSONOptions mOptions;
+	};
+}
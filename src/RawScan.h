@@ -0,0 +1,86 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+#include "JSONTape.h"
+#include "SIMDScan.h"
+
+//
+// helpers for walking raw text without building tokens (pointer lookups, projections, allow-lists);
+// the text is the dialect of JSONLexer: keys and values may be unquoted, commas are optional;
+//
+namespace tng::raw
+{
+	inline constexpr bool isSpace(char pChar) noexcept
+	{
+		return pChar == ' ' || pChar == '\t' || pChar == '\r' || pChar == '\n';
+	}
+
+	//
+	// characters which end a bare word;
+	//
+	inline constexpr bool isDelimiter(char pChar) noexcept
+	{
+		return isSpace(pChar) || pChar == ',' || pChar == ':' || pChar == '{' || pChar == '}' ||
+			   pChar == '[' || pChar == ']' || pChar == '"';
+	}
+
+	inline constexpr size_t skipSpaces(std::string_view pText, size_t pPosition) noexcept
+	{
+		while (pPosition < pText.size() && isSpace(pText[pPosition]))
+			++pPosition;
+		return pPosition;
+	}
+
+	//
+	// skips spaces and commas between members;
+	//
+	inline constexpr size_t skipSeparators(std::string_view pText, size_t pPosition) noexcept
+	{
+		while (pPosition < pText.size() && (isSpace(pText[pPosition]) || pText[pPosition] == ','))
+			++pPosition;
+		return pPosition;
+	}
+
+	//
+	// returns the end of the scalar or container which starts at pPosition,
+	// or std::string_view::npos if there is no value; containers are not validated;
+	//
+	inline size_t skipValue(std::string_view pText, size_t pPosition) noexcept
+	{
+		if (pPosition >= pText.size())
+			return std::string_view::npos;
+		char c = pText[pPosition];
+		if (c == '"')
+			return simd::skipString(pText, pPosition);
+		if (c == '{' || c == '[')
+			return simd::skipContainer(pText, pPosition);
+		size_t end = pPosition;
+		while (end < pText.size() && !isDelimiter(pText[end]))
+			++end;
+		return end == pPosition ? std::string_view::npos : end;
+	}
+
+	//
+	// returns the key without quotes; escaped keys are decoded into pStorage;
+	//
+	inline std::string_view getKey(std::string_view pRawKey, std::string& pStorage)
+	{
+		if (pRawKey.size() < 2 || pRawKey.front() != '"')
+			return pRawKey;
+		std::string_view inner = pRawKey.substr(1, pRawKey.size() - 2);
+		if (inner.find('\\') == std::string_view::npos)
+			return inner;
+		pStorage = JSONTape::decodeString(pRawKey).value_or(std::string());
+		return pStorage;
+	}
+
+	//
+	// compares a key of the text (quoted or bare) with a decoded key;
+	//
+	inline bool keyEquals(std::string_view pRawKey, std::string_view pKey)
+	{
+		std::string storage;
+		return getKey(pRawKey, storage) == pKey;
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define TNG_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	#include <emmintrin.h>
+	#define TNG_SIMD_SSE2 1
+#endif
+
+namespace tng::simd
+{
+	//
+	// number of bytes which are compared at once by the vector paths;
+	//
+#if defined(TNG_SIMD_AVX2)
+	inline constexpr size_t BLOCK_SIZE = 32;
+#else
+	inline constexpr size_t BLOCK_SIZE = 16;
+#endif
+
+	//
+	// returns a bitmask of positions in the block [pData, pData + BLOCK_SIZE),
+	// where the byte is equal to pChar;
+	//
+	inline uint32_t matchBlock(const char* pData, char pChar) noexcept
+	{
+#if defined(TNG_SIMD_AVX2)
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData));
+		return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(pChar))));
+#elif defined(TNG_SIMD_SSE2)
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(pChar))));
+#else
+		uint32_t mask{};
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+		{
+			if (pData[i] == pChar)
+				mask |= 1u << i;
+		}
+		return mask;
+#endif
+	}
+
+	//
+	// returns a bitmask of positions in the block [pData, pData + BLOCK_SIZE),
+	// where the byte must be escaped inside a JSON string: '"', '\\' and control characters;
+	//
+	inline uint32_t matchEscapeBlock(const char* pData) noexcept
+	{
+#if defined(TNG_SIMD_AVX2)
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData));
+		__m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(block, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F));
+		__m256i quote = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'));
+		__m256i slash = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'));
+		return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(control, _mm256_or_si256(quote, slash))));
+#elif defined(TNG_SIMD_SSE2)
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
+		__m128i control = _mm_cmpeq_epi8(_mm_max_epu8(block, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+		__m128i quote = _mm_cmpeq_epi8(block, _mm_set1_epi8('"'));
+		__m128i slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'));
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(control, _mm_or_si128(quote, slash))));
+#else
+		uint32_t mask{};
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+		{
+			unsigned char c = static_cast<unsigned char>(pData[i]);
+			if (c < 0x20 || c == '"' || c == '\\')
+				mask |= 1u << i;
+		}
+		return mask;
+#endif
+	}
+
+	//
+	// returns position of the first byte at or after pFrom, which must be escaped
+	// inside a JSON string, or pText.size() if there is none;
+	//
+	inline size_t findEscape(std::string_view pText, size_t pFrom) noexcept
+	{
+		const char* data = pText.data();
+		size_t i = pFrom;
+		for (; i + BLOCK_SIZE <= pText.size(); i += BLOCK_SIZE)
+		{
+			uint32_t mask = matchEscapeBlock(data + i);
+			if (mask != 0)
+				return i + static_cast<size_t>(std::countr_zero(mask));
+		}
+		for (; i < pText.size(); ++i)
+		{
+			unsigned char c = static_cast<unsigned char>(data[i]);
+			if (c < 0x20 || c == '"' || c == '\\')
+				return i;
+		}
+		return pText.size();
+	}
+
+	//
+	// returns position of the first '"' or '\\' at or after pFrom, or pText.size() if there is none;
+	// used to find the end of a quoted string;
+	//
+	inline size_t findQuoteOrBackslash(std::string_view pText, size_t pFrom) noexcept
+	{
+		const char* data = pText.data();
+		size_t i = pFrom;
+		for (; i + BLOCK_SIZE <= pText.size(); i += BLOCK_SIZE)
+		{
+			uint32_t mask = matchBlock(data + i, '"') | matchBlock(data + i, '\\');
+			if (mask != 0)
+				return i + static_cast<size_t>(std::countr_zero(mask));
+		}
+		for (; i < pText.size(); ++i)
+		{
+			if (data[i] == '"' || data[i] == '\\')
+				return i;
+		}
+		return pText.size();
+	}
+
+	//
+	// returns position of the first bracket ('{', '}', '[', ']') or '"' at or after pFrom,
+	// or pText.size() if there is none;
+	//
+	inline size_t findBracketOrQuote(std::string_view pText, size_t pFrom) noexcept
+	{
+		const char* data = pText.data();
+		size_t i = pFrom;
+		for (; i + BLOCK_SIZE <= pText.size(); i += BLOCK_SIZE)
+		{
+			uint32_t mask = matchBlock(data + i, '"') | matchBlock(data + i, '{') | matchBlock(data + i, '}') |
+							matchBlock(data + i, '[') | matchBlock(data + i, ']');
+			if (mask != 0)
+				return i + static_cast<size_t>(std::countr_zero(mask));
+		}
+		for (; i < pText.size(); ++i)
+		{
+			char c = data[i];
+			if (c == '"' || c == '{' || c == '}' || c == '[' || c == ']')
+				return i;
+		}
+		return pText.size();
+	}
+
+	//
+	// returns position after the closing quote of the string which opens at pQuote,
+	// or std::string_view::npos if it isnt closed;
+	//
+	inline size_t skipString(std::string_view pText, size_t pQuote) noexcept
+	{
+		size_t i = pQuote + 1;
+		while (true)
+		{
+			i = findQuoteOrBackslash(pText, i);
+			if (i >= pText.size())
+				return std::string_view::npos;
+			if (pText[i] == '"')
+				return i + 1;
+			i += 2;
+		}
+	}
+
+	//
+	// returns position after the bracket which closes the container opening at pOpen,
+	// or std::string_view::npos if it isnt closed; only brackets and strings are looked at,
+	// the content is not validated (it is the fast way to step over a subtree);
+	//
+	inline size_t skipContainer(std::string_view pText, size_t pOpen) noexcept
+	{
+		size_t depth{};
+		size_t i = pOpen;
+		while (true)
+		{
+			i = findBracketOrQuote(pText, i);
+			if (i >= pText.size())
+				return std::string_view::npos;
+			char c = pText[i];
+			if (c == '"')
+			{
+				i = skipString(pText, i);
+				if (i == std::string_view::npos)
+					return i;
+				continue;
+			}
+			if (c == '{' || c == '[')
+				++depth;
+			else if (--depth == 0)
+				return i + 1;
+			++i;
+		}
+	}
+
+	//
+	// calls pFunction(position) for every occurrence of pChar in pText, in order;
+	//
+	template<typename Function>
+	inline void forEachChar(std::string_view pText, char pChar, Function&& pFunction)
+	{
+		const char* data = pText.data();
+		size_t i = 0;
+		for (; i + BLOCK_SIZE <= pText.size(); i += BLOCK_SIZE)
+		{
+			uint32_t mask = matchBlock(data + i, pChar);
+			while (mask != 0)
+			{
+				pFunction(i + static_cast<size_t>(std::countr_zero(mask)));
+				mask &= mask - 1;
+			}
+		}
+		for (; i < pText.size(); ++i)
+		{
+			if (data[i] == pChar)
+				pFunction(i);
+		}
+	}
+}
@@ -0,0 +1,895 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "JSONParser.h"
+#include "RawScan.h"
+
+namespace tng
+{
+	//
+	// a string literal as a template argument: static_json<"{port: 8080}">;
+	//
+	template<size_t N>
+	struct FixedString
+	{
+		char mData[N]{};
+
+		consteval FixedString(const char (&pText)[N]) noexcept
+		{
+			for (size_t i = 0; i < N; ++i)
+				mData[i] = pText[i];
+		}
+
+		constexpr std::string_view view() const noexcept
+		{
+			return std::string_view(mData, N - 1);
+		}
+	};
+
+	//
+	// types of values of a static document; numbers keep the types of the runtime parser:
+	// numbers with '.', 'e' or 'E' are float, negative ones are int32_t, the others are uint32_t;
+	//
+	enum class StaticType : uint8_t
+	{
+		NULLTYPE,
+		BOOL,
+		UINT,
+		INT,
+		FLOAT,
+		STRING,
+		ARRAY,
+		OBJECT
+	};
+
+	//
+	// one value of a static document; values are laid out in document order
+	// and a container is followed by its elements up to mEnd;
+	// keys and strings are slices of the character storage of the document;
+	//
+	struct StaticNode
+	{
+		StaticType mType{ StaticType::NULLTYPE };
+		bool mBool{};
+		int64_t mInteger{};
+		float mFloat{};
+		uint32_t mKey{};
+		uint32_t mKeySize{};
+		uint32_t mString{};
+		uint32_t mStringSize{};
+		// number of elements of a container;
+		uint32_t mSize{};
+		// index after the last element of a container;
+		uint32_t mEnd{};
+	};
+
+	//
+	// read-only handle to a value of a static document; every accessor is constexpr,
+	// thus lookups into a literal are folded by the compiler:
+	// constexpr uint32_t port = *static_json<"{port: 8080}">["port"].getUint();
+	// a handle to a missing value is empty, lookups can be chained like with JSONValueView;
+	//
+	class StaticValue
+	{
+	public:
+		class iterator;
+	public:
+		constexpr StaticValue() = default;
+		constexpr StaticValue(const StaticNode* pNodes, const char* pChars, uint32_t pIndex) noexcept;
+
+		constexpr bool exists() const noexcept;
+		constexpr explicit operator bool() const noexcept;
+		constexpr std::optional<StaticType> getType() const noexcept;
+
+		//
+		// checkers if the value is an exact type; all of them return false on an empty handle;
+		// ----------------------------------
+		constexpr bool isBool() const noexcept;
+		constexpr bool isInt() const noexcept;
+		constexpr bool isUint() const noexcept;
+		constexpr bool isFloat() const noexcept;
+		constexpr bool isNumber() const noexcept;
+		constexpr bool isString() const noexcept;
+		constexpr bool isNull() const noexcept;
+		constexpr bool isArray() const noexcept;
+		constexpr bool isObject() const noexcept;
+		// ----------------------------------
+
+		//
+		// typed accessors with the rules of JSONValueView:
+		// getInt() accepts both signed and unsigned numbers, getFloat() accepts any number;
+		// ----------------------------------
+		constexpr std::optional<bool> getBool() const noexcept;
+		constexpr std::optional<int64_t> getInt() const noexcept;
+		constexpr std::optional<uint32_t> getUint() const noexcept;
+		constexpr std::optional<float> getFloat() const noexcept;
+		constexpr std::optional<std::string_view> getString() const noexcept;
+		// ----------------------------------
+
+		template<typename T>
+			requires ProperValue<T>
+		constexpr T getOr(T pDefault) const noexcept;
+
+		//
+		// the key of a member of an object, empty for other values;
+		//
+		constexpr std::string_view getKey() const noexcept;
+
+		//
+		// any integer is an index, thus [0] doesnt collide with the const char* overload;
+		//
+		constexpr StaticValue operator[](std::string_view pKey) const noexcept;
+		constexpr StaticValue operator[](const char* pKey) const noexcept;
+		template<std::integral T>
+		constexpr StaticValue operator[](T pIndex) const noexcept;
+		constexpr bool contains(std::string_view pKey) const noexcept;
+
+		//
+		// number of elements for arrays and objects, 0 otherwise;
+		//
+		constexpr size_t size() const noexcept;
+
+		//
+		// iterating over elements of an array or members of an object;
+		//
+		constexpr iterator begin() const noexcept;
+		constexpr iterator end() const noexcept;
+
+	public:
+		class iterator
+		{
+		public:
+			using value_type = StaticValue;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			constexpr iterator() = default;
+			constexpr iterator(const StaticNode* pNodes, const char* pChars, uint32_t pIndex) noexcept
+				: mNodes(pNodes), mChars(pChars), mIndex(pIndex) {}
+
+			constexpr StaticValue operator*() const noexcept
+			{
+				return StaticValue(mNodes, mChars, mIndex);
+			}
+			constexpr iterator& operator++() noexcept
+			{
+				const StaticNode& node = mNodes[mIndex];
+				mIndex = node.mType == StaticType::ARRAY || node.mType == StaticType::OBJECT ? node.mEnd : mIndex + 1;
+				return *this;
+			}
+			constexpr iterator operator++(int) noexcept
+			{
+				iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+			constexpr bool operator==(const iterator& pOther) const noexcept
+			{
+				return mIndex == pOther.mIndex;
+			}
+
+		private:
+			const StaticNode* mNodes{ nullptr };
+			const char* mChars{ nullptr };
+			uint32_t mIndex{};
+		};
+
+	private:
+		constexpr const StaticNode& node() const noexcept;
+
+	private:
+		const StaticNode* mNodes{ nullptr };
+		const char* mChars{ nullptr };
+		uint32_t mIndex{};
+	};
+
+	//
+	// a document parsed at compile time; it has no pointers of its own,
+	// so a constexpr document is emitted as read-only data and costs nothing at startup;
+	//
+	template<size_t NodeCount, size_t CharCount>
+	struct StaticDocument
+	{
+		std::array<StaticNode, NodeCount> mNodes{};
+		std::array<char, CharCount> mChars{};
+
+		constexpr StaticValue getRoot() const noexcept;
+		constexpr StaticValue operator[](std::string_view pKey) const noexcept;
+		constexpr StaticValue operator[](const char* pKey) const noexcept;
+		template<std::integral T>
+		constexpr StaticValue operator[](T pIndex) const noexcept;
+		constexpr size_t size() const noexcept;
+	};
+
+	//
+	// not constexpr on purpose: reaching it while parsing a literal stops the compilation,
+	// the message and the position are shown in the trace of the error;
+	//
+	inline void staticJSONError(const char* pMessage, size_t pPosition) noexcept
+	{
+		(void)pMessage;
+		(void)pPosition;
+	}
+
+	//
+	// the parser of literals, with the dialect of JSONLexer (bare keys and values, optional commas);
+	// it runs twice: without storage it only counts values and characters, then it fills the document;
+	//
+	class StaticParser
+	{
+	public:
+		struct Counts
+		{
+			size_t mNodes{};
+			size_t mChars{};
+		};
+
+	public:
+		constexpr StaticParser(std::string_view pText, StaticNode* pNodes, char* pChars) noexcept;
+
+		constexpr Counts parse();
+
+	private:
+		constexpr void fail(const char* pMessage) const;
+		constexpr void parseValue(uint32_t pKey, uint32_t pKeySize);
+		constexpr void parseContainer(StaticNode* pNode, uint32_t pIndex, bool pIsObject);
+		constexpr void parseString(uint32_t& pOffset, uint32_t& pSize);
+		constexpr void parseWord(StaticNode* pNode);
+		constexpr void parseNumber(std::string_view pWord, StaticNode* pNode) const;
+		constexpr void putChar(char pChar);
+		constexpr void putCodePoint(uint32_t pCodePoint);
+		constexpr uint32_t readHex(size_t pPosition) const;
+		constexpr bool hasMember(uint32_t pObject, uint32_t pKey, uint32_t pKeySize) const;
+
+	private:
+		std::string_view mText;
+		size_t mPosition{};
+		StaticNode* mNodes{ nullptr };
+		char* mChars{ nullptr };
+		uint32_t mNodeCount{};
+		uint32_t mCharCount{};
+	};
+
+	//
+	// parses a literal at compile time; errors in the literal are compile errors;
+	//
+	template<FixedString Text>
+	consteval auto makeStaticJSON()
+	{
+		constexpr StaticParser::Counts counts = StaticParser(Text.view(), nullptr, nullptr).parse();
+		StaticDocument<counts.mNodes, counts.mChars> document;
+		StaticParser(Text.view(), document.mNodes.data(), document.mChars.data()).parse();
+		return document;
+	}
+
+	//
+	// a literal parsed at compile time, one read-only instance per literal:
+	// constexpr auto& defaults = tng::static_json<"{host: localhost\n port: 8080}">;
+	// uint32_t port = defaults["port"].getOr<uint32_t>(0);
+	//
+	template<FixedString Text>
+	inline constexpr auto static_json = makeStaticJSON<Text>();
+
+	namespace literals
+	{
+		//
+		// the suffix is not _json, which is taken by nlohmann::json in the global namespace;
+		// using namespace tng::literals;
+		// constexpr auto& defaults = "{host: localhost\n port: 8080}"_static_json;
+		//
+		template<FixedString Text>
+		consteval const auto& operator""_static_json()
+		{
+			return static_json<Text>;
+		}
+	}
+
+	//
+	// StaticValue implementation
+	//
+
+	constexpr StaticValue::StaticValue(const StaticNode* pNodes, const char* pChars, uint32_t pIndex) noexcept
+		: mNodes(pNodes), mChars(pChars), mIndex(pIndex)
+	{
+	}
+
+	constexpr const StaticNode& StaticValue::node() const noexcept
+	{
+		return mNodes[mIndex];
+	}
+
+	constexpr bool StaticValue::exists() const noexcept
+	{
+		return mNodes != nullptr;
+	}
+
+	constexpr StaticValue::operator bool() const noexcept
+	{
+		return exists();
+	}
+
+	constexpr std::optional<StaticType> StaticValue::getType() const noexcept
+	{
+		if (!exists())
+			return std::nullopt;
+		return node().mType;
+	}
+
+	constexpr bool StaticValue::isBool() const noexcept
+	{
+		return getType() == StaticType::BOOL;
+	}
+
+	constexpr bool StaticValue::isInt() const noexcept
+	{
+		return getType() == StaticType::INT;
+	}
+
+	constexpr bool StaticValue::isUint() const noexcept
+	{
+		return getType() == StaticType::UINT;
+	}
+
+	constexpr bool StaticValue::isFloat() const noexcept
+	{
+		return getType() == StaticType::FLOAT;
+	}
+
+	constexpr bool StaticValue::isNumber() const noexcept
+	{
+		return isInt() || isUint() || isFloat();
+	}
+
+	constexpr bool StaticValue::isString() const noexcept
+	{
+		return getType() == StaticType::STRING;
+	}
+
+	constexpr bool StaticValue::isNull() const noexcept
+	{
+		return getType() == StaticType::NULLTYPE;
+	}
+
+	constexpr bool StaticValue::isArray() const noexcept
+	{
+		return getType() == StaticType::ARRAY;
+	}
+
+	constexpr bool StaticValue::isObject() const noexcept
+	{
+		return getType() == StaticType::OBJECT;
+	}
+
+	constexpr std::optional<bool> StaticValue::getBool() const noexcept
+	{
+		if (!isBool())
+			return std::nullopt;
+		return node().mBool;
+	}
+
+	constexpr std::optional<int64_t> StaticValue::getInt() const noexcept
+	{
+		if (!isInt() && !isUint())
+			return std::nullopt;
+		return node().mInteger;
+	}
+
+	constexpr std::optional<uint32_t> StaticValue::getUint() const noexcept
+	{
+		if (!isUint())
+			return std::nullopt;
+		return static_cast<uint32_t>(node().mInteger);
+	}
+
+	constexpr std::optional<float> StaticValue::getFloat() const noexcept
+	{
+		if (isFloat())
+			return node().mFloat;
+		if (isInt() || isUint())
+			return static_cast<float>(node().mInteger);
+		return std::nullopt;
+	}
+
+	constexpr std::optional<std::string_view> StaticValue::getString() const noexcept
+	{
+		if (!isString())
+			return std::nullopt;
+		return std::string_view(mChars + node().mString, node().mStringSize);
+	}
+
+	template<typename T>
+		requires ProperValue<T>
+	constexpr T StaticValue::getOr(T pDefault) const noexcept
+	{
+		if constexpr (isKeyword<T>)
+			return getBool().value_or(pDefault);
+		else if constexpr (isIntNumber<T>)
+		{
+			std::optional<int64_t> value = getInt();
+			if (!value || !std::in_range<T>(*value))
+				return pDefault;
+			return static_cast<T>(*value);
+		}
+		else if constexpr (isFloatNumber<T>)
+		{
+			std::optional<float> value = getFloat();
+			return value ? static_cast<T>(*value) : pDefault;
+		}
+		else if constexpr (std::is_convertible_v<std::string_view, T>)
+		{
+			std::optional<std::string_view> value = getString();
+			return value ? T(*value) : pDefault;
+		}
+		else
+			return pDefault;
+	}
+
+	constexpr std::string_view StaticValue::getKey() const noexcept
+	{
+		if (!exists())
+			return {};
+		return std::string_view(mChars + node().mKey, node().mKeySize);
+	}
+
+	constexpr StaticValue StaticValue::operator[](std::string_view pKey) const noexcept
+	{
+		if (!isObject())
+			return {};
+		for (StaticValue member : *this)
+		{
+			if (member.getKey() == pKey)
+				return member;
+		}
+		return {};
+	}
+
+	constexpr StaticValue StaticValue::operator[](const char* pKey) const noexcept
+	{
+		return (*this)[std::string_view(pKey)];
+	}
+
+	template<std::integral T>
+	constexpr StaticValue StaticValue::operator[](T pIndex) const noexcept
+	{
+		// a negative index becomes huge and is out of range;
+		size_t index = static_cast<size_t>(pIndex);
+		if (!isArray() || index >= node().mSize)
+			return {};
+		iterator it = begin();
+		for (; index != 0; --index)
+			++it;
+		return *it;
+	}
+
+	constexpr bool StaticValue::contains(std::string_view pKey) const noexcept
+	{
+		return (*this)[pKey].exists();
+	}
+
+	constexpr size_t StaticValue::size() const noexcept
+	{
+		if (!isArray() && !isObject())
+			return 0;
+		return node().mSize;
+	}
+
+	constexpr StaticValue::iterator StaticValue::begin() const noexcept
+	{
+		if (!isArray() && !isObject())
+			return end();
+		return iterator(mNodes, mChars, mIndex + 1);
+	}
+
+	constexpr StaticValue::iterator StaticValue::end() const noexcept
+	{
+		if (!isArray() && !isObject())
+			return iterator(mNodes, mChars, mIndex);
+		return iterator(mNodes, mChars, node().mEnd);
+	}
+
+	//
+	// StaticDocument implementation
+	//
+
+	template<size_t NodeCount, size_t CharCount>
+	constexpr StaticValue StaticDocument<NodeCount, CharCount>::getRoot() const noexcept
+	{
+		return StaticValue(mNodes.data(), mChars.data(), 0);
+	}
+
+	template<size_t NodeCount, size_t CharCount>
+	constexpr StaticValue StaticDocument<NodeCount, CharCount>::operator[](std::string_view pKey) const noexcept
+	{
+		return getRoot()[pKey];
+	}
+
+	template<size_t NodeCount, size_t CharCount>
+	constexpr StaticValue StaticDocument<NodeCount, CharCount>::operator[](const char* pKey) const noexcept
+	{
+		return getRoot()[pKey];
+	}
+
+	template<size_t NodeCount, size_t CharCount>
+	template<std::integral T>
+	constexpr StaticValue StaticDocument<NodeCount, CharCount>::operator[](T pIndex) const noexcept
+	{
+		return getRoot()[pIndex];
+	}
+
+	template<size_t NodeCount, size_t CharCount>
+	constexpr size_t StaticDocument<NodeCount, CharCount>::size() const noexcept
+	{
+		return getRoot().size();
+	}
+
+	//
+	// StaticParser implementation
+	//
+
+	constexpr StaticParser::StaticParser(std::string_view pText, StaticNode* pNodes, char* pChars) noexcept
+		: mText(pText), mNodes(pNodes), mChars(pChars)
+	{
+	}
+
+	constexpr StaticParser::Counts StaticParser::parse()
+	{
+		mPosition = raw::skipSpaces(mText, 0);
+		parseValue(0, 0);
+		if (raw::skipSpaces(mText, mPosition) != mText.size())
+			fail("unexpected text after the value");
+		return Counts{ mNodeCount, mCharCount };
+	}
+
+	constexpr void StaticParser::fail(const char* pMessage) const
+	{
+		// the parser runs only inside makeStaticJSON(), thus the branch is always taken;
+		if consteval
+		{
+			staticJSONError(pMessage, mPosition);
+		}
+	}
+
+	constexpr void StaticParser::parseValue(uint32_t pKey, uint32_t pKeySize)
+	{
+		if (mPosition >= mText.size())
+			fail("missing value");
+
+		uint32_t index = mNodeCount++;
+		StaticNode* node = mNodes != nullptr ? &mNodes[index] : nullptr;
+		if (node != nullptr)
+		{
+			node->mKey = pKey;
+			node->mKeySize = pKeySize;
+		}
+
+		char c = mText[mPosition];
+		if (c == '{' || c == '[')
+			parseContainer(node, index, c == '{');
+		else if (c == '"')
+		{
+			uint32_t offset{};
+			uint32_t size{};
+			parseString(offset, size);
+			if (node != nullptr)
+			{
+				node->mType = StaticType::STRING;
+				node->mString = offset;
+				node->mStringSize = size;
+			}
+		}
+		else
+			parseWord(node);
+	}
+
+	constexpr void StaticParser::parseContainer(StaticNode* pNode, uint32_t pIndex, bool pIsObject)
+	{
+		char close = pIsObject ? '}' : ']';
+		uint32_t size{};
+		mPosition = raw::skipSeparators(mText, mPosition + 1);
+		while (true)
+		{
+			if (mPosition >= mText.size())
+				fail(pIsObject ? "unterminated object" : "unterminated array");
+			if (mText[mPosition] == close)
+				break;
+
+			uint32_t key{};
+			uint32_t keySize{};
+			if (pIsObject)
+			{
+				char c = mText[mPosition];
+				if (c == '"')
+					parseString(key, keySize);
+				else
+				{
+					size_t end = mPosition;
+					while (end < mText.size() && !raw::isDelimiter(mText[end]))
+						++end;
+					if (end == mPosition)
+						fail("missing key");
+					key = mCharCount;
+					for (; mPosition < end; ++mPosition)
+						putChar(mText[mPosition]);
+					keySize = mCharCount - key;
+				}
+				if (mNodes != nullptr && hasMember(pIndex, key, keySize))
+					fail("duplicate key");
+
+				mPosition = raw::skipSpaces(mText, mPosition);
+				if (mPosition >= mText.size() || mText[mPosition] != ':')
+					fail("missing ':' after a key");
+				mPosition = raw::skipSpaces(mText, mPosition + 1);
+			}
+			else if (mText[mPosition] == ':')
+				fail("unexpected ':' in an array");
+
+			parseValue(key, keySize);
+			++size;
+			mPosition = raw::skipSeparators(mText, mPosition);
+		}
+		++mPosition;
+
+		if (pNode != nullptr)
+		{
+			pNode->mType = pIsObject ? StaticType::OBJECT : StaticType::ARRAY;
+			pNode->mSize = size;
+			pNode->mEnd = mNodeCount;
+		}
+	}
+
+	constexpr void StaticParser::parseString(uint32_t& pOffset, uint32_t& pSize)
+	{
+		pOffset = mCharCount;
+		++mPosition;
+		while (true)
+		{
+			if (mPosition >= mText.size())
+				fail("unterminated string");
+			char c = mText[mPosition];
+			if (c == '"')
+				break;
+			if (c != '\\')
+			{
+				putChar(c);
+				++mPosition;
+				continue;
+			}
+
+			if (mPosition + 1 >= mText.size())
+				fail("unterminated string");
+			char escaped = mText[mPosition + 1];
+			mPosition += 2;
+			switch (escaped)
+			{
+			case '"':  putChar('"');  break;
+			case '\\': putChar('\\'); break;
+			case '/':  putChar('/');  break;
+			case 'b':  putChar('\b'); break;
+			case 'f':  putChar('\f'); break;
+			case 'n':  putChar('\n'); break;
+			case 'r':  putChar('\r'); break;
+			case 't':  putChar('\t'); break;
+			case 'u':
+			{
+				uint32_t codePoint = readHex(mPosition);
+				mPosition += 4;
+				if (codePoint >= 0xD800 && codePoint < 0xDC00)
+				{
+					if (mPosition + 1 >= mText.size() || mText[mPosition] != '\\' || mText[mPosition + 1] != 'u')
+						fail("unpaired surrogate");
+					uint32_t low = readHex(mPosition + 2);
+					if (low < 0xDC00 || low >= 0xE000)
+						fail("unpaired surrogate");
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					mPosition += 6;
+				}
+				else if (codePoint >= 0xDC00 && codePoint < 0xE000)
+					fail("unpaired surrogate");
+				putCodePoint(codePoint);
+				break;
+			}
+			default:
+				fail("invalid escape sequence");
+			}
+		}
+		++mPosition;
+		pSize = mCharCount - pOffset;
+	}
+
+	constexpr void StaticParser::parseWord(StaticNode* pNode)
+	{
+		size_t begin = mPosition;
+		while (mPosition < mText.size() && !raw::isDelimiter(mText[mPosition]))
+			++mPosition;
+		if (mPosition == begin)
+			fail("unexpected character");
+
+		std::string_view word = mText.substr(begin, mPosition - begin);
+		char first = word.front();
+		if ((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.')
+		{
+			parseNumber(word, pNode);
+			return;
+		}
+		if (word == "true" || word == "false" || word == "null")
+		{
+			if (pNode != nullptr)
+			{
+				pNode->mType = word == "null" ? StaticType::NULLTYPE : StaticType::BOOL;
+				pNode->mBool = word == "true";
+			}
+			return;
+		}
+
+		// bare words are strings, like in the runtime parser;
+		uint32_t offset = mCharCount;
+		for (char c : word)
+			putChar(c);
+		if (pNode != nullptr)
+		{
+			pNode->mType = StaticType::STRING;
+			pNode->mString = offset;
+			pNode->mStringSize = mCharCount - offset;
+		}
+	}
+
+	constexpr void StaticParser::parseNumber(std::string_view pWord, StaticNode* pNode) const
+	{
+		if (pWord.front() == '+')
+			pWord.remove_prefix(1);
+		bool negative = !pWord.empty() && pWord.front() == '-';
+		if (negative)
+			pWord.remove_prefix(1);
+		bool isFloat = pWord.find_first_of(".eE") != std::string_view::npos;
+
+		// digits of the mantissa; the ones which don't fit into 19 digits only move the exponent;
+		uint64_t mantissa{};
+		int32_t digits{};
+		int32_t exponent{};
+		bool seenDot = false;
+		size_t i = 0;
+		for (; i < pWord.size(); ++i)
+		{
+			char c = pWord[i];
+			if (c == '.' && !seenDot)
+			{
+				seenDot = true;
+				continue;
+			}
+			if (c < '0' || c > '9')
+				break;
+			++digits;
+			if (mantissa < 1'000'000'000'000'000'000ull)
+			{
+				mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+				exponent -= seenDot ? 1 : 0;
+			}
+			else
+				exponent += seenDot ? 0 : 1;
+		}
+		if (digits == 0)
+			fail("invalid number");
+		if (i < pWord.size() && (pWord[i] == 'e' || pWord[i] == 'E'))
+		{
+			++i;
+			bool negativeExponent = i < pWord.size() && pWord[i] == '-';
+			if (i < pWord.size() && (pWord[i] == '-' || pWord[i] == '+'))
+				++i;
+			if (i == pWord.size())
+				fail("invalid number");
+			int32_t value{};
+			for (; i < pWord.size() && pWord[i] >= '0' && pWord[i] <= '9'; ++i)
+				value = value < 100000 ? value * 10 + (pWord[i] - '0') : value;
+			exponent += negativeExponent ? -value : value;
+		}
+		if (i != pWord.size())
+			fail("invalid number");
+
+		if (isFloat)
+		{
+			// powers of ten up to 1e22 are exact doubles, thus a mantissa below 2^53
+			// with such an exponent is rounded only once, like by std::from_chars;
+			double value = static_cast<double>(mantissa);
+			while (exponent != 0 && value != 0.0 && value <= std::numeric_limits<double>::max())
+			{
+				int32_t step = exponent > 0 ? std::min(exponent, 22) : std::min(-exponent, 22);
+				double power = 1.0;
+				for (int32_t k = 0; k < step; ++k)
+					power *= 10.0;
+				value = exponent > 0 ? value * power : value / power;
+				exponent += exponent > 0 ? -step : step;
+			}
+			if (value > static_cast<double>(std::numeric_limits<float>::max()))
+				fail("number is out of range");
+			if (pNode != nullptr)
+			{
+				pNode->mType = StaticType::FLOAT;
+				pNode->mFloat = static_cast<float>(negative ? -value : value);
+			}
+			return;
+		}
+
+		constexpr uint64_t uintMax = std::numeric_limits<uint32_t>::max();
+		constexpr uint64_t intMin = uint64_t{ 1 } << 31;
+		if (exponent != 0 || mantissa > (negative ? intMin : uintMax))
+			fail("number is out of range");
+		if (pNode != nullptr)
+		{
+			pNode->mType = negative ? StaticType::INT : StaticType::UINT;
+			pNode->mInteger = negative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa);
+		}
+	}
+
+	constexpr void StaticParser::putChar(char pChar)
+	{
+		if (mChars != nullptr)
+			mChars[mCharCount] = pChar;
+		++mCharCount;
+	}
+
+	constexpr void StaticParser::putCodePoint(uint32_t pCodePoint)
+	{
+		if (pCodePoint < 0x80)
+			putChar(static_cast<char>(pCodePoint));
+		else if (pCodePoint < 0x800)
+		{
+			putChar(static_cast<char>(0xC0 | (pCodePoint >> 6)));
+			putChar(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+		}
+		else if (pCodePoint < 0x10000)
+		{
+			putChar(static_cast<char>(0xE0 | (pCodePoint >> 12)));
+			putChar(static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3F)));
+			putChar(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+		}
+		else
+		{
+			putChar(static_cast<char>(0xF0 | (pCodePoint >> 18)));
+			putChar(static_cast<char>(0x80 | ((pCodePoint >> 12) & 0x3F)));
+			putChar(static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3F)));
+			putChar(static_cast<char>(0x80 | (pCodePoint & 0x3F)));
+		}
+	}
+
+	constexpr uint32_t StaticParser::readHex(size_t pPosition) const
+	{
+		if (pPosition + 4 > mText.size())
+			fail("invalid \\u escape");
+		uint32_t value{};
+		for (size_t i = pPosition; i < pPosition + 4; ++i)
+		{
+			char c = mText[i];
+			uint32_t digit{};
+			if (c >= '0' && c <= '9')
+				digit = static_cast<uint32_t>(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				digit = static_cast<uint32_t>(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				digit = static_cast<uint32_t>(c - 'A' + 10);
+			else
+				fail("invalid \\u escape");
+			value = value * 16 + digit;
+		}
+		return value;
+	}
+
+	constexpr bool StaticParser::hasMember(uint32_t pObject, uint32_t pKey, uint32_t pKeySize) const
+	{
+		std::string_view key(mChars + pKey, pKeySize);
+		for (uint32_t i = pObject + 1; i < mNodeCount;)
+		{
+			const StaticNode& member = mNodes[i];
+			if (std::string_view(mChars + member.mKey, member.mKeySize) == key)
+				return true;
+			i = member.mType == StaticType::ARRAY || member.mType == StaticType::OBJECT ? member.mEnd : i + 1;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,173 @@
+#include "ThreadPool.h"
+
+namespace tng
+{
+	namespace
+	{
+		//
+		// identifies the pool and the worker, which the current thread belongs to;
+		//
+		thread_local const ThreadPool* tCurrentPool{ nullptr };
+		thread_local uint32_t tCurrentWorker{};
+	}
+
+	ThreadPool::ThreadPool(uint32_t pThreadCount)
+	{
+		if (pThreadCount == 0)
+			pThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		mWorkers.reserve(pThreadCount);
+		for (uint32_t i = 0; i < pThreadCount; ++i)
+		{
+			mWorkers.push_back(std::make_unique<Worker>());
+		}
+		mThreads.reserve(pThreadCount);
+		for (uint32_t i = 0; i < pThreadCount; ++i)
+		{
+			mThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(mSleepMutex);
+			mStop = true;
+		}
+		mSleepCondition.notify_all();
+		for (auto& thread : mThreads)
+		{
+			if (thread.joinable())
+				thread.join();
+		}
+	}
+
+	ThreadPool& ThreadPool::getDefault()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::submit(Task pTask)
+	{
+		uint32_t index = currentWorkerIndex();
+		if (index == getThreadCount())
+			index = mNextQueue.fetch_add(1, std::memory_order_relaxed) % getThreadCount();
+		{
+			// the counter goes up before the task is visible, thus a thief which takes it
+			// at once cant decrement the counter below zero;
+			// taking the sleep mutex orders the counter with a sleeping worker's check;
+			std::lock_guard lock(mSleepMutex);
+			mPendingTasks.fetch_add(1, std::memory_order_release);
+		}
+		{
+			std::lock_guard lock(mWorkers[index]->mMutex);
+			mWorkers[index]->mTasks.push_back(std::move(pTask));
+		}
+		mSleepCondition.notify_one();
+	}
+
+	void ThreadPool::parallelFor(size_t pCount, const std::function<void(size_t, size_t)>& pFunction, size_t pChunkSize)
+	{
+		if (pCount == 0)
+			return;
+		if (pChunkSize == 0)
+		{
+			// several chunks per worker leave room for stealing when chunks are uneven;
+			size_t chunks = static_cast<size_t>(getThreadCount()) * 8;
+			pChunkSize = std::max<size_t>(1, (pCount + chunks - 1) / chunks);
+		}
+
+		size_t chunkCount = (pCount + pChunkSize - 1) / pChunkSize;
+		std::atomic<size_t> remaining{ chunkCount };
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			size_t begin = chunk * pChunkSize;
+			size_t end = std::min(pCount, begin + pChunkSize);
+			submit([&pFunction, &remaining, begin, end]()
+				{
+					pFunction(begin, end);
+					remaining.fetch_sub(1, std::memory_order_acq_rel);
+				});
+		}
+
+		// the caller helps instead of blocking, thus nested calls from workers cannot deadlock;
+		uint32_t index = currentWorkerIndex();
+		Task task;
+		while (remaining.load(std::memory_order_acquire) != 0)
+		{
+			if (tryTakeTask(index, task))
+			{
+				task();
+				task = nullptr;
+			}
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t ThreadPool::getThreadCount() const noexcept
+	{
+		return static_cast<uint32_t>(mWorkers.size());
+	}
+
+	void ThreadPool::workerLoop(uint32_t pIndex)
+	{
+		tCurrentPool = this;
+		tCurrentWorker = pIndex;
+
+		Task task;
+		while (true)
+		{
+			if (tryTakeTask(pIndex, task))
+			{
+				task();
+				task = nullptr;
+				continue;
+			}
+			std::unique_lock lock(mSleepMutex);
+			mSleepCondition.wait(lock, [this]()
+				{
+					return mStop || mPendingTasks.load(std::memory_order_acquire) != 0;
+				});
+			if (mStop && mPendingTasks.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	bool ThreadPool::tryTakeTask(uint32_t pIndex, Task& pTask)
+	{
+		uint32_t count = getThreadCount();
+		if (pIndex < count)
+		{
+			Worker& own = *mWorkers[pIndex];
+			std::lock_guard lock(own.mMutex);
+			if (!own.mTasks.empty())
+			{
+				pTask = std::move(own.mTasks.back());
+				own.mTasks.pop_back();
+				mPendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+				return true;
+			}
+		}
+
+		uint32_t start = pIndex < count ? pIndex + 1 : mNextQueue.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Worker& victim = *mWorkers[(start + i) % count];
+			std::unique_lock lock(victim.mMutex, std::try_to_lock);
+			if (!lock.owns_lock() || victim.mTasks.empty())
+				continue;
+			pTask = std::move(victim.mTasks.front());
+			victim.mTasks.pop_front();
+			mPendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+		return false;
+	}
+
+	uint32_t ThreadPool::currentWorkerIndex() const noexcept
+	{
+		return tCurrentPool == this ? tCurrentWorker : getThreadCount();
+	}
+}
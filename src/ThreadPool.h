@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tng
+{
+	//
+	// work-stealing thread pool;
+	// every worker has its own queue: it takes its own tasks from the back (LIFO, warm caches)
+	// and steals tasks of other workers from the front when its queue is empty;
+	// tasks submitted from a worker go into that worker's queue;
+	//
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+	public:
+		//
+		// pThreadCount == 0 means std::thread::hardware_concurrency();
+		//
+		explicit ThreadPool(uint32_t pThreadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		//
+		// returns a process-wide pool with one worker per hardware thread;
+		//
+		static ThreadPool& getDefault();
+
+		//
+		// enqueues a task; tasks must not throw;
+		//
+		void submit(Task pTask);
+
+		//
+		// runs pFunction(begin, end) over [0, pCount) split into chunks of pChunkSize
+		// (0 - chosen automatically) and waits for all of them;
+		// the calling thread takes part in the work, thus it is safe to call it from a worker;
+		//
+		void parallelFor(size_t pCount, const std::function<void(size_t, size_t)>& pFunction, size_t pChunkSize = 0);
+
+		//
+		// returns number of worker threads;
+		//
+		uint32_t getThreadCount() const noexcept;
+
+	private:
+		struct Worker
+		{
+			std::mutex mMutex;
+			std::deque<Task> mTasks;
+		};
+
+	private:
+		//
+		// main loop of a worker thread;
+		//
+		void workerLoop(uint32_t pIndex);
+
+		//
+		// takes a task: first from the own queue (pIndex), then steals from others;
+		// pIndex == getThreadCount() means the calling thread is not a worker;
+		//
+		bool tryTakeTask(uint32_t pIndex, Task& pTask);
+
+		//
+		// returns the index of the current worker or getThreadCount() for foreign threads;
+		//
+		uint32_t currentWorkerIndex() const noexcept;
+
+	private:
+		std::vector<std::unique_ptr<Worker>> mWorkers;
+		std::vector<std::thread> mThreads;
+		std::mutex mSleepMutex;
+		std::condition_variable mSleepCondition;
+		std::atomic<size_t> mPendingTasks{};
+		std::atomic<uint32_t> mNextQueue{};
+		bool mStop{ false };
+	};
+}